@@ -0,0 +1,68 @@
+#include "gdwg/durable_graph.hpp"
+#include "gdwg/graph.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+
+// The cost of logging each mutation: inserting random edges into a plain graph, and into a
+// durable graph that buffers its log or syncs it before every insertion returns. With several
+// threads, concurrent insertions share their syncs.
+
+namespace {
+	constexpr auto nodes = 10'000;
+
+	auto fresh_directory(std::string const& name) -> std::filesystem::path {
+		auto const directory = std::filesystem::temp_directory_path() / ("gdwg-durable-benchmark-" + name);
+		std::filesystem::remove_all(directory);
+		return directory;
+	}
+
+	template<typename Graph>
+	auto insert_nodes(Graph& g) -> void {
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+	}
+
+	auto BM_graph_insert_edge(benchmark::State& state) -> void {
+		auto g = gdwg::graph<int, int>();
+		insert_nodes(g);
+		auto rng = std::mt19937(6771);
+		auto pick = std::uniform_int_distribution<int>(0, nodes - 1);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(g.insert_edge(pick(rng), pick(rng), pick(rng)));
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	auto BM_durable_insert_edge(benchmark::State& state) -> void {
+		static auto* g = static_cast<gdwg::durable_graph<int, int>*>(nullptr);
+		if (state.thread_index() == 0) {
+			auto const options = gdwg::durable_options{.sync = state.range(0) != 0};
+			g = new gdwg::durable_graph<int, int>(fresh_directory("insert"), options);
+			insert_nodes(*g);
+			g->flush();
+		}
+		auto rng = std::mt19937(6771U + static_cast<unsigned>(state.thread_index()));
+		auto pick = std::uniform_int_distribution<int>(0, nodes - 1);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(g->insert_edge(pick(rng), pick(rng), pick(rng)));
+		}
+		state.SetItemsProcessed(state.iterations());
+		if (state.thread_index() == 0) {
+			auto const stats = g->stats();
+			state.counters["syncs"] = static_cast<double>(stats.syncs);
+			state.counters["checkpoints"] = static_cast<double>(stats.checkpoints);
+			auto const directory = g->directory();
+			delete g;
+			std::filesystem::remove_all(directory);
+		}
+	}
+} // namespace
+
+BENCHMARK(BM_graph_insert_edge);
+BENCHMARK(BM_durable_insert_edge)->ArgName("sync")->Arg(0)->Arg(1)->UseRealTime();
+BENCHMARK(BM_durable_insert_edge)->ArgName("sync")->Arg(1)->Threads(8)->UseRealTime();
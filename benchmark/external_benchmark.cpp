@@ -0,0 +1,70 @@
+#include "gdwg/external_graph.hpp"
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+#include "gdwg/traversal.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <filesystem>
+
+// BFS and PageRank streamed from an external graph's segments, against the same traversals of a
+// snapshot in memory. The files are in the page cache after the first iteration, so this
+// measures the cost of the streaming itself rather than of the disk.
+
+namespace {
+	auto const& shared_graph() {
+		static auto const g = gdwg::generate::rmat(18, 8);
+		return g;
+	}
+
+	auto const& shared_snapshot() {
+		static auto const s = gdwg::snapshot<int, int>(shared_graph());
+		return s;
+	}
+
+	auto const& shared_external() {
+		static auto const x = gdwg::external_graph<int, int>::write(
+		   shared_graph(),
+		   std::filesystem::temp_directory_path() / "gdwg-external-benchmark",
+		   {.segment_bytes = std::size_t{4} << 20U});
+		return x;
+	}
+
+	auto BM_snapshot_bfs(benchmark::State& state) -> void {
+		auto const& s = shared_snapshot();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::bfs_distances(s, 0));
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(s.num_edges()));
+	}
+
+	auto BM_external_bfs(benchmark::State& state) -> void {
+		auto const& x = shared_external();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::bfs_distances(x, 0));
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(x.num_edges()));
+	}
+
+	auto BM_snapshot_pagerank(benchmark::State& state) -> void {
+		auto const& s = shared_snapshot();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::pagerank(s, 10, 0.85, 1));
+		}
+		state.SetItemsProcessed(state.iterations() * 10 * static_cast<std::int64_t>(s.num_edges()));
+	}
+
+	auto BM_external_pagerank(benchmark::State& state) -> void {
+		auto const& x = shared_external();
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::pagerank(x, 10, 0.85));
+		}
+		state.SetItemsProcessed(state.iterations() * 10 * static_cast<std::int64_t>(x.num_edges()));
+	}
+} // namespace
+
+BENCHMARK(BM_snapshot_bfs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_external_bfs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_snapshot_pagerank)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_external_pagerank)->Unit(benchmark::kMillisecond);
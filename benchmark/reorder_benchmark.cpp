@@ -0,0 +1,86 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+#include "gdwg/traversal.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// BFS and PageRank over the same power-law graph laid out in each snapshot ordering. Node
+// values are shuffled, so the natural order is unrelated to the graph's structure.
+
+namespace {
+	auto power_law_graph(int nodes, int edges_per_node) -> gdwg::graph<int, int> {
+		auto rng = std::mt19937(6771);
+		auto labels = std::vector<int>(static_cast<std::size_t>(nodes));
+		std::iota(labels.begin(), labels.end(), 0);
+		std::shuffle(labels.begin(), labels.end(), rng);
+		auto g = gdwg::graph<int, int>(labels.begin(), labels.end());
+
+		// Preferential attachment: linking to the endpoint of a random earlier edge picks nodes
+		// in proportion to their degree
+		auto endpoints = std::vector<std::size_t>{0};
+		for (auto u = std::size_t{1}; u < labels.size(); ++u) {
+			for (auto i = 0; i < edges_per_node; ++i) {
+				auto pick = std::uniform_int_distribution<std::size_t>(0, endpoints.size() - 1);
+				auto const v = endpoints[pick(rng)];
+				g.insert_edge(labels[u], labels[v], i);
+				g.insert_edge(labels[v], labels[u], i);
+				endpoints.push_back(v);
+			}
+			endpoints.push_back(u);
+		}
+		return g;
+	}
+
+	auto const& shared_graph() {
+		static auto const g = power_law_graph(100'000, 4);
+		return g;
+	}
+
+	auto snapshot_for(benchmark::State const& state) -> gdwg::snapshot<int, int> {
+		return gdwg::snapshot(shared_graph(), static_cast<gdwg::ordering>(state.range(0)));
+	}
+
+	auto BM_bfs(benchmark::State& state) -> void {
+		auto const s = snapshot_for(state);
+		auto const source = *s.id(0);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::bfs_distances(s, source));
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(s.num_edges()));
+	}
+
+	auto BM_pagerank(benchmark::State& state) -> void {
+		auto const s = snapshot_for(state);
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::pagerank(s, 10, 0.85, 1));
+		}
+		state.SetItemsProcessed(state.iterations() * 10 * static_cast<std::int64_t>(s.num_edges()));
+	}
+
+	auto BM_build(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(snapshot_for(state));
+		}
+	}
+
+	auto orderings(benchmark::internal::Benchmark* b) -> void {
+		b->ArgName("ordering");
+		for (auto const order : {gdwg::ordering::natural,
+		                         gdwg::ordering::degree,
+		                         gdwg::ordering::rcm,
+		                         gdwg::ordering::gorder}) {
+			b->Arg(static_cast<std::int64_t>(order));
+		}
+		b->Unit(benchmark::kMillisecond);
+	}
+} // namespace
+
+BENCHMARK(BM_bfs)->Apply(orderings);
+BENCHMARK(BM_pagerank)->Apply(orderings);
+BENCHMARK(BM_build)->Apply(orderings);
@@ -0,0 +1,100 @@
+#include "gdwg/all_pairs.hpp"
+#include "gdwg/contraction_hierarchy.hpp"
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_path.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Random point-to-point queries on a 300 x 300 grid, which stands in for a road network: plain
+// Dijkstra, bidirectional Dijkstra, and a contraction hierarchy built once up front. Also
+// all-pairs shortest paths on random graphs of 1% density.
+
+namespace {
+	constexpr auto side = std::uint64_t{300};
+
+	auto const& shared_graph() {
+		static auto const g = gdwg::generate::grid2d(side, side);
+		return g;
+	}
+
+	auto const& shared_snapshot() {
+		static auto const s = gdwg::snapshot(shared_graph());
+		return s;
+	}
+
+	auto queries() -> std::vector<std::pair<std::uint32_t, std::uint32_t>> {
+		auto rng = std::mt19937(6771);
+		auto pick = std::uniform_int_distribution<std::uint32_t>(0, side * side - 1);
+		auto result = std::vector<std::pair<std::uint32_t, std::uint32_t>>(256);
+		for (auto& [src, dst] : result) {
+			src = pick(rng);
+			dst = pick(rng);
+		}
+		return result;
+	}
+
+	auto BM_dijkstra(benchmark::State& state) -> void {
+		auto const& s = shared_snapshot();
+		auto const pairs = queries();
+		auto context = gdwg::search_context<int>(s.num_nodes());
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			auto const [src, dst] = pairs[i++ % pairs.size()];
+			benchmark::DoNotOptimize(gdwg::astar(s, src, dst, [](std::uint32_t) { return 0; }, context));
+		}
+	}
+
+	auto BM_bidirectional_dijkstra(benchmark::State& state) -> void {
+		auto const& s = shared_snapshot();
+		auto const reversed = gdwg::transpose(s);
+		auto const pairs = queries();
+		auto context = gdwg::search_context<int>(s.num_nodes());
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			auto const [src, dst] = pairs[i++ % pairs.size()];
+			benchmark::DoNotOptimize(gdwg::bidirectional_dijkstra(s, reversed, src, dst, context));
+		}
+	}
+
+	auto BM_contraction_hierarchy(benchmark::State& state) -> void {
+		static auto const ch = gdwg::contraction_hierarchy(shared_graph());
+		auto const pairs = queries();
+		auto context = gdwg::search_context<int>(ch.num_nodes());
+		auto i = std::size_t{0};
+		for (auto _ : state) {
+			auto const [src, dst] = pairs[i++ % pairs.size()];
+			benchmark::DoNotOptimize(ch.distance(src, dst, context));
+		}
+	}
+
+	auto BM_contraction_hierarchy_build(benchmark::State& state) -> void {
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::contraction_hierarchy(shared_graph()));
+		}
+	}
+
+	auto BM_all_pairs_shortest_paths(benchmark::State& state) -> void {
+		auto const g = gdwg::generate::erdos_renyi(static_cast<std::uint64_t>(state.range(0)), 0.01);
+		auto const threads = static_cast<std::size_t>(state.range(1));
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(gdwg::all_pairs_shortest_paths(g, threads));
+		}
+	}
+} // namespace
+
+BENCHMARK(BM_dijkstra)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_bidirectional_dijkstra)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_contraction_hierarchy)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_contraction_hierarchy_build)->Unit(benchmark::kMillisecond)->Iterations(1);
+BENCHMARK(BM_all_pairs_shortest_paths)
+   ->Unit(benchmark::kMillisecond)
+   ->Args({256, 1})
+   ->Args({1024, 1})
+   ->Args({1024, 0});
@@ -35,12 +35,12 @@ endfunction()
 
 # Builds a test executable and creates a test target (for CTest).
 # Accepts the same parameters as `cxx_executable`
-# Depends on Catch2 being imported, and the existence of a target called test_main.
+# Depends on Catch2 and Threads being imported, and the existence of a target called test_main.
 function(cxx_test)
    cxx_executable(${ARGN})
 
    PROJECT_TEMPLATE_EXTRACT_ADD_TARGET_ARGS(${ARGN})
-   target_link_libraries("${add_target_args_TARGET}" PRIVATE Catch2::Catch2 test_main)
+   target_link_libraries("${add_target_args_TARGET}" PRIVATE Catch2::Catch2 Threads::Threads test_main)
    target_compile_options("${add_target_args_TARGET}" PRIVATE -Wno-error -Wno-self-assign-overloaded)
    add_test("test.${add_target_args_TARGET}" "${add_target_args_TARGET}")
 endfunction()
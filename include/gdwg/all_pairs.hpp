@@ -0,0 +1,254 @@
+#ifndef GDWG_ALL_PAIRS_HPP
+#define GDWG_ALL_PAIRS_HPP
+
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/detail/simd.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// All-pairs shortest paths by Floyd-Warshall, for arithmetic weights. Negative weights are
+// allowed as long as there is no negative cycle.
+//
+// The matrix is split into square tiles and processed a diagonal tile at a time: first the
+// diagonal tile itself, then the rest of its row and column of tiles, then every other tile
+// from those. The last two steps update independent tiles, which run in parallel, and every
+// update is a min-plus pass over one row of a tile (see detail/simd.hpp), so the work stays
+// within a few tiles that fit in cache instead of streaming the whole matrix for every k.
+namespace gdwg {
+	// Distances between every pair of nodes, indexed by snapshot id
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	class distance_matrix {
+	public:
+		using id_type = std::uint32_t;
+
+		distance_matrix() = default;
+
+		explicit distance_matrix(graph<N, E> const& g, std::size_t threads = 0)
+		: distance_matrix(snapshot<N, E>(g), threads) {}
+
+		// Ids are those of the snapshot
+		explicit distance_matrix(snapshot<N, E> const& s, std::size_t threads = 0)
+		: nodes_(s.nodes().begin(), s.nodes().end())
+		, stride_((s.num_nodes() + tile - 1) / tile * tile)
+		, distances_(stride_ * stride_, infinity()) {
+			// Time complexity
+			//        copy edges       - n^2 + e +
+			//        relax tiles      - n^3 / p, for p threads +
+			//        check cycles     - n^2 / 64
+			//     = O(n^3) solution
+			if (s.order() != ordering::natural) {
+				permutation_.assign(s.permutation().begin(), s.permutation().end());
+			}
+			auto const n = s.num_nodes();
+			detail::parallel_for(
+			   n,
+			   threads,
+			   [&](std::size_t u, std::size_t) {
+				   auto* const from_u = distances_.data() + u * stride_;
+				   from_u[u] = E{};
+				   auto const targets = s.neighbours(static_cast<id_type>(u));
+				   auto const weights = s.weights(static_cast<id_type>(u));
+				   // The lightest of any parallel edges
+				   for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+					   from_u[targets[k]] = std::min(from_u[targets[k]], weights[k]);
+				   }
+			   },
+			   16);
+
+			auto const tiles = stride_ / tile;
+			for (auto t = std::size_t{0}; t < tiles; ++t) {
+				relax(t, t, t);
+				detail::parallel_for(
+				   2 * tiles,
+				   threads,
+				   [&](std::size_t i, std::size_t) {
+					   auto const other = i / 2;
+					   if (other != t and i % 2 == 0) {
+						   relax(t, other, t);
+					   }
+					   else if (other != t) {
+						   relax(other, t, t);
+					   }
+				   },
+				   1);
+				detail::parallel_for(
+				   tiles * tiles,
+				   threads,
+				   [&](std::size_t i, std::size_t) {
+					   auto const i_tile = i / tiles;
+					   auto const j_tile = i % tiles;
+					   if (i_tile != t and j_tile != t) {
+						   relax(i_tile, j_tile, t);
+					   }
+				   },
+				   1);
+				// A negative cycle shows up as soon as its last node has been relaxed through,
+				// and stopping there keeps distances from falling without bound
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					if (distances_[u * stride_ + u] < E{}) {
+						throw std::runtime_error("Cannot call gdwg::all_pairs_shortest_paths on a graph "
+						                         "with a negative cycle");
+					}
+				}
+			}
+
+			if constexpr (std::is_integral_v<E>) {
+				// Unreachable entries may have drifted below infinity() through negative weights
+				detail::parallel_for(n, threads, [&](std::size_t u, std::size_t) {
+					auto* const from_u = distances_.data() + u * stride_;
+					std::replace_if(from_u, from_u + n, unreachable, infinity());
+				});
+			}
+		}
+
+		// Accessors
+
+		[[nodiscard]] auto num_nodes() const noexcept -> std::size_t {
+			return nodes_.size();
+		}
+
+		[[nodiscard]] auto node(id_type id) const -> N const& {
+			return nodes_.at(id);
+		}
+
+		[[nodiscard]] auto id(N const& value) const -> std::optional<id_type> {
+			// O(log(n)), searching the ids in N order
+			if (permutation_.empty()) {
+				auto const it = std::lower_bound(nodes_.begin(), nodes_.end(), value);
+				if (it != nodes_.end() and not(value < *it)) {
+					return static_cast<id_type>(it - nodes_.begin());
+				}
+				return std::nullopt;
+			}
+			auto const it = std::ranges::lower_bound(permutation_,
+			                                         value,
+			                                         std::less<>{},
+			                                         [&](id_type id) -> N const& { return nodes_[id]; });
+			if (it != permutation_.end() and not(value < nodes_[*it])) {
+				return *it;
+			}
+			return std::nullopt;
+		}
+
+		// Stored for pairs with no path: +infinity for floating-point weights, and half the
+		// largest E for integral weights, so that adding two entries never overflows. Integral
+		// distances must stay below a quarter of the largest E.
+		[[nodiscard]] static constexpr auto infinity() noexcept -> E {
+			if constexpr (std::numeric_limits<E>::has_infinity) {
+				return std::numeric_limits<E>::infinity();
+			}
+			else {
+				return static_cast<E>(std::numeric_limits<E>::max() / 2);
+			}
+		}
+
+		// Distance from src to dst, or infinity() if there is no path
+		[[nodiscard]] auto operator()(id_type src, id_type dst) const noexcept -> E {
+			return distances_[src * stride_ + dst];
+		}
+
+		[[nodiscard]] auto distance(N const& src, N const& dst) const -> std::optional<E> {
+			auto const src_id = id(src);
+			auto const dst_id = id(dst);
+			if (not src_id or not dst_id) {
+				throw std::runtime_error("Cannot call gdwg::distance_matrix<N, E>::distance if src or "
+				                         "dst node don't exist in the graph");
+			}
+			auto const d = (*this)(*src_id, *dst_id);
+			if (d == infinity()) {
+				return std::nullopt;
+			}
+			return d;
+		}
+
+		// Distances from src to every node, indexed by id
+		[[nodiscard]] auto row(id_type src) const noexcept -> std::span<E const> {
+			return {distances_.data() + src * stride_, nodes_.size()};
+		}
+
+	private:
+		// Three tiles of 16 KiB (4-byte weights) or 8 KiB (8-byte weights) are in use at a time,
+		// which stays within L2, while the two rows combined by each pass stay in L1
+		static constexpr auto tile = std::size_t{sizeof(E) <= 4 ? 64 : 32};
+
+		static auto unreachable(E d) noexcept -> bool {
+			if constexpr (std::numeric_limits<E>::has_infinity) {
+				return d == infinity();
+			}
+			else {
+				return d >= static_cast<E>(std::numeric_limits<E>::max() / 4);
+			}
+		}
+
+		// Floor for the sums of the min-plus passes. A negative cycle can drive distances down
+		// without bound within one round of tiles, before the diagonal is checked. With entries
+		// kept within [-infinity(), infinity()], the sum of two never overflows an integral E.
+		static constexpr auto lowest() noexcept -> E {
+			if constexpr (std::is_integral_v<E> and std::is_signed_v<E>) {
+				return static_cast<E>(-infinity());
+			}
+			else {
+				return std::numeric_limits<E>::lowest();
+			}
+		}
+
+		// Shortens the paths of tile (i_tile, j_tile) through the nodes of tile (k_tile, k_tile)
+		auto relax(std::size_t i_tile, std::size_t j_tile, std::size_t k_tile) -> void {
+			auto* const d = distances_.data();
+			auto const at = [&](std::size_t i, std::size_t j) { return d + i * tile * stride_ + j * tile; };
+			detail::simd::min_plus_tile<tile>(at(i_tile, j_tile),
+			                                  at(i_tile, k_tile),
+			                                  at(k_tile, j_tile),
+			                                  stride_,
+			                                  lowest(),
+			                                  unreachable);
+		}
+
+		std::vector<N> nodes_;
+		std::vector<id_type> permutation_; // Empty for ordering::natural
+		std::size_t stride_ = 0; // num_nodes() rounded up to a whole number of tiles
+		std::vector<E> distances_;
+	};
+
+	template<typename N, typename E>
+	distance_matrix(graph<N, E> const&) -> distance_matrix<N, E>;
+
+	template<typename N, typename E>
+	distance_matrix(graph<N, E> const&, std::size_t) -> distance_matrix<N, E>;
+
+	template<typename N, typename E>
+	distance_matrix(snapshot<N, E> const&) -> distance_matrix<N, E>;
+
+	template<typename N, typename E>
+	distance_matrix(snapshot<N, E> const&, std::size_t) -> distance_matrix<N, E>;
+
+	// Shortest distances between every pair of nodes. Parallel edges count with their smallest
+	// weight. Throws if the graph has a negative cycle.
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	[[nodiscard]] auto all_pairs_shortest_paths(graph<N, E> const& g, std::size_t threads = 0)
+	   -> distance_matrix<N, E> {
+		return distance_matrix<N, E>(g, threads);
+	}
+
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	[[nodiscard]] auto all_pairs_shortest_paths(snapshot<N, E> const& s, std::size_t threads = 0)
+	   -> distance_matrix<N, E> {
+		return distance_matrix<N, E>(s, threads);
+	}
+} // namespace gdwg
+
+#endif // GDWG_ALL_PAIRS_HPP
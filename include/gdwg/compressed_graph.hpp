@@ -0,0 +1,286 @@
+#ifndef GDWG_COMPRESSED_GRAPH_HPP
+#define GDWG_COMPRESSED_GRAPH_HPP
+
+#include "gdwg/detail/simd.hpp"
+#include "gdwg/detail/varint.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// How a compressed_graph stores edge weights
+	enum class weight_encoding {
+		automatic, // dictionary when its codes and entries are smaller than plain storage, else plain
+		plain, // one E per edge
+		dictionary, // one byte per edge indexing up to 256 distinct weights
+	};
+
+	// An immutable, compressed copy of a graph for graphs that are memory-bound.
+	//
+	// Node ids are those of the snapshot the graph is built from. Each neighbour list is sorted,
+	// so it is stored as delta-coded group varints (see detail/varint.hpp), which takes one or
+	// two bytes per edge for most lists, and more for lists whose targets are far apart; building
+	// from a snapshot with ordering::rcm or ordering::gorder keeps targets close. Lists are split
+	// into blocks of 64 edges that decode independently, and lists longer than one block start
+	// with a table of where each block begins, so has_edge() decodes a single block instead
+	// of the whole list.
+	template<typename N, typename E>
+	class compressed_graph {
+	public:
+		using id_type = std::uint32_t;
+
+		// Constructors
+
+		compressed_graph() = default;
+
+		explicit compressed_graph(graph<N, E> const& g,
+		                          weight_encoding encoding = weight_encoding::automatic)
+		: compressed_graph(snapshot<N, E>(g), encoding) {}
+
+		explicit compressed_graph(snapshot<N, E> const& s,
+		                          weight_encoding encoding = weight_encoding::automatic)
+		: nodes_(s.nodes().begin(), s.nodes().end())
+		, edge_offsets_(s.offsets().begin(), s.offsets().end()) {
+			// Time complexity
+			//        encode targets      - e +
+			//        encode weights      - e log(w), for w distinct weights
+			//     = O(n + e log(w)) solution
+			if (s.order() != ordering::natural) {
+				permutation_.assign(s.permutation().begin(), s.permutation().end());
+			}
+
+			byte_offsets_.reserve(s.num_nodes() + 1);
+			for (auto u = id_type{0}; u < s.num_nodes(); ++u) {
+				auto const targets = s.neighbours(u);
+				auto const start = bytes_.size();
+				auto const skips = skip_count(targets.size());
+				bytes_.resize(start + skips * sizeof(skip));
+				auto const groups_start = bytes_.size();
+				for (auto b = std::size_t{0}; b * block_size < targets.size(); ++b) {
+					auto const first = b * block_size;
+					auto const base = b == 0 ? id_type{0} : targets[first - 1];
+					if (b > 0) {
+						auto const offset = static_cast<std::uint32_t>(bytes_.size() - groups_start);
+						auto const entry = skip{base, offset};
+						std::memcpy(bytes_.data() + start + (b - 1) * sizeof(skip),
+						            &entry,
+						            sizeof(skip));
+					}
+					detail::varint::encode(targets.data() + first,
+					                       std::min(block_size, targets.size() - first),
+					                       base,
+					                       bytes_);
+				}
+				byte_offsets_.push_back(bytes_.size());
+			}
+			bytes_.resize(bytes_.size() + detail::varint::padding, 0);
+			bytes_.shrink_to_fit();
+
+			encode_weights(s.weights(), encoding);
+		}
+
+		// Accessors
+
+		[[nodiscard]] auto num_nodes() const noexcept -> std::size_t {
+			return nodes_.size();
+		}
+
+		[[nodiscard]] auto num_edges() const noexcept -> std::size_t {
+			return edge_offsets_.back();
+		}
+
+		[[nodiscard]] auto node(id_type id) const -> N const& {
+			return nodes_.at(id);
+		}
+
+		[[nodiscard]] auto id(N const& value) const -> std::optional<id_type> {
+			// O(log(n)), searching the ids in N order
+			if (permutation_.empty()) {
+				auto const it = std::lower_bound(nodes_.begin(), nodes_.end(), value);
+				if (it != nodes_.end() and not(value < *it)) {
+					return static_cast<id_type>(it - nodes_.begin());
+				}
+				return std::nullopt;
+			}
+			auto const it = std::ranges::lower_bound(permutation_,
+			                                         value,
+			                                         std::less<>{},
+			                                         [&](id_type id) -> N const& { return nodes_[id]; });
+			if (it != permutation_.end() and not(value < nodes_[*it])) {
+				return *it;
+			}
+			return std::nullopt;
+		}
+
+		[[nodiscard]] auto out_degree(id_type id) const noexcept -> std::size_t {
+			return edge_offsets_[id + 1] - edge_offsets_[id];
+		}
+
+		// Calls f(to, weight) for every outgoing edge of id, in the order of the graph's edge set.
+		// Edges are decoded a block at a time, so no list is ever materialised.
+		template<typename F>
+		auto for_each_edge(id_type id, F f) const -> void {
+			auto const degree = out_degree(id);
+			auto const level = detail::simd::best_isa();
+			auto block = std::array<id_type, block_size>{};
+			auto const* in = bytes_.data() + byte_offsets_[id] + skip_count(degree) * sizeof(skip);
+			auto edge = edge_offsets_[id];
+			for (auto first = std::size_t{0}; first < degree; first += block_size) {
+				auto const count = std::min(block_size, degree - first);
+				auto const base = first == 0 ? id_type{0} : block.back();
+				in = detail::varint::decode(in, count, base, block.data(), level);
+				for (auto k = std::size_t{0}; k < count; ++k) {
+					f(block[k], weight(edge++));
+				}
+			}
+		}
+
+		[[nodiscard]] auto neighbours(id_type id) const -> std::vector<id_type> {
+			auto result = std::vector<id_type>();
+			result.reserve(out_degree(id));
+			for_each_edge(id, [&](id_type to, E const&) { result.push_back(to); });
+			return result;
+		}
+
+		[[nodiscard]] auto weights(id_type id) const -> std::vector<E> {
+			auto result = std::vector<E>();
+			result.reserve(out_degree(id));
+			for (auto e = edge_offsets_[id]; e < edge_offsets_[id + 1]; ++e) {
+				result.push_back(weight(e));
+			}
+			return result;
+		}
+
+		[[nodiscard]] auto has_edge(id_type src, id_type dst) const noexcept -> bool {
+			// Time complexity
+			//        scan skip table    - d / 64 +
+			//        decode one block   - 64
+			//     = O(d / 64) solution, with no binary search
+			auto const degree = out_degree(src);
+			auto const* const start = bytes_.data() + byte_offsets_[src];
+			auto const skips = skip_count(degree);
+			// A block holds dst if it is the last one whose preceding value is below dst
+			auto block = std::size_t{0};
+			auto entry = skip{0, 0};
+			for (; block < skips; ++block) {
+				auto next = skip{};
+				std::memcpy(&next, start + block * sizeof(skip), sizeof(skip));
+				if (next.base >= dst) {
+					break;
+				}
+				entry = next;
+			}
+			auto values = std::array<id_type, block_size>{};
+			auto const count = std::min(block_size, degree - block * block_size);
+			detail::varint::decode(start + skips * sizeof(skip) + entry.offset,
+			                       count,
+			                       entry.base,
+			                       values.data());
+			return std::find(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(count), dst)
+			       != values.begin() + static_cast<std::ptrdiff_t>(count);
+		}
+
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			auto const src_id = id(src);
+			auto const dst_id = id(dst);
+			if (src_id and dst_id) {
+				return has_edge(*src_id, *dst_id);
+			}
+			throw std::runtime_error("Cannot call gdwg::compressed_graph<N, E>::is_connected if src or "
+			                         "dst node don't exist in the graph");
+		}
+
+		[[nodiscard]] auto weights_encoding() const noexcept -> weight_encoding {
+			return dictionary_encoded_ ? weight_encoding::dictionary : weight_encoding::plain;
+		}
+
+		// Memory owned by the compressed graph, counting every node value as sizeof(N)
+		[[nodiscard]] auto bytes_used() const noexcept -> std::size_t {
+			return bytes_.size() + nodes_.size() * sizeof(N)
+			       + (byte_offsets_.size() + edge_offsets_.size()) * sizeof(std::size_t)
+			       + permutation_.size() * sizeof(id_type) + codes_.size()
+			       + (dictionary_.size() + weights_.size()) * sizeof(E);
+		}
+
+		[[nodiscard]] auto bytes_per_edge() const noexcept -> double {
+			if (num_edges() == 0) {
+				return 0.0;
+			}
+			return static_cast<double>(bytes_used()) / static_cast<double>(num_edges());
+		}
+
+	private:
+		static constexpr auto block_size = std::size_t{64};
+
+		// Where block i + 1 of a neighbour list starts, relative to the end of the skip table, and
+		// the last target of block i, which block i + 1 is delta coded against
+		struct skip {
+			std::uint32_t base;
+			std::uint32_t offset;
+		};
+
+		static auto skip_count(std::size_t degree) noexcept -> std::size_t {
+			return degree == 0 ? 0 : (degree - 1) / block_size;
+		}
+
+		auto encode_weights(std::span<E const> weights, weight_encoding encoding) -> void {
+			if (encoding != weight_encoding::plain) {
+				auto distinct = std::vector<E>(weights.begin(), weights.end());
+				std::sort(distinct.begin(), distinct.end());
+				distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+				auto const fits = distinct.size() <= 256;
+				if (encoding == weight_encoding::dictionary and not fits) {
+					throw std::runtime_error("Cannot build gdwg::compressed_graph<N, E> with a weight "
+					                         "dictionary for more than 256 distinct weights");
+				}
+				// One code per edge plus the dictionary, against one E per edge
+				auto const smaller = weights.size() + distinct.size() * sizeof(E)
+				                     < weights.size() * sizeof(E);
+				if (encoding == weight_encoding::dictionary or (fits and smaller)) {
+					codes_.reserve(weights.size());
+					for (auto const& weight : weights) {
+						auto const it = std::lower_bound(distinct.begin(), distinct.end(), weight);
+						codes_.push_back(static_cast<std::uint8_t>(it - distinct.begin()));
+					}
+					dictionary_ = std::move(distinct);
+					dictionary_encoded_ = true;
+					return;
+				}
+			}
+			weights_.assign(weights.begin(), weights.end());
+		}
+
+		auto weight(std::size_t edge) const noexcept -> E const& {
+			return dictionary_encoded_ ? dictionary_[codes_[edge]] : weights_[edge];
+		}
+
+		std::vector<N> nodes_;
+		std::vector<id_type> permutation_; // Empty for ordering::natural
+		std::vector<std::size_t> edge_offsets_ = std::vector<std::size_t>(1, 0);
+		std::vector<std::size_t> byte_offsets_ = std::vector<std::size_t>(1, 0);
+		std::vector<std::uint8_t> bytes_;
+		std::vector<E> weights_;
+		std::vector<E> dictionary_;
+		std::vector<std::uint8_t> codes_;
+		bool dictionary_encoded_ = false;
+	};
+
+	template<typename N, typename E>
+	compressed_graph(graph<N, E> const&) -> compressed_graph<N, E>;
+
+	template<typename N, typename E>
+	compressed_graph(snapshot<N, E> const&) -> compressed_graph<N, E>;
+} // namespace gdwg
+
+#endif // GDWG_COMPRESSED_GRAPH_HPP
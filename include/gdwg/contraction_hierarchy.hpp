@@ -0,0 +1,758 @@
+#ifndef GDWG_CONTRACTION_HIERARCHY_HPP
+#define GDWG_CONTRACTION_HIERARCHY_HPP
+
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/detail/serialize.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_path.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Preprocessed shortest-path index for a graph that rarely changes.
+	//
+	// Nodes are contracted one at a time from least to most important: contracting u removes it
+	// and adds a shortcut x -> y for every path x -> u -> y that is the only shortest path between
+	// its ends (which a bounded "witness" search for another path decides). Every shortest path
+	// then has an equally short version that only climbs to more important nodes and then only
+	// descends, so a query is two small Dijkstra searches that each only go upwards, and meet at
+	// the top. Queries settle a few hundred nodes where a plain search can settle most of the
+	// graph.
+	//
+	// Importance is the number of shortcuts a contraction would add minus the edges it removes,
+	// plus the number of neighbours already contracted, which keeps contraction spread evenly.
+	// Each round contracts every node less important than all of its remaining neighbours. These
+	// nodes are never adjacent, so their witness searches (which avoid every node of the round)
+	// run in parallel, and the result doesn't depend on the number of threads.
+	//
+	// Ids are those of a natural snapshot of the graph, i.e. positions in graph::nodes(). Weights
+	// must not be negative. Parallel edges keep their lightest weight, and self-loops are dropped.
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	class contraction_hierarchy {
+	public:
+		using id_type = std::uint32_t;
+
+		// Constructors
+
+		contraction_hierarchy() = default;
+
+		// A threads value of 0 uses every hardware thread
+		explicit contraction_hierarchy(graph<N, E> const& g, std::size_t threads = 0) {
+			// Time complexity
+			//        contract nodes    - n * (cost of one witness search per in-neighbour)
+			//     = O(n * d^2 * c log(c)) solution in the worst case, for searches that settle at
+			//       most c nodes, and much less on sparse road-like graphs
+			auto const s = snapshot<N, E>(g);
+			auto const n = s.num_nodes();
+			nodes_.assign(s.nodes().begin(), s.nodes().end());
+
+			auto overlay = contraction(n);
+			for (auto u = id_type{0}; u < n; ++u) {
+				auto const targets = s.neighbours(u);
+				auto const weights = s.weights(u);
+				for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+					if constexpr (std::is_signed_v<E>) {
+						if (weights[k] < E{}) {
+							throw std::runtime_error("Cannot build gdwg::contraction_hierarchy<N, E> from "
+							                         "a graph with negative edge weights");
+						}
+					}
+					// Parallel edges are adjacent, lightest first
+					if (targets[k] == u or (k > 0 and targets[k - 1] == targets[k])) {
+						continue;
+					}
+					overlay.out[u].push_back({targets[k], none, weights[k]});
+					overlay.in[targets[k]].push_back({u, none, weights[k]});
+				}
+			}
+			overlay.run(threads);
+
+			rank_ = std::move(overlay.rank);
+			flatten(overlay.up, up_offsets_, up_targets_, up_middles_, up_weights_);
+			flatten(overlay.down, down_offsets_, down_targets_, down_middles_, down_weights_);
+		}
+
+		// Accessors
+
+		[[nodiscard]] auto num_nodes() const noexcept -> std::size_t {
+			return nodes_.size();
+		}
+
+		// Edges of the hierarchy, counting original edges and shortcuts
+		[[nodiscard]] auto num_edges() const noexcept -> std::size_t {
+			return up_targets_.size() + down_targets_.size();
+		}
+
+		[[nodiscard]] auto num_shortcuts() const noexcept -> std::size_t {
+			auto const is_shortcut = [](id_type middle) { return middle != none; };
+			auto const up = std::count_if(up_middles_.begin(), up_middles_.end(), is_shortcut);
+			auto const down = std::count_if(down_middles_.begin(), down_middles_.end(), is_shortcut);
+			return static_cast<std::size_t>(up + down);
+		}
+
+		[[nodiscard]] auto node(id_type id) const -> N const& {
+			return nodes_.at(id);
+		}
+
+		[[nodiscard]] auto id(N const& value) const -> std::optional<id_type> {
+			auto const it = std::lower_bound(nodes_.begin(), nodes_.end(), value);
+			if (it != nodes_.end() and not(value < *it)) {
+				return static_cast<id_type>(it - nodes_.begin());
+			}
+			return std::nullopt;
+		}
+
+		// Position of id in the contraction order, where higher ranks are more important
+		[[nodiscard]] auto rank(id_type id) const -> id_type {
+			return rank_.at(id);
+		}
+
+		// Queries
+		//
+		// The overloads taking a search_context reuse its state between queries. The others use
+		// a context kept per thread, so they are safe to call concurrently and, after the first
+		// query on each thread, allocate nothing for the search itself.
+
+		[[nodiscard]] auto distance(id_type src, id_type dst, search_context<E>& context) const
+		   -> std::optional<E> {
+			// Time complexity
+			//        upward searches    - k log(k), for the k nodes and edges above src and dst
+			//     = O(k log(k)) solution
+			check_ids(src, dst, "distance");
+			auto const found = search(src, dst, context);
+			if (not found) {
+				return std::nullopt;
+			}
+			return found->first;
+		}
+
+		[[nodiscard]] auto distance(N const& src, N const& dst) const -> std::optional<E> {
+			auto const [src_id, dst_id] = ids(src, dst, "distance");
+			return distance(src_id, dst_id, thread_context());
+		}
+
+		// Shortest path in the original graph, with every shortcut unpacked into the edges it
+		// stands for
+		[[nodiscard]] auto path(id_type src, id_type dst, search_context<E>& context) const
+		   -> std::optional<weighted_path<E>> {
+			// Time complexity
+			//        upward searches    - k log(k) +
+			//        unpack shortcuts   - p log(d), for p edges on the path
+			//     = O(k log(k) + p log(d)) solution
+			check_ids(src, dst, "path");
+			auto const found = search(src, dst, context);
+			if (not found) {
+				return std::nullopt;
+			}
+			auto const meet = found->second;
+			auto hops = std::vector<id_type>();
+			detail::append_parents(context.forward(), meet, hops);
+			std::reverse(hops.begin(), hops.end());
+			hops.pop_back();
+			detail::append_parents(context.backward(), meet, hops);
+
+			auto result = weighted_path<E>{found->first, {hops.front()}};
+			for (auto i = std::size_t{1}; i < hops.size(); ++i) {
+				unpack(hops[i - 1], hops[i], result.nodes);
+			}
+			return result;
+		}
+
+		[[nodiscard]] auto path(N const& src, N const& dst) const -> std::optional<std::vector<N>> {
+			auto const [src_id, dst_id] = ids(src, dst, "path");
+			auto const found = path(src_id, dst_id, thread_context());
+			if (not found) {
+				return std::nullopt;
+			}
+			auto result = std::vector<N>();
+			result.reserve(found->nodes.size());
+			for (auto const id : found->nodes) {
+				result.push_back(nodes_[id]);
+			}
+			return result;
+		}
+
+		// Serialisation
+		//
+		// The format is binary, in the byte order of the machine that wrote it, and is rejected
+		// by load() on a machine with another byte order or other sizes of E or std::size_t.
+
+		auto save(std::ostream& os) const -> void
+		requires detail::serialize::serializable<N> {
+			auto out = detail::serialize::writer(os);
+			out.write(magic);
+			out.write(version);
+			out.write(detail::serialize::byte_order_mark);
+			out.write(layout());
+			out.write(nodes_);
+			out.write(rank_);
+			out.write(up_offsets_);
+			out.write(up_targets_);
+			out.write(up_middles_);
+			out.write(up_weights_);
+			out.write(down_offsets_);
+			out.write(down_targets_);
+			out.write(down_middles_);
+			out.write(down_weights_);
+			if (not out.ok()) {
+				throw std::runtime_error("Cannot call gdwg::contraction_hierarchy<N, E>::save on a "
+				                         "stream that can't be written");
+			}
+		}
+
+		auto save(std::filesystem::path const& file) const -> void
+		requires detail::serialize::serializable<N> {
+			auto os = std::ofstream(file, std::ios::binary | std::ios::trunc);
+			save(os);
+			os.flush();
+			if (not os) {
+				throw std::runtime_error("Cannot call gdwg::contraction_hierarchy<N, E>::save on a "
+				                         "stream that can't be written");
+			}
+		}
+
+		[[nodiscard]] static auto load(std::istream& is) -> contraction_hierarchy
+		requires detail::serialize::serializable<N> {
+			auto in = detail::serialize::reader(is);
+			auto header = decltype(magic){};
+			auto file_version = std::uint32_t{0};
+			auto mark = std::uint32_t{0};
+			auto file_layout = decltype(layout()){};
+			in.read(header);
+			in.read(file_version);
+			in.read(mark);
+			in.read(file_layout);
+			if (header != magic or file_version != version or mark != detail::serialize::byte_order_mark
+			    or file_layout != layout()) {
+				in.fail();
+			}
+			auto result = contraction_hierarchy();
+			in.read(result.nodes_);
+			in.read(result.rank_);
+			in.read(result.up_offsets_);
+			in.read(result.up_targets_);
+			in.read(result.up_middles_);
+			in.read(result.up_weights_);
+			in.read(result.down_offsets_);
+			in.read(result.down_targets_);
+			in.read(result.down_middles_);
+			in.read(result.down_weights_);
+			if (not in.ok() or not result.valid()) {
+				throw std::runtime_error("Cannot call gdwg::contraction_hierarchy<N, E>::load on a "
+				                         "stream that doesn't hold a valid contraction hierarchy");
+			}
+			return result;
+		}
+
+		[[nodiscard]] static auto load(std::filesystem::path const& file) -> contraction_hierarchy
+		requires detail::serialize::serializable<N> {
+			auto is = std::ifstream(file, std::ios::binary);
+			return load(is);
+		}
+
+	private:
+		// Middle node of an edge that is not a shortcut
+		static constexpr auto none = std::numeric_limits<id_type>::max();
+
+		static constexpr auto magic = std::array<char, 8>{'g', 'd', 'w', 'g', '-', 'c', 'h', '\0'};
+		static constexpr auto version = std::uint32_t{1};
+
+		// Sizes that must match between the writer and the reader, and whether E is a floating-point
+		// type
+		static constexpr auto layout() noexcept -> std::array<std::uint32_t, 3> {
+			return {static_cast<std::uint32_t>(sizeof(E)),
+			        static_cast<std::uint32_t>(sizeof(std::size_t)),
+			        std::is_floating_point_v<E> ? 1U : 0U};
+		}
+
+		struct arc {
+			id_type node;
+			id_type middle;
+			E weight;
+		};
+
+		// The graph during preprocessing: the remaining nodes, their edges and shortcuts, and the
+		// upward edges of every node contracted so far
+		struct contraction {
+			// Witness searches give up after settling this many nodes, and the shortcut is added
+			// anyway; a few unnecessary shortcuts cost far less than unbounded searches. Searches
+			// that only estimate importance give up sooner.
+			static constexpr auto settle_limit = std::size_t{500};
+			static constexpr auto estimate_settle_limit = std::size_t{60};
+
+			enum class status : std::uint8_t { remaining, in_round, contracted };
+
+			explicit contraction(std::size_t n)
+			: out(n)
+			, in(n)
+			, up(n)
+			, down(n)
+			, rank(n, 0)
+			, state(n, status::remaining)
+			, priority(n, 0)
+			, contracted_neighbours(n, 0)
+			, level(n, 0) {}
+
+			std::vector<std::vector<arc>> out;
+			std::vector<std::vector<arc>> in;
+			std::vector<std::vector<arc>> up; // Edges to more important nodes
+			std::vector<std::vector<arc>> down; // Edges from more important nodes
+			std::vector<id_type> rank;
+			std::vector<status> state;
+			std::vector<std::int64_t> priority;
+			std::vector<std::int64_t> contracted_neighbours;
+			std::vector<std::int64_t> level; // Longest chain of contracted nodes below each node
+
+			struct shortcut {
+				id_type from;
+				id_type to;
+				E weight;
+			};
+
+			// Scratch space of one thread
+			struct workspace {
+				detail::search_state<E> search;
+				std::vector<std::uint32_t> target; // Stamped with the generation of the search
+			};
+
+			auto run(std::size_t threads) -> void {
+				auto const n = out.size();
+				auto workers = std::vector<workspace>(detail::thread_count(threads));
+				auto remaining = std::vector<id_type>(n);
+				for (auto u = id_type{0}; u < n; ++u) {
+					remaining[u] = u;
+				}
+				detail::parallel_for(
+				   n,
+				   threads,
+				   [&](std::size_t u, std::size_t worker) {
+					   priority[u] = evaluate(static_cast<id_type>(u), workers[worker], nullptr);
+				   },
+				   16);
+
+				auto next_rank = id_type{0};
+				auto selected = std::vector<std::uint8_t>();
+				auto round = std::vector<id_type>();
+				auto shortcuts = std::vector<std::vector<shortcut>>();
+				auto touched = std::vector<id_type>();
+				while (not remaining.empty()) {
+					// Nodes less important than every remaining neighbour, which are independent
+					selected.assign(remaining.size(), 0);
+					detail::parallel_for(
+					   remaining.size(),
+					   threads,
+					   [&](std::size_t i, std::size_t) { selected[i] = is_local_minimum(remaining[i]); },
+					   256);
+					round.clear();
+					for (auto i = std::size_t{0}; i < remaining.size(); ++i) {
+						if (selected[i] != 0) {
+							round.push_back(remaining[i]);
+							state[remaining[i]] = status::in_round;
+						}
+					}
+
+					shortcuts.assign(round.size(), {});
+					detail::parallel_for(
+					   round.size(),
+					   threads,
+					   [&](std::size_t i, std::size_t worker) {
+						   evaluate(round[i], workers[worker], &shortcuts[i]);
+					   },
+					   4);
+
+					touched.clear();
+					for (auto i = std::size_t{0}; i < round.size(); ++i) {
+						auto const u = round[i];
+						rank[u] = next_rank++;
+						state[u] = status::contracted;
+						for (auto const& edge : out[u]) {
+							if (state[edge.node] == status::remaining) {
+								up[u].push_back(edge);
+								touched.push_back(edge.node);
+								level[edge.node] = std::max(level[edge.node], level[u] + 1);
+							}
+						}
+						for (auto const& edge : in[u]) {
+							if (state[edge.node] == status::remaining) {
+								down[u].push_back(edge);
+								touched.push_back(edge.node);
+								level[edge.node] = std::max(level[edge.node], level[u] + 1);
+							}
+						}
+						out[u] = {};
+						in[u] = {};
+						for (auto const& [from, to, weight] : shortcuts[i]) {
+							add_shortcut(from, to, weight, u);
+						}
+					}
+
+					// Neighbours lose their edges to contracted nodes and are re-evaluated
+					std::sort(touched.begin(), touched.end());
+					touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+					for (auto const v : touched) {
+						auto const contracted = [&](arc const& edge) {
+							return state[edge.node] == status::contracted;
+						};
+						auto const removed = std::erase_if(out[v], contracted) + std::erase_if(in[v], contracted);
+						contracted_neighbours[v] += static_cast<std::int64_t>(removed);
+					}
+					detail::parallel_for(
+					   touched.size(),
+					   threads,
+					   [&](std::size_t i, std::size_t worker) {
+						   priority[touched[i]] = evaluate(touched[i], workers[worker], nullptr);
+					   },
+					   16);
+
+					std::erase_if(remaining, [&](id_type u) { return state[u] == status::contracted; });
+				}
+			}
+
+			[[nodiscard]] auto is_local_minimum(id_type u) const -> std::uint8_t {
+				auto const before = [&](id_type v) {
+					return priority[u] < priority[v] or (priority[u] == priority[v] and u < v);
+				};
+				for (auto const* edges : {&out[u], &in[u]}) {
+					for (auto const& edge : *edges) {
+						if (state[edge.node] == status::remaining and edge.node != u
+						    and not before(edge.node)) {
+							return 0;
+						}
+					}
+				}
+				return 1;
+			}
+
+			// Finds the shortcuts that contracting u needs, appending them to shortcuts if it is
+			// given, and returns u's importance
+			auto evaluate(id_type u, workspace& scratch, std::vector<shortcut>* shortcuts) -> std::int64_t {
+				auto const& search = scratch.search;
+				auto const limit_settled = shortcuts == nullptr ? estimate_settle_limit : settle_limit;
+				auto added = std::int64_t{0};
+				for (auto const& into : in[u]) {
+					auto const x = into.node;
+					auto limit = std::optional<E>();
+					for (auto const& from : out[u]) {
+						auto const via = static_cast<E>(into.weight + from.weight);
+						if (from.node != x and (not limit or *limit < via)) {
+							limit = via;
+						}
+					}
+					if (not limit) {
+						continue;
+					}
+					witness_search(x, u, *limit, limit_settled, scratch);
+					for (auto const& from : out[u]) {
+						auto const via = static_cast<E>(into.weight + from.weight);
+						if (from.node == x) {
+							continue;
+						}
+						if (not search.reached(from.node) or via < search.distance[from.node]) {
+							++added;
+							if (shortcuts != nullptr) {
+								shortcuts->push_back({x, from.node, via});
+							}
+						}
+					}
+				}
+				auto const removed = static_cast<std::int64_t>(in[u].size() + out[u].size());
+				return 2 * (added - removed) + contracted_neighbours[u] + level[u];
+			}
+
+			// Shortest distances from x, up to limit, over the remaining nodes other than u. The
+			// search stops early once every out-neighbour of u is settled.
+			auto witness_search(id_type x, id_type u, E limit, std::size_t max_settled, workspace& scratch)
+			   const -> void {
+				auto& search = scratch.search;
+				search.begin(out.size());
+				scratch.target.resize(out.size(), 0);
+				auto targets = std::size_t{0};
+				for (auto const& edge : out[u]) {
+					if (edge.node != x and scratch.target[edge.node] != search.generation) {
+						scratch.target[edge.node] = search.generation;
+						++targets;
+					}
+				}
+				search.relax(x, E{}, E{}, x);
+				auto settled = std::size_t{0};
+				while (not search.heap.empty()) {
+					auto const top = search.pop();
+					if (search.distance[top.node] < top.distance) {
+						continue;
+					}
+					if (limit < top.distance or ++settled > max_settled) {
+						return;
+					}
+					if (scratch.target[top.node] == search.generation) {
+						scratch.target[top.node] = 0;
+						if (--targets == 0) {
+							return;
+						}
+					}
+					for (auto const& edge : out[top.node]) {
+						if (edge.node != u and state[edge.node] == status::remaining) {
+							auto const d = static_cast<E>(top.distance + edge.weight);
+							search.relax(edge.node, d, d, top.node);
+						}
+					}
+				}
+			}
+
+			auto add_shortcut(id_type from, id_type to, E weight, id_type middle) -> void {
+				auto const update = [&](std::vector<arc>& edges, id_type node) {
+					auto const it = std::find_if(edges.begin(), edges.end(), [&](arc const& edge) {
+						return edge.node == node;
+					});
+					if (it == edges.end()) {
+						edges.push_back({node, middle, weight});
+					}
+					else if (weight < it->weight) {
+						*it = {node, middle, weight};
+					}
+				};
+				update(out[from], to);
+				update(in[to], from);
+			}
+		};
+
+		// Lays out the edges of every node contiguously, sorted by the node at the other end
+		static auto flatten(std::vector<std::vector<arc>>& lists,
+		                    std::vector<std::size_t>& offsets,
+		                    std::vector<id_type>& targets,
+		                    std::vector<id_type>& middles,
+		                    std::vector<E>& weights) -> void {
+			offsets.assign(1, 0);
+			for (auto& list : lists) {
+				std::sort(list.begin(), list.end(), [](arc const& lhs, arc const& rhs) {
+					return lhs.node < rhs.node;
+				});
+				for (auto const& edge : list) {
+					targets.push_back(edge.node);
+					middles.push_back(edge.middle);
+					weights.push_back(edge.weight);
+				}
+				offsets.push_back(targets.size());
+				list = {};
+			}
+		}
+
+		// Bidirectional search of the upward edges from src and the downward edges into dst,
+		// returning the distance and the node where the two searches meet
+		auto search(id_type src, id_type dst, search_context<E>& context) const
+		   -> std::optional<std::pair<E, id_type>> {
+			auto& forward = context.forward();
+			auto& backward = context.backward();
+			forward.begin(num_nodes());
+			backward.begin(num_nodes());
+			forward.relax(src, E{}, E{}, src);
+			backward.relax(dst, E{}, E{}, dst);
+			auto best = std::optional<std::pair<E, id_type>>();
+			for (;;) {
+				forward.prune();
+				backward.prune();
+				if (forward.heap.empty() and backward.heap.empty()) {
+					break;
+				}
+				auto const grow_forward =
+				   backward.heap.empty()
+				   or (not forward.heap.empty()
+				       and not(backward.heap.front().key < forward.heap.front().key));
+				auto& side = grow_forward ? forward : backward;
+				auto const& other = grow_forward ? backward : forward;
+				// Both frontiers are at least this far away, so nothing shorter remains
+				if (best and not(side.heap.front().key < best->first)) {
+					break;
+				}
+				auto const top = side.pop();
+				auto const u = top.node;
+				++side.settled;
+				if (other.reached(u)) {
+					auto const through = static_cast<E>(top.distance + other.distance[u]);
+					if (not best or through < best->first) {
+						best = std::pair(through, u);
+					}
+				}
+				auto const& offsets = grow_forward ? up_offsets_ : down_offsets_;
+				auto const& targets = grow_forward ? up_targets_ : down_targets_;
+				auto const& weights = grow_forward ? up_weights_ : down_weights_;
+				for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+					auto const d = static_cast<E>(top.distance + weights[e]);
+					side.relax(targets[e], d, d, u);
+				}
+			}
+			return best;
+		}
+
+		// Appends the original edges that the edge from -> to stands for, without from itself
+		auto unpack(id_type from, id_type to, std::vector<id_type>& out) const -> void {
+			auto pending = std::vector<std::pair<id_type, id_type>>{{from, to}};
+			while (not pending.empty()) {
+				auto const [a, b] = pending.back();
+				pending.pop_back();
+				auto const middle = middle_of(a, b);
+				if (middle == none) {
+					out.push_back(b);
+				}
+				else {
+					// The first half is unpacked first
+					pending.emplace_back(middle, b);
+					pending.emplace_back(a, middle);
+				}
+			}
+		}
+
+		// The middle of an edge that a query reached, so the edge exists
+		[[nodiscard]] auto middle_of(id_type from, id_type to) const -> id_type {
+			auto const middle = find_middle(from, to);
+			assert(middle.has_value());
+			return *middle;
+		}
+
+		// An edge is stored with its less important end, upwards or downwards. Returns the middle
+		// of the first edge from -> to, which is none for an original edge, or std::nullopt if there
+		// is no such edge.
+		[[nodiscard]] auto find_middle(id_type from, id_type to) const -> std::optional<id_type> {
+			auto const upward = rank_[from] < rank_[to];
+			auto const owner = upward ? from : to;
+			auto const other = upward ? to : from;
+			auto const& offsets = upward ? up_offsets_ : down_offsets_;
+			auto const& targets = upward ? up_targets_ : down_targets_;
+			auto const& middles = upward ? up_middles_ : down_middles_;
+			auto const first = targets.begin() + static_cast<std::ptrdiff_t>(offsets[owner]);
+			auto const last = targets.begin() + static_cast<std::ptrdiff_t>(offsets[owner + 1]);
+			auto const it = std::lower_bound(first, last, other);
+			if (it == last or *it != other) {
+				return std::nullopt;
+			}
+			return middles[static_cast<std::size_t>(it - targets.begin())];
+		}
+
+		[[noreturn]] static auto throw_missing_node(char const* query) -> void {
+			throw std::runtime_error(std::string("Cannot call gdwg::contraction_hierarchy<N, E>::")
+			                         + query + " if src or dst node don't exist in the graph");
+		}
+
+		auto check_ids(id_type src, id_type dst, char const* query) const -> void {
+			if (src >= num_nodes() or dst >= num_nodes()) {
+				throw_missing_node(query);
+			}
+		}
+
+		auto ids(N const& src, N const& dst, char const* query) const -> std::pair<id_type, id_type> {
+			auto const src_id = id(src);
+			auto const dst_id = id(dst);
+			if (not src_id or not dst_id) {
+				throw_missing_node(query);
+			}
+			return {*src_id, *dst_id};
+		}
+
+		static auto thread_context() -> search_context<E>& {
+			thread_local auto context = search_context<E>();
+			return context;
+		}
+
+		// Checks a loaded hierarchy, so that no query can index out of bounds
+		[[nodiscard]] auto valid() const -> bool {
+			auto const n = nodes_.size();
+			if (rank_.size() != n or not std::is_sorted(nodes_.begin(), nodes_.end())) {
+				return false;
+			}
+			auto seen = std::vector<bool>(n, false);
+			for (auto const r : rank_) {
+				if (r >= n or seen[r]) {
+					return false;
+				}
+				seen[r] = true;
+			}
+			auto const valid_lists = [&](std::vector<std::size_t> const& offsets,
+			                             std::vector<id_type> const& targets,
+			                             std::vector<id_type> const& middles,
+			                             std::vector<E> const& weights) {
+				if (offsets.size() != n + 1 or offsets.front() != 0 or offsets.back() != targets.size()
+				    or middles.size() != targets.size() or weights.size() != targets.size()
+				    or not std::is_sorted(offsets.begin(), offsets.end())) {
+					return false;
+				}
+				for (auto u = std::size_t{0}; u < n; ++u) {
+					auto const first = targets.begin() + static_cast<std::ptrdiff_t>(offsets[u]);
+					auto const last = targets.begin() + static_cast<std::ptrdiff_t>(offsets[u + 1]);
+					if (not std::is_sorted(first, last)) {
+						return false; // middle_of() searches them
+					}
+					for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+						if (targets[e] >= n or rank_[targets[e]] <= rank_[u]
+						    or (middles[e] != none and middles[e] >= n)) {
+							return false;
+						}
+					}
+				}
+				return true;
+			};
+			if (not valid_lists(up_offsets_, up_targets_, up_middles_, up_weights_)
+			    or not valid_lists(down_offsets_, down_targets_, down_middles_, down_weights_))
+			{
+				return false;
+			}
+
+			// A shortcut from -> to through middle stands for the edges from -> middle and
+			// middle -> to, which must exist for unpack() to follow. middle is less important than
+			// both ends, so every step of unpacking reaches less important nodes and ends.
+			auto const valid_shortcut = [&](id_type from, id_type to, id_type middle) {
+				return rank_[middle] < rank_[from] and rank_[middle] < rank_[to]
+				       and find_middle(from, middle) and find_middle(middle, to);
+			};
+			for (auto u = id_type{0}; u < n; ++u) {
+				for (auto e = up_offsets_[u]; e < up_offsets_[u + 1]; ++e) {
+					if (up_middles_[e] != none and not valid_shortcut(u, up_targets_[e], up_middles_[e])) {
+						return false;
+					}
+				}
+				for (auto e = down_offsets_[u]; e < down_offsets_[u + 1]; ++e) {
+					if (down_middles_[e] != none
+					    and not valid_shortcut(down_targets_[e], u, down_middles_[e]))
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		std::vector<N> nodes_;
+		std::vector<id_type> rank_;
+		std::vector<std::size_t> up_offsets_ = std::vector<std::size_t>(1, 0);
+		std::vector<id_type> up_targets_;
+		std::vector<id_type> up_middles_;
+		std::vector<E> up_weights_;
+		std::vector<std::size_t> down_offsets_ = std::vector<std::size_t>(1, 0);
+		std::vector<id_type> down_targets_; // Sources of edges into each node, from above
+		std::vector<id_type> down_middles_;
+		std::vector<E> down_weights_;
+	};
+
+	template<typename N, typename E>
+	contraction_hierarchy(graph<N, E> const&) -> contraction_hierarchy<N, E>;
+
+	template<typename N, typename E>
+	contraction_hierarchy(graph<N, E> const&, std::size_t) -> contraction_hierarchy<N, E>;
+} // namespace gdwg
+
+#endif // GDWG_CONTRACTION_HIERARCHY_HPP
@@ -0,0 +1,271 @@
+#ifndef GDWG_DAG_HPP
+#define GDWG_DAG_HPP
+
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_path.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Orderings and paths of directed acyclic graphs, such as dependency or scheduling graphs. The
+// snapshot versions work on and return snapshot ids; the graph versions build a snapshot and
+// return nodes. Every function but find_cycle() throws if the graph has a cycle, self-loops
+// included.
+namespace gdwg {
+	namespace detail {
+		[[noreturn]] inline auto throw_cyclic(char const* algorithm) -> void {
+			throw std::runtime_error(std::string("Cannot call gdwg::") + algorithm
+			                         + " on a graph with a cycle");
+		}
+
+		template<typename N, typename E>
+		auto to_nodes(snapshot<N, E> const& s, std::vector<std::uint32_t> const& ids)
+		   -> std::vector<N> {
+			auto result = std::vector<N>();
+			result.reserve(ids.size());
+			for (auto const id : ids) {
+				result.push_back(s.node(id));
+			}
+			return result;
+		}
+
+		// Kahn's algorithm, leaving out the nodes on or after a cycle
+		template<typename N, typename E>
+		auto kahn(snapshot<N, E> const& s) -> std::vector<std::uint32_t> {
+			auto const n = s.num_nodes();
+			auto in_degree = std::vector<std::uint32_t>(n, 0);
+			for (auto const v : s.targets()) {
+				++in_degree[v];
+			}
+			auto order = std::vector<std::uint32_t>();
+			order.reserve(n);
+			for (auto u = std::uint32_t{0}; u < n; ++u) {
+				if (in_degree[u] == 0) {
+					order.push_back(u);
+				}
+			}
+			// order doubles as the queue: the nodes after head are waiting to be visited
+			for (auto head = std::size_t{0}; head < order.size(); ++head) {
+				for (auto const v : s.neighbours(order[head])) {
+					if (--in_degree[v] == 0) {
+						order.push_back(v);
+					}
+				}
+			}
+			return order;
+		}
+	} // namespace detail
+
+	// Every node, each after all of its predecessors. Kahn's algorithm: nodes with no remaining
+	// incoming edges are taken first in first out, starting from those in increasing id order,
+	// so the order is stable for a given graph.
+	template<typename N, typename E>
+	[[nodiscard]] auto topological_sort(snapshot<N, E> const& s) -> std::vector<std::uint32_t> {
+		// Time complexity
+		//        count in-degrees  - n + e +
+		//        visit nodes       - n + e
+		//     = O(n + e) solution
+		auto order = detail::kahn(s);
+		if (order.size() < s.num_nodes()) {
+			detail::throw_cyclic("topological_sort");
+		}
+		return order;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto topological_sort(graph<N, E> const& g) -> std::vector<N> {
+		auto const s = snapshot<N, E>(g);
+		return detail::to_nodes(s, topological_sort(s));
+	}
+
+	// The nodes in levels, where level 0 has no incoming edges and every other node is in the
+	// level after its latest predecessor, so the nodes of a level depend only on earlier levels
+	// and can be scheduled together. Each level is processed in parallel, and then sorted by
+	// id, so the result does not depend on the number of threads.
+	template<typename N, typename E>
+	[[nodiscard]] auto topological_levels(snapshot<N, E> const& s, std::size_t threads = 0)
+	   -> std::vector<std::vector<std::uint32_t>> {
+		// Time complexity
+		//        count in-degrees  - (n + e) / p +
+		//        visit levels      - (n + e) / p + n log(n), for p threads
+		//     = O(n log(n) + e) solution
+		auto const n = s.num_nodes();
+		auto in_degree = std::vector<std::atomic<std::uint32_t>>(n);
+		detail::parallel_for(
+		   n,
+		   threads,
+		   [&](std::size_t u, std::size_t) {
+			   for (auto const v : s.neighbours(static_cast<std::uint32_t>(u))) {
+				   in_degree[v].fetch_add(1, std::memory_order_relaxed);
+			   }
+		   },
+		   1024);
+
+		auto levels = std::vector<std::vector<std::uint32_t>>();
+		auto frontier = std::vector<std::uint32_t>();
+		for (auto u = std::uint32_t{0}; u < n; ++u) {
+			if (in_degree[u].load(std::memory_order_relaxed) == 0) {
+				frontier.push_back(u);
+			}
+		}
+		auto found = std::vector<std::vector<std::uint32_t>>(detail::thread_count(threads));
+		auto visited = std::size_t{0};
+		while (not frontier.empty()) {
+			detail::parallel_for(frontier.size(), threads, [&](std::size_t i, std::size_t worker) {
+				for (auto const v : s.neighbours(frontier[i])) {
+					// The last predecessor to finish puts v in the next level
+					if (in_degree[v].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+						found[worker].push_back(v);
+					}
+				}
+			});
+			visited += frontier.size();
+			levels.push_back(std::move(frontier));
+			frontier = std::vector<std::uint32_t>();
+			for (auto& part : found) {
+				frontier.insert(frontier.end(), part.begin(), part.end());
+				part.clear();
+			}
+			std::sort(frontier.begin(), frontier.end());
+		}
+		if (visited < n) {
+			detail::throw_cyclic("topological_levels");
+		}
+		return levels;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto topological_levels(graph<N, E> const& g, std::size_t threads = 0)
+	   -> std::vector<std::vector<N>> {
+		auto const s = snapshot<N, E>(g);
+		auto result = std::vector<std::vector<N>>();
+		for (auto const& level : topological_levels(s, threads)) {
+			result.push_back(detail::to_nodes(s, level));
+		}
+		return result;
+	}
+
+	// A cycle of the graph as the nodes along it, each with an edge to the next and the last
+	// with an edge back to the first, or std::nullopt if the graph is acyclic. A self-loop is a
+	// cycle of one node.
+	template<typename N, typename E>
+	[[nodiscard]] auto find_cycle(snapshot<N, E> const& s)
+	   -> std::optional<std::vector<std::uint32_t>> {
+		// Time complexity
+		//        depth-first search visiting every node and edge once
+		//     = O(n + e) solution
+		enum class colour : std::uint8_t { unvisited, on_path, finished };
+		auto const n = s.num_nodes();
+		auto state = std::vector<colour>(n, colour::unvisited);
+		// The current path, with how many edges of each node have been followed
+		auto path = std::vector<std::pair<std::uint32_t, std::size_t>>();
+		for (auto root = std::uint32_t{0}; root < n; ++root) {
+			if (state[root] != colour::unvisited) {
+				continue;
+			}
+			state[root] = colour::on_path;
+			path.emplace_back(root, 0);
+			while (not path.empty()) {
+				auto& [u, next] = path.back();
+				auto const targets = s.neighbours(u);
+				if (next == targets.size()) {
+					state[u] = colour::finished;
+					path.pop_back();
+					continue;
+				}
+				auto const v = targets[next++];
+				if (state[v] == colour::on_path) {
+					auto cycle = std::vector<std::uint32_t>();
+					auto const start = std::find_if(path.begin(), path.end(), [&](auto const& entry) {
+						return entry.first == v;
+					});
+					for (auto it = start; it != path.end(); ++it) {
+						cycle.push_back(it->first);
+					}
+					return cycle;
+				}
+				if (state[v] == colour::unvisited) {
+					state[v] = colour::on_path;
+					path.emplace_back(v, 0);
+				}
+			}
+		}
+		return std::nullopt;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto find_cycle(graph<N, E> const& g) -> std::optional<std::vector<N>> {
+		auto const s = snapshot<N, E>(g);
+		auto const cycle = find_cycle(s);
+		if (not cycle) {
+			return std::nullopt;
+		}
+		return detail::to_nodes(s, *cycle);
+	}
+
+	// The path with the largest total weight, e.g. the critical path of a schedule whose
+	// weights are task durations. Paths may start and end at any node, and a single node is a
+	// path of length 0, so with negative weights the result may be shorter than some edge. Of
+	// paths of equal length, the one ending at the lowest id is returned.
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	[[nodiscard]] auto longest_path_dag(snapshot<N, E> const& s) -> weighted_path<E> {
+		// Time complexity
+		//        topological sort  - n + e +
+		//        relax edges       - e
+		//     = O(n + e) solution
+		auto const n = s.num_nodes();
+		if (n == 0) {
+			return {E{}, {}};
+		}
+		auto const order = detail::kahn(s);
+		if (order.size() < n) {
+			detail::throw_cyclic("longest_path_dag");
+		}
+		auto length = std::vector<E>(n, E{});
+		auto parent = std::vector<std::uint32_t>(n);
+		for (auto u = std::uint32_t{0}; u < n; ++u) {
+			parent[u] = u;
+		}
+		for (auto const u : order) {
+			auto const targets = s.neighbours(u);
+			auto const weights = s.weights(u);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				auto const through = static_cast<E>(length[u] + weights[k]);
+				if (length[targets[k]] < through) {
+					length[targets[k]] = through;
+					parent[targets[k]] = u;
+				}
+			}
+		}
+		auto const last = static_cast<std::uint32_t>(std::max_element(length.begin(), length.end())
+		                                             - length.begin());
+		auto result = weighted_path<E>{length[last], {}};
+		result.nodes.push_back(last);
+		for (auto v = last; parent[v] != v; v = parent[v]) {
+			result.nodes.push_back(parent[v]);
+		}
+		std::reverse(result.nodes.begin(), result.nodes.end());
+		return result;
+	}
+
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	[[nodiscard]] auto longest_path_dag(graph<N, E> const& g) -> weighted_path<E, N> {
+		auto const s = snapshot<N, E>(g);
+		auto const path = longest_path_dag(s);
+		return {path.distance, detail::to_nodes(s, path.nodes)};
+	}
+} // namespace gdwg
+
+#endif // GDWG_DAG_HPP
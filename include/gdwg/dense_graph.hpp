@@ -0,0 +1,304 @@
+#ifndef GDWG_DENSE_GRAPH_HPP
+#define GDWG_DENSE_GRAPH_HPP
+
+#include "gdwg/detail/simd.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gdwg {
+	// A copy of a graph as an adjacency matrix, for small graphs where a large share of all
+	// possible edges exist.
+	//
+	// Node ids are those of the snapshot the graph is built from, and the nodes are fixed, but
+	// edges between them can be inserted and erased. Row u is a bitset with bit v set when there
+	// is at least one edge from u to v, padded to a whole number of 256-bit blocks, so has_edge()
+	// is a single bit test and neighbourhood unions and intersections are word-wise OR and AND of
+	// two rows (see detail/simd.hpp). A weight matrix holds the smallest weight of each edge, and
+	// the rest of the weights of parallel edges live in a separate overflow map.
+	//
+	// The matrix takes n^2 / 8 + n^2 * sizeof(E) bytes whatever the number of edges, against
+	// around 40 bytes per edge for graph, so it only pays off for dense graphs.
+	template<typename N, typename E>
+	class dense_graph {
+	public:
+		using id_type = std::uint32_t;
+
+		// Constructors
+
+		dense_graph() = default;
+
+		explicit dense_graph(graph<N, E> const& g)
+		: dense_graph(snapshot<N, E>(g)) {}
+
+		explicit dense_graph(snapshot<N, E> const& s)
+		: nodes_(s.nodes().begin(), s.nodes().end())
+		, words_((s.num_nodes() + block_bits - 1) / block_bits * (block_bits / word_bits))
+		, rows_(s.num_nodes() * words_, 0)
+		, weights_(s.num_nodes() * s.num_nodes())
+		, degrees_(s.num_nodes(), 0) {
+			// Time complexity
+			//        allocate matrix     - n^2 +
+			//        copy edges          - e log(p), for p parallel edges between a pair
+			//     = O(n^2 + e log(p)) solution
+			if (s.order() != ordering::natural) {
+				permutation_.assign(s.permutation().begin(), s.permutation().end());
+			}
+			for (auto u = id_type{0}; u < s.num_nodes(); ++u) {
+				auto const targets = s.neighbours(u);
+				auto const weights = s.weights(u);
+				for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+					insert_edge(u, targets[k], weights[k]);
+				}
+			}
+		}
+
+		// Modifiers
+
+		// Adds an edge from src to dst, returning false if an equal edge already exists
+		auto insert_edge(id_type src, id_type dst, E const& weight) -> bool {
+			// Time complexity
+			//        set bit             - 1 +
+			//        parallel edges      - p, for p edges between src and dst
+			//     = O(p) solution, and O(1) without parallel edges
+			check_ids(src, dst, "insert_edge");
+			auto const c = cell(src, dst);
+			if (not has_edge(src, dst)) {
+				rows_[src * words_ + dst / word_bits] |= bit(dst);
+				weights_[c] = weight;
+			}
+			else {
+				auto& first = weights_[c];
+				if (weight == first) {
+					return false;
+				}
+				auto& rest = overflow_[c];
+				auto const extra = weight < first ? first : weight;
+				auto const it = std::lower_bound(rest.begin(), rest.end(), extra);
+				if (it != rest.end() and *it == extra) {
+					return false;
+				}
+				rest.insert(it, extra);
+				first = std::min(first, weight);
+			}
+			++degrees_[src];
+			++num_edges_;
+			return true;
+		}
+
+		// Removes the edge from src to dst with weight, returning false if there is none
+		auto erase_edge(id_type src, id_type dst, E const& weight) -> bool {
+			check_ids(src, dst, "erase_edge");
+			if (not has_edge(src, dst)) {
+				return false;
+			}
+			auto const c = cell(src, dst);
+			auto const it = overflow_.find(c);
+			if (weights_[c] == weight) {
+				if (it == overflow_.end()) {
+					rows_[src * words_ + dst / word_bits] &= ~bit(dst);
+					weights_[c] = E{};
+				}
+				else {
+					weights_[c] = it->second.front();
+					it->second.erase(it->second.begin());
+				}
+			}
+			else {
+				if (it == overflow_.end()) {
+					return false;
+				}
+				auto const at = std::lower_bound(it->second.begin(), it->second.end(), weight);
+				if (at == it->second.end() or not(*at == weight)) {
+					return false;
+				}
+				it->second.erase(at);
+			}
+			if (it != overflow_.end() and it->second.empty()) {
+				overflow_.erase(it);
+			}
+			--degrees_[src];
+			--num_edges_;
+			return true;
+		}
+
+		// Accessors
+
+		[[nodiscard]] auto num_nodes() const noexcept -> std::size_t {
+			return nodes_.size();
+		}
+
+		[[nodiscard]] auto num_edges() const noexcept -> std::size_t {
+			return num_edges_;
+		}
+
+		[[nodiscard]] auto node(id_type id) const -> N const& {
+			return nodes_.at(id);
+		}
+
+		[[nodiscard]] auto id(N const& value) const -> std::optional<id_type> {
+			// O(log(n)), searching the ids in N order
+			if (permutation_.empty()) {
+				auto const it = std::lower_bound(nodes_.begin(), nodes_.end(), value);
+				if (it != nodes_.end() and not(value < *it)) {
+					return static_cast<id_type>(it - nodes_.begin());
+				}
+				return std::nullopt;
+			}
+			auto const it = std::ranges::lower_bound(permutation_,
+			                                         value,
+			                                         std::less<>{},
+			                                         [&](id_type id) -> N const& { return nodes_[id]; });
+			if (it != permutation_.end() and not(value < nodes_[*it])) {
+				return *it;
+			}
+			return std::nullopt;
+		}
+
+		// Number of edges out of id, counting parallel edges
+		[[nodiscard]] auto out_degree(id_type id) const noexcept -> std::size_t {
+			return degrees_[id];
+		}
+
+		[[nodiscard]] auto has_edge(id_type src, id_type dst) const noexcept -> bool {
+			return (rows_[src * words_ + dst / word_bits] & bit(dst)) != 0;
+		}
+
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			auto const src_id = id(src);
+			auto const dst_id = id(dst);
+			if (src_id and dst_id) {
+				return has_edge(*src_id, *dst_id);
+			}
+			throw std::runtime_error("Cannot call gdwg::dense_graph<N, E>::is_connected if src or dst "
+			                         "node don't exist in the graph");
+		}
+
+		// Weights of every edge from src to dst, in increasing order
+		[[nodiscard]] auto weights(id_type src, id_type dst) const -> std::vector<E> {
+			if (not has_edge(src, dst)) {
+				return {};
+			}
+			auto const c = cell(src, dst);
+			auto result = std::vector<E>{weights_[c]};
+			if (auto const it = overflow_.find(c); it != overflow_.end()) {
+				result.insert(result.end(), it->second.begin(), it->second.end());
+			}
+			return result;
+		}
+
+		// Targets of the edges out of id, in increasing order, each listed once
+		[[nodiscard]] auto neighbours(id_type id) const -> std::vector<id_type> {
+			return to_ids(row(id));
+		}
+
+		// Bitset of the targets of id, with bit v % 64 of word v / 64 standing for target v
+		[[nodiscard]] auto row(id_type id) const noexcept -> std::span<std::uint64_t const> {
+			return {rows_.data() + id * words_, words_};
+		}
+
+		// Neighbourhood operations
+		//
+		// Each is a single pass over two rows, n / 256 AVX2 operations when the CPU supports them.
+
+		[[nodiscard]] auto common_neighbours(id_type a, id_type b) const -> std::vector<id_type> {
+			return combine(a, b, detail::simd::bit_and{});
+		}
+
+		[[nodiscard]] auto common_neighbour_count(id_type a, id_type b) const noexcept
+		   -> std::size_t {
+			return detail::simd::bitset_count(row(a).data(),
+			                                  row(b).data(),
+			                                  words_,
+			                                  detail::simd::bit_and{});
+		}
+
+		[[nodiscard]] auto neighbourhood_union(id_type a, id_type b) const -> std::vector<id_type> {
+			return combine(a, b, detail::simd::bit_or{});
+		}
+
+		[[nodiscard]] auto neighbourhood_union_count(id_type a, id_type b) const noexcept
+		   -> std::size_t {
+			return detail::simd::bitset_count(row(a).data(),
+			                                  row(b).data(),
+			                                  words_,
+			                                  detail::simd::bit_or{});
+		}
+
+		// Memory owned by the dense graph, counting every node value as sizeof(N)
+		[[nodiscard]] auto bytes_used() const noexcept -> std::size_t {
+			auto overflow = std::size_t{0};
+			for (auto const& [c, rest] : overflow_) {
+				overflow += sizeof(c) + rest.size() * sizeof(E);
+			}
+			return nodes_.size() * sizeof(N) + permutation_.size() * sizeof(id_type)
+			       + rows_.size() * sizeof(std::uint64_t) + weights_.size() * sizeof(E)
+			       + degrees_.size() * sizeof(std::size_t) + overflow;
+		}
+
+	private:
+		static constexpr auto word_bits = std::size_t{64};
+		static constexpr auto block_bits = std::size_t{256}; // One AVX2 register
+
+		static auto bit(id_type v) noexcept -> std::uint64_t {
+			return std::uint64_t{1} << (v % word_bits);
+		}
+
+		auto cell(id_type src, id_type dst) const noexcept -> std::size_t {
+			return std::size_t{src} * nodes_.size() + dst;
+		}
+
+		auto check_ids(id_type src, id_type dst, char const* function) const -> void {
+			if (src >= nodes_.size() or dst >= nodes_.size()) {
+				throw std::runtime_error(std::string("Cannot call gdwg::dense_graph<N, E>::") + function
+				                         + " if src or dst node don't exist in the graph");
+			}
+		}
+
+		template<typename Op>
+		auto combine(id_type a, id_type b, Op op) const -> std::vector<id_type> {
+			auto bits = std::vector<std::uint64_t>(words_);
+			detail::simd::bitset_apply(bits.data(), row(a).data(), row(b).data(), words_, op);
+			return to_ids(bits);
+		}
+
+		static auto to_ids(std::span<std::uint64_t const> bits) -> std::vector<id_type> {
+			auto result = std::vector<id_type>();
+			for (auto w = std::size_t{0}; w < bits.size(); ++w) {
+				for (auto word = bits[w]; word != 0; word &= word - 1) {
+					auto const offset = static_cast<std::size_t>(std::countr_zero(word));
+					result.push_back(static_cast<id_type>(w * word_bits + offset));
+				}
+			}
+			return result;
+		}
+
+		std::vector<N> nodes_;
+		std::vector<id_type> permutation_; // Empty for ordering::natural
+		std::size_t words_ = 0; // Words per row
+		std::vector<std::uint64_t> rows_;
+		std::vector<E> weights_; // Smallest weight of each edge, row-major
+		std::map<std::size_t, std::vector<E>> overflow_; // Other weights of parallel edges, sorted
+		std::vector<std::size_t> degrees_;
+		std::size_t num_edges_ = 0;
+	};
+
+	template<typename N, typename E>
+	dense_graph(graph<N, E> const&) -> dense_graph<N, E>;
+
+	template<typename N, typename E>
+	dense_graph(snapshot<N, E> const&) -> dense_graph<N, E>;
+} // namespace gdwg
+
+#endif // GDWG_DENSE_GRAPH_HPP
@@ -0,0 +1,33 @@
+#ifndef GDWG_DETAIL_CRC32_HPP
+#define GDWG_DETAIL_CRC32_HPP
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace gdwg::detail {
+	// CRC-32 as used by zlib and Ethernet (reflected polynomial 0xedb88320), one table lookup per
+	// byte. Passing the result of one call as crc continues the checksum over more bytes.
+	inline constexpr auto crc32_table = [] {
+		auto table = std::array<std::uint32_t, 256>{};
+		for (auto i = std::uint32_t{0}; i < 256; ++i) {
+			auto crc = i;
+			for (auto bit = 0; bit < 8; ++bit) {
+				crc = (crc & 1U) != 0 ? (crc >> 1U) ^ 0xedb88320U : crc >> 1U;
+			}
+			table[i] = crc;
+		}
+		return table;
+	}();
+
+	[[nodiscard]] inline auto crc32(std::string_view bytes, std::uint32_t crc = 0) noexcept
+	   -> std::uint32_t {
+		crc = ~crc;
+		for (auto const c : bytes) {
+			crc = crc32_table[(crc ^ static_cast<unsigned char>(c)) & 0xffU] ^ (crc >> 8U);
+		}
+		return ~crc;
+	}
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_CRC32_HPP
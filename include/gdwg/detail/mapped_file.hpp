@@ -0,0 +1,131 @@
+#ifndef GDWG_DETAIL_MAPPED_FILE_HPP
+#define GDWG_DETAIL_MAPPED_FILE_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <utility>
+
+namespace gdwg::detail {
+	// A read-only memory map of a whole file. Pages are read from disk on first access and, being
+	// clean, can be dropped again under memory pressure, so mappings may add up to far more than
+	// RAM. A file that can't be mapped leaves the mapping closed.
+	class mapped_file {
+	public:
+		mapped_file() = default;
+
+		explicit mapped_file(std::filesystem::path const& file) {
+			auto const fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0) {
+				return;
+			}
+			struct stat status = {};
+			if (::fstat(fd, &status) == 0) {
+				auto const size = static_cast<std::size_t>(status.st_size);
+				if (size == 0) {
+					open_ = true;
+				}
+				else if (auto* const address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+				         address != MAP_FAILED)
+				{
+					data_ = static_cast<char const*>(address);
+					size_ = size;
+					open_ = true;
+				}
+			}
+			::close(fd); // The mapping keeps the file open
+		}
+
+		mapped_file(mapped_file&& other) noexcept
+		: data_(std::exchange(other.data_, nullptr))
+		, size_(std::exchange(other.size_, 0))
+		, open_(std::exchange(other.open_, false)) {}
+
+		auto operator=(mapped_file&& other) noexcept -> mapped_file& {
+			if (this != &other) {
+				unmap();
+				data_ = std::exchange(other.data_, nullptr);
+				size_ = std::exchange(other.size_, 0);
+				open_ = std::exchange(other.open_, false);
+			}
+			return *this;
+		}
+
+		~mapped_file() {
+			unmap();
+		}
+
+		[[nodiscard]] auto is_open() const noexcept -> bool {
+			return open_;
+		}
+
+		[[nodiscard]] auto data() const noexcept -> char const* {
+			return data_;
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t {
+			return size_;
+		}
+
+		// Hints to the kernel; neither changes what the mapping reads as
+
+		// Starts reading the whole file in the background
+		auto will_need() const noexcept -> void {
+			advise(MADV_WILLNEED);
+		}
+
+		// Reads ahead aggressively and drops pages soon after they are read
+		auto sequential() const noexcept -> void {
+			advise(MADV_SEQUENTIAL);
+		}
+
+		// Drops the pages from this process, which reads them from the page cache or the disk again
+		// if they are used later
+		auto release() const noexcept -> void {
+			advise(MADV_DONTNEED);
+		}
+
+		// As above, for the pages holding the bytes [offset, offset + length) only
+
+		auto will_need(std::size_t offset, std::size_t length) const noexcept -> void {
+			advise(MADV_WILLNEED, offset, length);
+		}
+
+		auto release(std::size_t offset, std::size_t length) const noexcept -> void {
+			advise(MADV_DONTNEED, offset, length);
+		}
+
+	private:
+		auto advise(int advice) const noexcept -> void {
+			advise(advice, 0, size_);
+		}
+
+		auto advise(int advice, std::size_t offset, std::size_t length) const noexcept -> void {
+			if (data_ == nullptr or offset >= size_ or length == 0) {
+				return;
+			}
+			// madvise() takes a page-aligned start, and rounds the length up to whole pages itself
+			auto const page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+			auto const first = offset / page * page;
+			auto const last = std::min(offset + length, size_);
+			::madvise(const_cast<char*>(data_) + first, last - first, advice);
+		}
+
+		auto unmap() noexcept -> void {
+			if (data_ != nullptr) {
+				::munmap(const_cast<char*>(data_), size_);
+			}
+		}
+
+		char const* data_ = nullptr;
+		std::size_t size_ = 0;
+		bool open_ = false;
+	};
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_MAPPED_FILE_HPP
@@ -0,0 +1,86 @@
+#ifndef GDWG_DETAIL_PARALLEL_HPP
+#define GDWG_DETAIL_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace gdwg::detail {
+	// Resolves a requested number of threads, where 0 means one per hardware thread
+	inline auto thread_count(std::size_t threads) noexcept -> std::size_t {
+		if (threads == 0) {
+			threads = std::thread::hardware_concurrency();
+		}
+		return std::max<std::size_t>(threads, 1);
+	}
+
+	// Per-thread accumulator padded to its own cache line to avoid false sharing
+	template<typename T>
+	struct alignas(64) padded {
+		T value{};
+	};
+
+	// Calls f(i, worker) for every i in [0, n), where worker is in [0, thread_count(threads)).
+	// Indices are handed out in chunks from a shared counter, so skewed workloads such as
+	// power-law degree distributions stay balanced. The first exception thrown by any worker
+	// stops the loop and is rethrown on the calling thread.
+	template<typename F>
+	auto parallel_for(std::size_t n, std::size_t threads, F&& f, std::size_t chunk = 64) -> void {
+		chunk = std::max<std::size_t>(chunk, 1);
+		threads = std::min(thread_count(threads), (n + chunk - 1) / chunk);
+		if (threads <= 1) {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				f(i, std::size_t{0});
+			}
+			return;
+		}
+
+		auto next = std::atomic<std::size_t>{0};
+		auto error = std::exception_ptr{};
+		auto error_mutex = std::mutex{};
+		auto work = [&](std::size_t worker) {
+			try {
+				for (;;) {
+					auto const begin = next.fetch_add(chunk, std::memory_order_relaxed);
+					if (begin >= n) {
+						return;
+					}
+					auto const end = std::min(begin + chunk, n);
+					for (auto i = begin; i < end; ++i) {
+						f(i, worker);
+					}
+				}
+			} catch (...) {
+				auto const lock = std::scoped_lock(error_mutex);
+				if (not error) {
+					error = std::current_exception();
+				}
+				next.store(n, std::memory_order_relaxed);
+			}
+		};
+
+		auto pool = std::vector<std::thread>();
+		pool.reserve(threads - 1);
+		for (auto worker = std::size_t{1}; worker < threads; ++worker) {
+			try {
+				pool.emplace_back(work, worker);
+			} catch (std::system_error const&) {
+				break; // Remaining chunks are picked up by the threads already running
+			}
+		}
+		work(0);
+		for (auto& thread : pool) {
+			thread.join();
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_PARALLEL_HPP
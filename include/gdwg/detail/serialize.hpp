@@ -0,0 +1,134 @@
+#ifndef GDWG_DETAIL_SERIALIZE_HPP
+#define GDWG_DETAIL_SERIALIZE_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Binary serialisation of trivially copyable values, strings and vectors of either, in the
+// byte order of the machine that wrote them. Sizes are written as 64-bit counts. A reader
+// stops at the first failed read and reports it through ok(), so a caller checks once at the
+// end rather than after every value; a corrupt count never allocates more than the stream can
+// actually provide.
+namespace gdwg::detail::serialize {
+	template<typename T>
+	concept trivial = std::is_trivially_copyable_v<T>;
+
+	template<typename T>
+	concept serializable = trivial<T> or std::same_as<T, std::string>;
+
+	// Written after a format's magic, so that a file from a machine with another byte order is
+	// rejected instead of misread
+	inline constexpr auto byte_order_mark = std::uint32_t{0x01020304};
+
+	class writer {
+	public:
+		explicit writer(std::ostream& os) noexcept
+		: os_{os} {}
+
+		template<trivial T>
+		auto write(T const& value) -> void {
+			os_.write(reinterpret_cast<char const*>(&value), sizeof(T));
+		}
+
+		auto write(std::string const& value) -> void {
+			write(static_cast<std::uint64_t>(value.size()));
+			os_.write(value.data(), static_cast<std::streamsize>(value.size()));
+		}
+
+		template<serializable T>
+		auto write(std::vector<T> const& values) -> void {
+			write(static_cast<std::uint64_t>(values.size()));
+			if constexpr (trivial<T>) {
+				os_.write(reinterpret_cast<char const*>(values.data()),
+				          static_cast<std::streamsize>(values.size() * sizeof(T)));
+			}
+			else {
+				for (auto const& value : values) {
+					write(value);
+				}
+			}
+		}
+
+		[[nodiscard]] auto ok() const -> bool {
+			return static_cast<bool>(os_);
+		}
+
+	private:
+		std::ostream& os_;
+	};
+
+	class reader {
+	public:
+		explicit reader(std::istream& is) noexcept
+		: is_{is} {}
+
+		template<trivial T>
+		auto read(T& value) -> void {
+			if (ok_) {
+				ok_ = static_cast<bool>(is_.read(reinterpret_cast<char*>(&value), sizeof(T)));
+			}
+		}
+
+		auto read(std::string& value) -> void {
+			auto size = std::uint64_t{0};
+			read(size);
+			value.clear();
+			// Grows in bounded steps, so a corrupt size fails at the end of the stream
+			while (ok_ and value.size() < size) {
+				auto const step =
+				   static_cast<std::size_t>(std::min<std::uint64_t>(size - value.size(), chunk));
+				auto const start = value.size();
+				value.resize(start + step);
+				ok_ = static_cast<bool>(
+				   is_.read(value.data() + start, static_cast<std::streamsize>(step)));
+			}
+		}
+
+		template<serializable T>
+		auto read(std::vector<T>& values) -> void {
+			auto size = std::uint64_t{0};
+			read(size);
+			values.clear();
+			while (ok_ and values.size() < size) {
+				auto const limit = std::max<std::size_t>(chunk / sizeof(T), 1);
+				auto const step =
+				   static_cast<std::size_t>(std::min<std::uint64_t>(size - values.size(), limit));
+				auto const start = values.size();
+				values.resize(start + step);
+				if constexpr (trivial<T>) {
+					ok_ = static_cast<bool>(is_.read(reinterpret_cast<char*>(values.data() + start),
+					                                 static_cast<std::streamsize>(step * sizeof(T))));
+				}
+				else {
+					for (auto i = start; i < start + step; ++i) {
+						read(values[i]);
+					}
+				}
+			}
+		}
+
+		[[nodiscard]] auto ok() const noexcept -> bool {
+			return ok_;
+		}
+
+		// Marks the input as invalid, for checks made by the caller
+		auto fail() noexcept -> void {
+			ok_ = false;
+		}
+
+	private:
+		static constexpr auto chunk = std::size_t{1} << 20U;
+
+		std::istream& is_;
+		bool ok_ = true;
+	};
+} // namespace gdwg::detail::serialize
+
+#endif // GDWG_DETAIL_SERIALIZE_HPP
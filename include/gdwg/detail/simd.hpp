@@ -0,0 +1,414 @@
+#ifndef GDWG_DETAIL_SIMD_HPP
+#define GDWG_DETAIL_SIMD_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define GDWG_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define GDWG_SIMD_X86 0
+#endif
+
+// Kernels are compiled for several instruction sets through target attributes and the best one
+// supported by the running CPU is picked at runtime, so the library still builds for the
+// baseline architecture without -mavx2.
+namespace gdwg::detail::simd {
+	enum class isa { scalar, sse2, avx2 };
+
+	[[nodiscard]] inline auto best_isa() noexcept -> isa {
+		static auto const best = [] {
+#if GDWG_SIMD_X86
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2")) {
+				return isa::avx2;
+			}
+			if (__builtin_cpu_supports("sse2")) {
+				return isa::sse2;
+			}
+#endif
+			return isa::scalar;
+		}();
+		return best;
+	}
+
+	[[nodiscard]] inline auto is_supported(isa level) noexcept -> bool {
+		return level <= best_isa();
+	}
+
+	// Sorted-set intersection size
+	//
+	// Both inputs must be strictly increasing. The vector kernels compare a block of one list
+	// against every rotation of a block of the other, then advance whichever block has the
+	// smaller maximum, so each common element is counted exactly once.
+
+	[[nodiscard]] inline auto intersect_count_scalar(std::uint32_t const* a,
+	                                                 std::size_t na,
+	                                                 std::uint32_t const* b,
+	                                                 std::size_t nb) noexcept -> std::size_t {
+		auto count = std::size_t{0};
+		auto i = std::size_t{0};
+		auto j = std::size_t{0};
+		while (i < na and j < nb) {
+			if (a[i] < b[j]) {
+				++i;
+			}
+			else if (b[j] < a[i]) {
+				++j;
+			}
+			else {
+				++count;
+				++i;
+				++j;
+			}
+		}
+		return count;
+	}
+
+#if GDWG_SIMD_X86
+	__attribute__((target("sse2"))) inline auto intersect_count_sse2(std::uint32_t const* a,
+	                                                                std::size_t na,
+	                                                                std::uint32_t const* b,
+	                                                                std::size_t nb) noexcept
+	   -> std::size_t {
+		auto count = std::size_t{0};
+		auto i = std::size_t{0};
+		auto j = std::size_t{0};
+		while (i + 4 <= na and j + 4 <= nb) {
+			auto const va = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a + i));
+			auto const vb = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b + j));
+			auto const rot1 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+			auto const rot2 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2));
+			auto const rot3 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3));
+			auto const matches =
+			   _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, rot1)),
+			                _mm_or_si128(_mm_cmpeq_epi32(va, rot2), _mm_cmpeq_epi32(va, rot3)));
+			auto const mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(matches)));
+			count += static_cast<std::size_t>(__builtin_popcount(mask));
+
+			auto const a_max = a[i + 3];
+			auto const b_max = b[j + 3];
+			if (a_max <= b_max) {
+				i += 4;
+			}
+			if (b_max <= a_max) {
+				j += 4;
+			}
+		}
+		return count + intersect_count_scalar(a + i, na - i, b + j, nb - j);
+	}
+
+	__attribute__((target("avx2"))) inline auto intersect_count_avx2(std::uint32_t const* a,
+	                                                                std::size_t na,
+	                                                                std::uint32_t const* b,
+	                                                                std::size_t nb) noexcept
+	   -> std::size_t {
+		auto const rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+		auto count = std::size_t{0};
+		auto i = std::size_t{0};
+		auto j = std::size_t{0};
+		while (i + 8 <= na and j + 8 <= nb) {
+			auto const va = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i));
+			auto vb = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + j));
+			auto matches = _mm256_cmpeq_epi32(va, vb);
+			for (auto r = 1; r < 8; ++r) {
+				vb = _mm256_permutevar8x32_epi32(vb, rotate);
+				matches = _mm256_or_si256(matches, _mm256_cmpeq_epi32(va, vb));
+			}
+			auto const mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(matches)));
+			count += static_cast<std::size_t>(__builtin_popcount(mask));
+
+			auto const a_max = a[i + 7];
+			auto const b_max = b[j + 7];
+			if (a_max <= b_max) {
+				i += 8;
+			}
+			if (b_max <= a_max) {
+				j += 8;
+			}
+		}
+		return count + intersect_count_sse2(a + i, na - i, b + j, nb - j);
+	}
+#endif
+
+	[[nodiscard]] inline auto intersect_count(std::uint32_t const* a,
+	                                          std::size_t na,
+	                                          std::uint32_t const* b,
+	                                          std::size_t nb,
+	                                          isa level = best_isa()) noexcept -> std::size_t {
+#if GDWG_SIMD_X86
+		switch (level) {
+		case isa::avx2: return intersect_count_avx2(a, na, b, nb);
+		case isa::sse2: return intersect_count_sse2(a, na, b, nb);
+		case isa::scalar: break;
+		}
+#else
+		static_cast<void>(level);
+#endif
+		return intersect_count_scalar(a, na, b, nb);
+	}
+
+	// Reductions over contiguous arithmetic arrays
+	//
+	// The portable kernels keep one accumulator per lane of a 256-bit register, which lets the
+	// compiler vectorise them without reassociating floating-point additions itself. The AVX2
+	// versions are the same code compiled for AVX2. Results of floating-point sums may differ in
+	// the last bits from a sequential sum. The AVX2 wrappers are flattened, which inlines the
+	// portable kernel and everything it calls into them, so it is really compiled for AVX2 rather
+	// than called as the baseline code it would otherwise be emitted as.
+
+	template<typename T>
+	inline constexpr auto lanes = sizeof(T) >= 32 ? std::size_t{1} : std::size_t{32} / sizeof(T);
+
+	template<typename T>
+	[[nodiscard]] inline auto reduce_sum_portable(T const* values, std::size_t n) noexcept -> T {
+		auto acc = std::array<T, lanes<T>>{};
+		auto i = std::size_t{0};
+		for (; i + lanes<T> <= n; i += lanes<T>) {
+			for (auto k = std::size_t{0}; k < lanes<T>; ++k) {
+				acc[k] = static_cast<T>(acc[k] + values[i + k]);
+			}
+		}
+		auto total = T{};
+		for (auto k = std::size_t{0}; k < lanes<T>; ++k) {
+			total = static_cast<T>(total + acc[k]);
+		}
+		for (; i < n; ++i) {
+			total = static_cast<T>(total + values[i]);
+		}
+		return total;
+	}
+
+	// Requires n > 0. Less selects the minimum, greater selects the maximum.
+	template<typename T, typename Compare>
+	[[nodiscard]] inline auto
+	reduce_extreme_portable(T const* values, std::size_t n, Compare better) noexcept -> T {
+		auto acc = std::array<T, lanes<T>>{};
+		acc.fill(values[0]);
+		auto i = std::size_t{0};
+		for (; i + lanes<T> <= n; i += lanes<T>) {
+			for (auto k = std::size_t{0}; k < lanes<T>; ++k) {
+				acc[k] = better(values[i + k], acc[k]) ? values[i + k] : acc[k];
+			}
+		}
+		auto result = acc[0];
+		for (auto k = std::size_t{1}; k < lanes<T>; ++k) {
+			result = better(acc[k], result) ? acc[k] : result;
+		}
+		for (; i < n; ++i) {
+			result = better(values[i], result) ? values[i] : result;
+		}
+		return result;
+	}
+
+#if GDWG_SIMD_X86
+	template<typename T>
+	__attribute__((target("avx2"), flatten)) inline auto
+	reduce_sum_avx2(T const* values, std::size_t n) noexcept -> T {
+		return reduce_sum_portable(values, n);
+	}
+
+	template<typename T, typename Compare>
+	__attribute__((target("avx2"), flatten)) inline auto
+	reduce_extreme_avx2(T const* values, std::size_t n, Compare better) noexcept -> T {
+		return reduce_extreme_portable(values, n, better);
+	}
+#endif
+
+	template<typename T>
+	[[nodiscard]] inline auto
+	reduce_sum(T const* values, std::size_t n, isa level = best_isa()) noexcept -> T {
+#if GDWG_SIMD_X86
+		if (level == isa::avx2) {
+			return reduce_sum_avx2(values, n);
+		}
+#else
+		static_cast<void>(level);
+#endif
+		return reduce_sum_portable(values, n);
+	}
+
+	template<typename T, typename Compare>
+	[[nodiscard]] inline auto reduce_extreme(T const* values,
+	                                         std::size_t n,
+	                                         Compare better,
+	                                         isa level = best_isa()) noexcept -> T {
+#if GDWG_SIMD_X86
+		if (level == isa::avx2) {
+			return reduce_extreme_avx2(values, n, better);
+		}
+#else
+		static_cast<void>(level);
+#endif
+		return reduce_extreme_portable(values, n, better);
+	}
+
+	// Bitset rows
+	//
+	// Word-wise AND and OR of two equally long bitsets, either counting the set bits of the
+	// result or writing it out. As with the reductions, the AVX2 versions are the portable code
+	// compiled for AVX2 (and POPCNT), which the compiler turns into 256-bit logic operations.
+
+	template<typename Op>
+	[[nodiscard]] inline auto bitset_count_portable(std::uint64_t const* a,
+	                                                std::uint64_t const* b,
+	                                                std::size_t words,
+	                                                Op op) noexcept -> std::size_t {
+		auto count = std::size_t{0};
+		for (auto i = std::size_t{0}; i < words; ++i) {
+			count += static_cast<std::size_t>(std::popcount(op(a[i], b[i])));
+		}
+		return count;
+	}
+
+	template<typename Op>
+	inline auto bitset_apply_portable(std::uint64_t* out,
+	                                  std::uint64_t const* a,
+	                                  std::uint64_t const* b,
+	                                  std::size_t words,
+	                                  Op op) noexcept -> void {
+		for (auto i = std::size_t{0}; i < words; ++i) {
+			out[i] = op(a[i], b[i]);
+		}
+	}
+
+#if GDWG_SIMD_X86
+	template<typename Op>
+	__attribute__((target("avx2,popcnt"), flatten)) inline auto
+	bitset_count_avx2(std::uint64_t const* a,
+	                  std::uint64_t const* b,
+	                  std::size_t words,
+	                  Op op) noexcept -> std::size_t {
+		return bitset_count_portable(a, b, words, op);
+	}
+
+	template<typename Op>
+	__attribute__((target("avx2"), flatten)) inline auto bitset_apply_avx2(std::uint64_t* out,
+	                                                                      std::uint64_t const* a,
+	                                                                      std::uint64_t const* b,
+	                                                                      std::size_t words,
+	                                                                      Op op) noexcept -> void {
+		bitset_apply_portable(out, a, b, words, op);
+	}
+#endif
+
+	struct bit_and {
+		auto operator()(std::uint64_t lhs, std::uint64_t rhs) const noexcept -> std::uint64_t {
+			return lhs & rhs;
+		}
+	};
+
+	struct bit_or {
+		auto operator()(std::uint64_t lhs, std::uint64_t rhs) const noexcept -> std::uint64_t {
+			return lhs | rhs;
+		}
+	};
+
+	// Number of set bits in op(a, b), for op bit_and or bit_or
+	template<typename Op>
+	[[nodiscard]] inline auto bitset_count(std::uint64_t const* a,
+	                                       std::uint64_t const* b,
+	                                       std::size_t words,
+	                                       Op op,
+	                                       isa level = best_isa()) noexcept -> std::size_t {
+#if GDWG_SIMD_X86
+		if (level == isa::avx2) {
+			return bitset_count_avx2(a, b, words, op);
+		}
+#else
+		static_cast<void>(level);
+#endif
+		return bitset_count_portable(a, b, words, op);
+	}
+
+	// Writes op(a, b) to out, which may alias a or b
+	template<typename Op>
+	inline auto bitset_apply(std::uint64_t* out,
+	                         std::uint64_t const* a,
+	                         std::uint64_t const* b,
+	                         std::size_t words,
+	                         Op op,
+	                         isa level = best_isa()) noexcept -> void {
+#if GDWG_SIMD_X86
+		if (level == isa::avx2) {
+			bitset_apply_avx2(out, a, b, words, op);
+			return;
+		}
+#else
+		static_cast<void>(level);
+#endif
+		bitset_apply_portable(out, a, b, words, op);
+	}
+
+	// Min-plus tile update
+	//
+	// c[i][j] = min(c[i][j], a[i][k] + b[k][j]) for i, j, k < Tile, the inner loops of blocked
+	// Floyd-Warshall, over tiles whose rows are stride elements apart. k is outermost, so c may be
+	// a or b itself. Rows whose a[i][k] satisfies skip are left alone, and sums below lowest are
+	// raised to it. The AVX2 version is the portable loop compiled for AVX2, which keeps the whole
+	// tile in one function rather than dispatching once per row.
+
+	template<std::size_t Tile, typename T, typename Skip>
+	inline auto min_plus_tile_portable(T* c,
+	                                   T const* a,
+	                                   T const* b,
+	                                   std::size_t stride,
+	                                   T lowest,
+	                                   Skip skip) noexcept -> void {
+		// Row k of b is copied out, so the compiler knows it can't alias the row being updated
+		auto b_row = std::array<T, Tile>();
+		for (auto k = std::size_t{0}; k < Tile; ++k) {
+			std::copy_n(b + k * stride, Tile, b_row.begin());
+			for (auto i = std::size_t{0}; i < Tile; ++i) {
+				auto const a_ik = a[i * stride + k];
+				if (skip(a_ik)) {
+					continue;
+				}
+				auto* const c_row = c + i * stride;
+				for (auto j = std::size_t{0}; j < Tile; ++j) {
+					auto const sum = static_cast<T>(a_ik + b_row[j]);
+					auto const through = sum < lowest ? lowest : sum;
+					c_row[j] = through < c_row[j] ? through : c_row[j];
+				}
+			}
+		}
+	}
+
+#if GDWG_SIMD_X86
+	template<std::size_t Tile, typename T, typename Skip>
+	__attribute__((target("avx2"), flatten)) inline auto
+	min_plus_tile_avx2(T* c,
+	                   T const* a,
+	                   T const* b,
+	                   std::size_t stride,
+	                   T lowest,
+	                   Skip skip) noexcept -> void {
+		min_plus_tile_portable<Tile>(c, a, b, stride, lowest, skip);
+	}
+#endif
+
+	template<std::size_t Tile, typename T, typename Skip>
+	inline auto min_plus_tile(T* c,
+	                          T const* a,
+	                          T const* b,
+	                          std::size_t stride,
+	                          T lowest,
+	                          Skip skip,
+	                          isa level = best_isa()) noexcept -> void {
+#if GDWG_SIMD_X86
+		if (level == isa::avx2) {
+			min_plus_tile_avx2<Tile>(c, a, b, stride, lowest, skip);
+			return;
+		}
+#else
+		static_cast<void>(level);
+#endif
+		min_plus_tile_portable<Tile>(c, a, b, stride, lowest, skip);
+	}
+} // namespace gdwg::detail::simd
+
+#endif // GDWG_DETAIL_SIMD_HPP
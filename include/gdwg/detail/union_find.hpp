@@ -0,0 +1,62 @@
+#ifndef GDWG_DETAIL_UNION_FIND_HPP
+#define GDWG_DETAIL_UNION_FIND_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gdwg::detail {
+	// Disjoint sets of [0, n) that any number of threads may find() and unite() at once, without
+	// locks. A root is only ever linked under a root with a lower index, so concurrent links can
+	// never form a cycle, and find() halves the path it walks with a compare-and-swap that is
+	// allowed to fail.
+	class concurrent_union_find {
+	public:
+		explicit concurrent_union_find(std::size_t n)
+		: parent_(n) {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				parent_[i].store(static_cast<std::uint32_t>(i), std::memory_order_relaxed);
+			}
+		}
+
+		[[nodiscard]] auto find(std::uint32_t x) noexcept -> std::uint32_t {
+			for (;;) {
+				auto parent = parent_[x].load(std::memory_order_acquire);
+				if (parent == x) {
+					return x;
+				}
+				auto const grandparent = parent_[parent].load(std::memory_order_acquire);
+				if (parent != grandparent) {
+					parent_[x].compare_exchange_weak(parent, grandparent, std::memory_order_acq_rel);
+				}
+				x = grandparent;
+			}
+		}
+
+		// Merges the sets of a and b, returning false if they were already the same set
+		auto unite(std::uint32_t a, std::uint32_t b) noexcept -> bool {
+			for (;;) {
+				a = find(a);
+				b = find(b);
+				if (a == b) {
+					return false;
+				}
+				if (a < b) {
+					std::swap(a, b);
+				}
+				// a may have been linked since find() returned it, in which case try again
+				auto expected = a;
+				if (parent_[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) {
+					return true;
+				}
+			}
+		}
+
+	private:
+		std::vector<std::atomic<std::uint32_t>> parent_;
+	};
+} // namespace gdwg::detail
+
+#endif // GDWG_DETAIL_UNION_FIND_HPP
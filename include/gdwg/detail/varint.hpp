@@ -0,0 +1,179 @@
+#ifndef GDWG_DETAIL_VARINT_HPP
+#define GDWG_DETAIL_VARINT_HPP
+
+#include "gdwg/detail/simd.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Delta coding of sorted 32-bit integer lists.
+//
+// A list is stored as the differences between consecutive values, starting from a given base.
+// Whole groups of four differences use group varint: one tag byte holding the byte length of
+// each difference (two bits each), followed by the differences in 1 to 4 little-endian bytes.
+// Up to three trailing differences are stored as LEB128 varints. A group decodes with a single
+// shuffle on SSSE3, which may read up to 16 bytes past the group, so encoded buffers must be
+// followed by padding bytes.
+namespace gdwg::detail::varint {
+	inline constexpr auto group_size = std::size_t{4};
+	inline constexpr auto padding = std::size_t{16};
+
+	inline auto byte_length(std::uint32_t value) noexcept -> std::size_t {
+		if (value < (1U << 8U)) {
+			return 1;
+		}
+		if (value < (1U << 16U)) {
+			return 2;
+		}
+		return value < (1U << 24U) ? 3 : 4;
+	}
+
+	// Appends values[0, n), which must be non-decreasing and no smaller than base
+	inline auto encode(std::uint32_t const* values,
+	                   std::size_t n,
+	                   std::uint32_t base,
+	                   std::vector<std::uint8_t>& out) -> void {
+		auto previous = base;
+		auto i = std::size_t{0};
+		for (; i + group_size <= n; i += group_size) {
+			auto const tag = out.size();
+			out.push_back(0);
+			for (auto k = std::size_t{0}; k < group_size; ++k) {
+				auto delta = values[i + k] - previous;
+				previous = values[i + k];
+				auto const length = byte_length(delta);
+				out[tag] = static_cast<std::uint8_t>(out[tag] | ((length - 1) << (2 * k)));
+				for (auto b = std::size_t{0}; b < length; ++b) {
+					out.push_back(static_cast<std::uint8_t>(delta & 0xFFU));
+					delta >>= 8U;
+				}
+			}
+		}
+		for (; i < n; ++i) {
+			auto delta = values[i] - previous;
+			previous = values[i];
+			while (delta >= 0x80U) {
+				out.push_back(static_cast<std::uint8_t>((delta & 0x7FU) | 0x80U));
+				delta >>= 7U;
+			}
+			out.push_back(static_cast<std::uint8_t>(delta));
+		}
+	}
+
+	// Shuffle masks and data lengths of every group tag
+	struct group_table {
+		std::array<std::array<std::uint8_t, 16>, 256> shuffle;
+		std::array<std::uint8_t, 256> length;
+	};
+
+	inline constexpr auto make_group_table() -> group_table {
+		auto table = group_table{};
+		for (auto tag = std::size_t{0}; tag < 256; ++tag) {
+			auto source = std::size_t{0};
+			for (auto k = std::size_t{0}; k < group_size; ++k) {
+				auto const length = ((tag >> (2 * k)) & 3U) + 1;
+				for (auto b = std::size_t{0}; b < 4; ++b) {
+					// Bytes with the high bit set are zeroed by the shuffle
+					table.shuffle[tag][4 * k + b] =
+					   b < length ? static_cast<std::uint8_t>(source + b) : std::uint8_t{0x80};
+				}
+				source += length;
+			}
+			table.length[tag] = static_cast<std::uint8_t>(source);
+		}
+		return table;
+	}
+
+	inline constexpr auto groups = make_group_table();
+
+	inline auto decode_tail(std::uint8_t const* in,
+	                        std::size_t n,
+	                        std::uint32_t previous,
+	                        std::uint32_t* out) noexcept -> std::uint8_t const* {
+		for (auto i = std::size_t{0}; i < n; ++i) {
+			auto delta = std::uint32_t{0};
+			auto shift = 0U;
+			for (;;) {
+				auto const byte = *in++;
+				delta |= static_cast<std::uint32_t>(byte & 0x7FU) << shift;
+				if ((byte & 0x80U) == 0) {
+					break;
+				}
+				shift += 7;
+			}
+			previous += delta;
+			out[i] = previous;
+		}
+		return in;
+	}
+
+	// Decodes n values following base into out, returning the end of the encoded list
+	inline auto decode_scalar(std::uint8_t const* in,
+	                          std::size_t n,
+	                          std::uint32_t base,
+	                          std::uint32_t* out) noexcept -> std::uint8_t const* {
+		auto previous = base;
+		auto i = std::size_t{0};
+		for (; i + group_size <= n; i += group_size) {
+			auto const tag = *in++;
+			for (auto k = std::size_t{0}; k < group_size; ++k) {
+				auto const length = ((tag >> (2 * k)) & 3U) + 1;
+				auto delta = std::uint32_t{0};
+				for (auto b = std::size_t{0}; b < length; ++b) {
+					delta |= static_cast<std::uint32_t>(in[b]) << (8 * b);
+				}
+				in += length;
+				previous += delta;
+				out[i + k] = previous;
+			}
+		}
+		return decode_tail(in, n - i, previous, out + i);
+	}
+
+#if GDWG_SIMD_X86
+	__attribute__((target("ssse3"))) inline auto decode_ssse3(std::uint8_t const* in,
+	                                                         std::size_t n,
+	                                                         std::uint32_t base,
+	                                                         std::uint32_t* out) noexcept
+	   -> std::uint8_t const* {
+		auto previous = _mm_set1_epi32(static_cast<int>(base));
+		auto i = std::size_t{0};
+		for (; i + group_size <= n; i += group_size) {
+			auto const tag = *in;
+			auto const data = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + 1));
+			auto const mask =
+			   _mm_loadu_si128(reinterpret_cast<__m128i const*>(groups.shuffle[tag].data()));
+			auto deltas = _mm_shuffle_epi8(data, mask);
+			// Prefix sum of the four lanes, offset by the last value of the previous group
+			deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 4));
+			deltas = _mm_add_epi32(deltas, _mm_slli_si128(deltas, 8));
+			auto const values = _mm_add_epi32(deltas, previous);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), values);
+			previous = _mm_shuffle_epi32(values, _MM_SHUFFLE(3, 3, 3, 3));
+			in += 1 + groups.length[tag];
+		}
+		auto const last = static_cast<std::uint32_t>(_mm_cvtsi128_si32(previous));
+		return decode_tail(in, n - i, last, out + i);
+	}
+#endif
+
+	// The SSSE3 kernel is used whenever AVX2 is available, which implies SSSE3
+	inline auto decode(std::uint8_t const* in,
+	                   std::size_t n,
+	                   std::uint32_t base,
+	                   std::uint32_t* out,
+	                   simd::isa level = simd::best_isa()) noexcept -> std::uint8_t const* {
+#if GDWG_SIMD_X86
+		if (level == simd::isa::avx2) {
+			return decode_ssse3(in, n, base, out);
+		}
+#else
+		static_cast<void>(level);
+#endif
+		return decode_scalar(in, n, base, out);
+	}
+} // namespace gdwg::detail::varint
+
+#endif // GDWG_DETAIL_VARINT_HPP
@@ -0,0 +1,740 @@
+#ifndef GDWG_DURABLE_GRAPH_HPP
+#define GDWG_DURABLE_GRAPH_HPP
+
+#include "gdwg/detail/crc32.hpp"
+#include "gdwg/detail/serialize.hpp"
+#include "gdwg/graph.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A graph whose every mutation is recorded in a write-ahead log on disk, so that it outlives the
+// process. Opening a directory recovers the graph from the newest checkpoint in it and the log
+// written after that checkpoint; a record torn by a crash, and anything logged after it, is
+// ignored.
+//
+// The log is a series of segments: wal-<g> holds the mutations made after checkpoint-<g>. Once a
+// segment grows past checkpoint_bytes, a background thread starts the next segment and writes the
+// next checkpoint from the files alone (the previous checkpoint and the segments after it), so
+// writers wait only for the switch of segment, never for a checkpoint. Files older than a
+// checkpoint are deleted once it is on disk.
+//
+// With sync set, a mutation returns once its record is on disk. Records logged while the log is
+// being synced are written and synced together by the next mutation to wait (group commit), so
+// a mutation waits for at most two fsyncs however many threads are writing. Without sync, records
+// are written once max_buffered_bytes are waiting, on flush(), at a checkpoint, and when the
+// durable_graph is destroyed; a crash loses at most the records still buffered.
+//
+// A record is [u32 size][u32 crc32 of the payload][payload], and a payload is a u8 operation
+// followed by its arguments in the format of detail/serialize.hpp. Files use the byte order of
+// the machine that wrote them. Every member may be called from any thread.
+namespace gdwg {
+	struct durable_options {
+		bool sync = true;
+		std::size_t max_buffered_bytes = std::size_t{1} << 20U;
+		std::uint64_t checkpoint_bytes = std::uint64_t{64} << 20U; // 0 for only checkpoint()
+	};
+
+	struct durable_stats {
+		std::uint64_t mutations = 0; // Logged since the directory was opened
+		std::uint64_t syncs = 0; // fsyncs of the log
+		std::uint64_t checkpoints = 0;
+		std::uint64_t log_bytes = 0; // In the current segment
+	};
+
+	template<typename N, typename E>
+	requires detail::serialize::serializable<N> and detail::serialize::serializable<E>
+	class durable_graph {
+	public:
+		explicit durable_graph(std::filesystem::path directory, durable_options options = {})
+		: directory_(std::move(directory))
+		, options_(options) {
+			auto error = std::error_code();
+			std::filesystem::create_directories(directory_, error);
+			if (error) {
+				throw std::runtime_error("Cannot call gdwg::durable_graph<N, E>::durable_graph on a "
+				                         "directory that can't be written");
+			}
+			recover();
+			fd_ = create_segment(generation_);
+			checkpointer_ = std::thread([this] { run_checkpoints(); });
+		}
+
+		durable_graph(durable_graph const&) = delete;
+		auto operator=(durable_graph const&) -> durable_graph& = delete;
+
+		~durable_graph() {
+			{
+				auto const lock = std::lock_guard(checkpoint_mutex_);
+				stopping_ = true;
+			}
+			checkpoint_wanted_.notify_all();
+			checkpointer_.join();
+			try {
+				flush();
+			} catch (std::runtime_error const&) {
+				// Nothing can be reported from a destructor; the records are lost as in a crash
+			}
+			::close(fd_);
+		}
+
+		// The modifiers of graph, with the same results and exceptions. A mutation that throws, or
+		// changes nothing, isn't logged. A mutation that throws because the log can't be written
+		// stays applied in memory but isn't durable, and every later mutation throws without
+		// changing the graph.
+		auto insert_node(N const& value) -> bool {
+			return mutate(op::insert_node, [&] { return graph_.insert_node(value); }, value);
+		}
+
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			return mutate(
+			   op::insert_edge,
+			   [&] { return graph_.insert_edge(src, dst, weight); },
+			   src,
+			   dst,
+			   weight);
+		}
+
+		auto replace_node(N const& old_data, N const& new_data) -> bool {
+			return mutate(
+			   op::replace_node,
+			   [&] { return graph_.replace_node(old_data, new_data); },
+			   old_data,
+			   new_data);
+		}
+
+		auto merge_replace_node(N const& old_data, N const& new_data) -> void {
+			mutate(
+			   op::merge_replace_node,
+			   [&] {
+				   graph_.merge_replace_node(old_data, new_data);
+				   return true;
+			   },
+			   old_data,
+			   new_data);
+		}
+
+		auto erase_node(N const& value) -> bool {
+			return mutate(op::erase_node, [&] { return graph_.erase_node(value); }, value);
+		}
+
+		auto erase_edge(N const& src, N const& dst, E const& weight) -> bool {
+			return mutate(
+			   op::erase_edge,
+			   [&] { return graph_.erase_edge(src, dst, weight); },
+			   src,
+			   dst,
+			   weight);
+		}
+
+		auto clear() -> void {
+			mutate(op::clear, [&] {
+				graph_.clear();
+				return true;
+			});
+		}
+
+		// Calls f with the graph, which no mutation can change until f returns. Any number of
+		// threads can read at once.
+		template<std::invocable<graph<N, E> const&> F>
+		auto read(F&& f) const -> std::invoke_result_t<F, graph<N, E> const&> {
+			auto const lock = std::shared_lock(graph_mutex_);
+			return std::invoke(std::forward<F>(f), std::as_const(graph_));
+		}
+
+		// Writes and syncs every mutation made so far
+		auto flush() -> void {
+			auto lock = std::unique_lock(log_mutex_);
+			sync_to(lock, appended_);
+		}
+
+		// Starts a new segment and checkpoints everything logged before it, returning once the
+		// checkpoint is on disk. Also reports the failure of a background checkpoint.
+		auto checkpoint() -> void {
+			auto lock = std::unique_lock(checkpoint_mutex_);
+			auto const ticket = ++requested_;
+			checkpoint_wanted_.notify_all();
+			checkpoint_done_.wait(lock, [&] { return completed_ >= ticket; });
+			if (auto const error = std::exchange(checkpoint_error_, nullptr)) {
+				std::rethrow_exception(error);
+			}
+		}
+
+		[[nodiscard]] auto stats() const -> durable_stats {
+			auto const lock = std::lock_guard(log_mutex_);
+			return {mutations_, syncs_, checkpoints_, log_bytes_};
+		}
+
+		[[nodiscard]] auto directory() const noexcept -> std::filesystem::path const& {
+			return directory_;
+		}
+
+	private:
+		enum class op : std::uint8_t {
+			insert_node,
+			insert_edge,
+			replace_node,
+			merge_replace_node,
+			erase_node,
+			erase_edge,
+			clear,
+		};
+
+		static constexpr auto record_header = std::size_t{8}; // Size and checksum
+		static constexpr auto version = std::uint32_t{1};
+		static constexpr auto log_magic = std::array<char, 8>{'g', 'd', 'w', 'g', '-', 'w', 'a', 'l'};
+		static constexpr auto checkpoint_magic =
+		   std::array<char, 8>{'g', 'd', 'w', 'g', '-', 'c', 'k', 'p'};
+
+		static constexpr auto layout() noexcept -> std::array<std::uint32_t, 2> {
+			return {static_cast<std::uint32_t>(sizeof(N)), static_cast<std::uint32_t>(sizeof(E))};
+		}
+
+		// Applies a mutation and, if it changed the graph, logs it before any other mutation can
+		// run, so the log replays mutations in the order they were applied. The record is built
+		// first, so failing to build it leaves the graph alone. The wait for the record to reach
+		// the disk happens after the graph is unlocked.
+		template<typename Mutation, typename... Args>
+		auto mutate(op code, Mutation mutation, Args const&... args) -> bool {
+			auto const& entry = record(code, args...);
+			auto lock = std::unique_lock(graph_mutex_);
+			throw_if_log_failed();
+			if (not mutation()) {
+				return false;
+			}
+			auto const lsn = log(entry);
+			lock.unlock();
+			commit(lsn);
+			return true;
+		}
+
+		// The record of a mutation, in a buffer of the calling thread that is reused by its next
+		// mutation
+		template<typename... Args>
+		static auto record(op code, Args const&... args) -> std::string const& {
+			thread_local auto entry = std::string();
+			entry.assign(record_header, '\0');
+			put(entry, static_cast<std::uint8_t>(code));
+			(put(entry, args), ...);
+			auto const payload = std::string_view(entry).substr(record_header);
+			auto const size = static_cast<std::uint32_t>(payload.size());
+			auto const crc = detail::crc32(payload);
+			std::memcpy(entry.data(), &size, sizeof(size));
+			std::memcpy(entry.data() + sizeof(size), &crc, sizeof(crc));
+			return entry;
+		}
+
+		auto log(std::string const& entry) -> std::uint64_t {
+			auto const lock = std::lock_guard(log_mutex_);
+			buffer_.append(entry);
+			log_bytes_ += entry.size();
+			++mutations_;
+			if (options_.checkpoint_bytes != 0 and log_bytes_ >= options_.checkpoint_bytes
+			    and not checkpoint_due_)
+			{
+				checkpoint_due_ = true;
+				{
+					auto const wanted = std::lock_guard(checkpoint_mutex_);
+					due_ = true;
+				}
+				checkpoint_wanted_.notify_all();
+			}
+			return ++appended_;
+		}
+
+		auto commit(std::uint64_t lsn) -> void {
+			auto lock = std::unique_lock(log_mutex_);
+			if (options_.sync) {
+				sync_to(lock, lsn);
+			}
+			else if (buffer_.size() >= options_.max_buffered_bytes and not syncing_
+			         and not rotating_)
+			{
+				write_buffer(lock);
+			}
+		}
+
+		// Waits until record lsn is on disk, writing the buffer if no other thread is
+		auto sync_to(std::unique_lock<std::mutex>& lock, std::uint64_t lsn) -> void {
+			while (synced_ < lsn) {
+				throw_if_failed();
+				if (syncing_ or rotating_) {
+					synced_cv_.wait(lock);
+				}
+				else {
+					write_buffer(lock);
+				}
+			}
+		}
+
+		// Writes and syncs the buffer with the log unlocked, so that other threads keep logging
+		// into a second buffer meanwhile. With a next descriptor, records logged from now on go
+		// to it instead, and the current one is closed once the buffer is synced to it.
+		auto write_buffer(std::unique_lock<std::mutex>& lock, int next = -1) -> void {
+			syncing_ = true;
+			auto pending = std::exchange(buffer_, std::move(spare_));
+			buffer_.clear();
+			auto const target = appended_;
+			auto const fd = next < 0 ? fd_ : std::exchange(fd_, next);
+			lock.unlock();
+			auto const written = write_all(fd, pending) and ::fsync(fd) == 0;
+			if (next >= 0) {
+				::close(fd);
+			}
+			lock.lock();
+			pending.clear();
+			spare_ = std::move(pending);
+			syncing_ = false;
+			if (written) {
+				synced_ = target;
+				++syncs_;
+			}
+			else {
+				failed_ = true;
+			}
+			synced_cv_.notify_all();
+			throw_if_failed();
+		}
+
+		// A failed write leaves an unknown part of the records on disk, so nothing more is logged
+		auto throw_if_failed() const -> void {
+			if (failed_) {
+				throw std::runtime_error("Cannot write the log of a gdwg::durable_graph<N, E>");
+			}
+		}
+
+		auto throw_if_log_failed() const -> void {
+			auto const lock = std::lock_guard(log_mutex_);
+			throw_if_failed();
+		}
+
+		auto run_checkpoints() -> void {
+			auto lock = std::unique_lock(checkpoint_mutex_);
+			for (;;) {
+				checkpoint_wanted_.wait(lock, [&] { return stopping_ or due_ or requested_ > completed_; });
+				if (stopping_) {
+					return;
+				}
+				auto const serving = requested_;
+				due_ = false;
+				lock.unlock();
+				auto error = std::exception_ptr();
+				try {
+					write_checkpoint();
+				} catch (std::exception const&) {
+					error = std::current_exception();
+				}
+				lock.lock();
+				completed_ = serving;
+				if (error) {
+					checkpoint_error_ = error;
+				}
+				checkpoint_done_.notify_all();
+			}
+		}
+
+		auto write_checkpoint() -> void {
+			// Time complexity, for a checkpoint of n nodes and e edges after r logged records
+			//        load the previous checkpoint  - (n + e) log(n) +
+			//        replay the segments           - r log(n) +
+			//        write the new checkpoint      - (n + e) log(n)
+			//     = O((n + e + r) log(n)) solution, on the checkpointing thread only
+			auto const closed = rotate();
+			auto state = graph<N, E>();
+			if (has_checkpoint_) {
+				load_checkpoint(checkpoint_path(checkpoint_), state);
+			}
+			for (auto g = checkpoint_; g <= closed; ++g) {
+				replay(segment_path(g), g, state);
+			}
+			auto const next = closed + 1;
+			save_checkpoint(state, next);
+			checkpoint_ = next;
+			has_checkpoint_ = true;
+			remove_before(next);
+			auto const lock = std::lock_guard(log_mutex_);
+			++checkpoints_;
+		}
+
+		// Moves logging to a new segment, returning the generation of the one it closes, once
+		// every record of the closed segment is synced. The new file is created before the log
+		// is locked. No write of the buffer starts after this one asks for the log, so it waits
+		// for at most the write in progress and then its own, however fast records are logged;
+		// records logged meanwhile go to the new segment.
+		auto rotate() -> std::uint64_t {
+			auto const closed = generation_;
+			auto const next = create_segment(closed + 1);
+			auto lock = std::unique_lock(log_mutex_);
+			rotating_ = true;
+			synced_cv_.wait(lock, [&] { return not syncing_; });
+			rotating_ = false;
+			if (failed_) {
+				::close(next);
+				synced_cv_.notify_all();
+				throw_if_failed();
+			}
+			generation_ = closed + 1;
+			log_bytes_ = 0;
+			checkpoint_due_ = false;
+			write_buffer(lock, next);
+			return closed;
+		}
+
+		auto recover() -> void {
+			auto checkpoints = std::vector<std::uint64_t>();
+			auto segments = std::vector<std::uint64_t>();
+			for (auto const& entry : std::filesystem::directory_iterator(directory_)) {
+				auto const name = entry.path().filename().string();
+				if (name.ends_with(".tmp")) {
+					std::filesystem::remove(entry.path()); // A checkpoint interrupted by a crash
+				}
+				else if (auto const checkpoint = generation_of(name, "checkpoint-")) {
+					checkpoints.push_back(*checkpoint);
+				}
+				else if (auto const segment = generation_of(name, "wal-")) {
+					segments.push_back(*segment);
+				}
+			}
+			if (not checkpoints.empty()) {
+				checkpoint_ = *std::max_element(checkpoints.begin(), checkpoints.end());
+				has_checkpoint_ = true;
+				load_checkpoint(checkpoint_path(checkpoint_), graph_);
+			}
+			std::sort(segments.begin(), segments.end());
+			for (auto const g : segments) {
+				if (g >= checkpoint_) {
+					replay(segment_path(g), g, graph_);
+				}
+			}
+			// A new segment, so that records are never appended after a torn one
+			generation_ = has_checkpoint_ ? checkpoint_ : 0;
+			if (not segments.empty()) {
+				generation_ = std::max(generation_, segments.back() + 1);
+			}
+		}
+
+		static auto generation_of(std::string_view name, std::string_view prefix)
+		   -> std::optional<std::uint64_t> {
+			if (not name.starts_with(prefix)) {
+				return std::nullopt;
+			}
+			name.remove_prefix(prefix.size());
+			auto g = std::uint64_t{0};
+			auto const [end, error] = std::from_chars(name.data(), name.data() + name.size(), g);
+			if (error != std::errc() or end != name.data() + name.size()) {
+				return std::nullopt;
+			}
+			return g;
+		}
+
+		auto segment_path(std::uint64_t g) const -> std::filesystem::path {
+			return directory_ / ("wal-" + std::to_string(g));
+		}
+
+		auto checkpoint_path(std::uint64_t g) const -> std::filesystem::path {
+			return directory_ / ("checkpoint-" + std::to_string(g));
+		}
+
+		static auto segment_header(std::uint64_t g) -> std::string {
+			auto header = std::string();
+			put(header, log_magic);
+			put(header, version);
+			put(header, detail::serialize::byte_order_mark);
+			put(header, layout());
+			put(header, g);
+			return header;
+		}
+
+		// Applies the records of a segment, stopping at the first that is torn, fails its checksum
+		// or can't be applied. A missing segment, or one whose header never reached the disk, holds
+		// no records.
+		static auto replay(std::filesystem::path const& file, std::uint64_t g, graph<N, E>& state)
+		   -> void {
+			auto is = std::ifstream(file, std::ios::binary);
+			auto contents = std::string(std::istreambuf_iterator<char>(is), {});
+			auto const header = segment_header(g);
+			if (not std::string_view(contents).starts_with(header)) {
+				return;
+			}
+			auto position = header.size();
+			while (contents.size() - position >= record_header) {
+				auto size = std::uint32_t{0};
+				auto crc = std::uint32_t{0};
+				std::memcpy(&size, contents.data() + position, sizeof(size));
+				std::memcpy(&crc, contents.data() + position + sizeof(size), sizeof(crc));
+				position += record_header;
+				if (size > contents.size() - position) {
+					return;
+				}
+				auto const payload = std::string_view(contents).substr(position, size);
+				if (detail::crc32(payload) != crc or not apply(payload, state)) {
+					return;
+				}
+				position += size;
+			}
+		}
+
+		static auto apply(std::string_view payload, graph<N, E>& state) -> bool {
+			auto is = std::istringstream(std::string(payload));
+			auto in = detail::serialize::reader(is);
+			auto code = std::uint8_t{0};
+			auto src = N();
+			auto dst = N();
+			auto weight = E();
+			in.read(code);
+			switch (static_cast<op>(code)) {
+			case op::insert_node:
+			case op::erase_node: in.read(src); break;
+			case op::replace_node:
+			case op::merge_replace_node:
+				in.read(src);
+				in.read(dst);
+				break;
+			case op::insert_edge:
+			case op::erase_edge:
+				in.read(src);
+				in.read(dst);
+				in.read(weight);
+				break;
+			case op::clear: break;
+			default: in.fail();
+			}
+			if (not in.ok() or is.peek() != std::istringstream::traits_type::eof()) {
+				return false;
+			}
+			try {
+				switch (static_cast<op>(code)) {
+				case op::insert_node: state.insert_node(std::move(src)); break;
+				case op::insert_edge: state.insert_edge(src, dst, std::move(weight)); break;
+				case op::replace_node: state.replace_node(src, dst); break;
+				case op::merge_replace_node: state.merge_replace_node(src, dst); break;
+				case op::erase_node: state.erase_node(src); break;
+				case op::erase_edge: state.erase_edge(src, dst, weight); break;
+				case op::clear: state.clear(); break;
+				}
+			} catch (std::runtime_error const&) {
+				return false;
+			}
+			return true;
+		}
+
+		// A checkpoint holds the sorted nodes, then each edge as the positions of its nodes in
+		// them and its weight, in the order of graph::begin()
+		auto save_checkpoint(graph<N, E> const& state, std::uint64_t g) const -> void {
+			auto const file = checkpoint_path(g);
+			auto temporary = file;
+			temporary += ".tmp";
+			auto const nodes = state.nodes();
+			auto from = std::vector<std::uint64_t>();
+			auto to = std::vector<std::uint64_t>();
+			auto weights = std::vector<E>();
+			auto const position = [&](N const& value) {
+				return static_cast<std::uint64_t>(
+				   std::lower_bound(nodes.begin(), nodes.end(), value) - nodes.begin());
+			};
+			for (auto const& [src, dst, weight] : state) {
+				from.push_back(position(src));
+				to.push_back(position(dst));
+				weights.push_back(weight);
+			}
+			{
+				auto os = std::ofstream(temporary, std::ios::binary | std::ios::trunc);
+				auto out = detail::serialize::writer(os);
+				out.write(checkpoint_magic);
+				out.write(version);
+				out.write(detail::serialize::byte_order_mark);
+				out.write(layout());
+				out.write(nodes);
+				out.write(from);
+				out.write(to);
+				out.write(weights);
+				os.flush();
+				if (not os) {
+					throw std::runtime_error("Cannot call gdwg::durable_graph<N, E>::checkpoint on a "
+					                         "directory that can't be written");
+				}
+			}
+			auto synced = sync_file(temporary);
+			if (synced) {
+				auto error = std::error_code();
+				std::filesystem::rename(temporary, file, error);
+				synced = not error and sync_file(directory_);
+			}
+			if (not synced) {
+				throw std::runtime_error("Cannot call gdwg::durable_graph<N, E>::checkpoint on a "
+				                         "directory that can't be written");
+			}
+		}
+
+		static auto load_checkpoint(std::filesystem::path const& file, graph<N, E>& state) -> void {
+			auto is = std::ifstream(file, std::ios::binary);
+			auto in = detail::serialize::reader(is);
+			auto header = decltype(checkpoint_magic){};
+			auto file_version = std::uint32_t{0};
+			auto mark = std::uint32_t{0};
+			auto file_layout = decltype(layout()){};
+			auto nodes = std::vector<N>();
+			auto from = std::vector<std::uint64_t>();
+			auto to = std::vector<std::uint64_t>();
+			auto weights = std::vector<E>();
+			in.read(header);
+			in.read(file_version);
+			in.read(mark);
+			in.read(file_layout);
+			if (header != checkpoint_magic or file_version != version
+			    or mark != detail::serialize::byte_order_mark or file_layout != layout())
+			{
+				in.fail();
+			}
+			in.read(nodes);
+			in.read(from);
+			in.read(to);
+			in.read(weights);
+			auto const n = static_cast<std::uint64_t>(nodes.size());
+			auto const in_range = [n](std::uint64_t i) { return i < n; };
+			if (not in.ok() or from.size() != weights.size() or to.size() != weights.size()
+			    or not std::all_of(from.begin(), from.end(), in_range)
+			    or not std::all_of(to.begin(), to.end(), in_range))
+			{
+				throw std::runtime_error("Cannot call gdwg::durable_graph<N, E>::durable_graph on a "
+				                         "directory that doesn't hold a valid checkpoint");
+			}
+			state = graph<N, E>(nodes.begin(), nodes.end());
+			for (auto i = std::size_t{0}; i < weights.size(); ++i) {
+				state.insert_edge(nodes[from[i]], nodes[to[i]], std::move(weights[i]));
+			}
+		}
+
+		// Deletes the checkpoints and segments that a checkpoint of generation g replaces
+		auto remove_before(std::uint64_t g) const -> void {
+			for (auto const& entry : std::filesystem::directory_iterator(directory_)) {
+				auto const name = entry.path().filename().string();
+				auto generation = generation_of(name, "checkpoint-");
+				if (not generation) {
+					generation = generation_of(name, "wal-");
+				}
+				if (generation and *generation < g) {
+					auto error = std::error_code();
+					std::filesystem::remove(entry.path(), error);
+				}
+			}
+		}
+
+		// Creates an empty segment, synced along with its directory entry
+		auto create_segment(std::uint64_t g) const -> int {
+			auto const file = segment_path(g);
+			auto const fd = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+			if (fd < 0) {
+				throw std::runtime_error("Cannot write the log of a gdwg::durable_graph<N, E>");
+			}
+			if (not write_all(fd, segment_header(g)) or ::fsync(fd) != 0 or not sync_file(directory_)) {
+				::close(fd);
+				throw std::runtime_error("Cannot write the log of a gdwg::durable_graph<N, E>");
+			}
+			return fd;
+		}
+
+		static auto write_all(int fd, std::string_view bytes) noexcept -> bool {
+			while (not bytes.empty()) {
+				auto const written = ::write(fd, bytes.data(), bytes.size());
+				if (written < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					return false;
+				}
+				bytes.remove_prefix(static_cast<std::size_t>(written));
+			}
+			return true;
+		}
+
+		// Syncs a file or directory through a descriptor of its own
+		static auto sync_file(std::filesystem::path const& file) noexcept -> bool {
+			auto const fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0) {
+				return false;
+			}
+			auto const synced = ::fsync(fd) == 0;
+			::close(fd);
+			return synced;
+		}
+
+		template<detail::serialize::trivial T>
+		static auto put(std::string& out, T const& value) -> void {
+			auto const start = out.size();
+			out.resize(start + sizeof(T));
+			std::memcpy(out.data() + start, &value, sizeof(T));
+		}
+
+		static auto put(std::string& out, std::string const& value) -> void {
+			put(out, static_cast<std::uint64_t>(value.size()));
+			out.append(value);
+		}
+
+		std::filesystem::path directory_;
+		durable_options options_;
+
+		mutable std::shared_mutex graph_mutex_;
+		graph<N, E> graph_;
+
+		// The log. Records 1 to synced_ are on disk, and appended_ is the last record logged.
+		mutable std::mutex log_mutex_;
+		std::condition_variable synced_cv_;
+		std::string buffer_;
+		std::string spare_;
+		int fd_ = -1;
+		std::uint64_t generation_ = 0;
+		std::uint64_t appended_ = 0;
+		std::uint64_t synced_ = 0;
+		bool syncing_ = false;
+		bool rotating_ = false; // Keeps other writes of the buffer from starting
+		bool failed_ = false;
+		bool checkpoint_due_ = false;
+		std::uint64_t mutations_ = 0;
+		std::uint64_t syncs_ = 0;
+		std::uint64_t checkpoints_ = 0;
+		std::uint64_t log_bytes_ = 0;
+
+		// Only the checkpointing thread uses these once the constructor returns
+		std::uint64_t checkpoint_ = 0;
+		bool has_checkpoint_ = false;
+
+		std::mutex checkpoint_mutex_;
+		std::condition_variable checkpoint_wanted_;
+		std::condition_variable checkpoint_done_;
+		std::uint64_t requested_ = 0;
+		std::uint64_t completed_ = 0;
+		std::exception_ptr checkpoint_error_;
+		bool due_ = false;
+		bool stopping_ = false;
+		std::thread checkpointer_; // Last, so it starts after everything it uses
+	};
+} // namespace gdwg
+
+#endif // GDWG_DURABLE_GRAPH_HPP
@@ -0,0 +1,711 @@
+#ifndef GDWG_EXTERNAL_GRAPH_HPP
+#define GDWG_EXTERNAL_GRAPH_HPP
+
+#include "gdwg/detail/mapped_file.hpp"
+#include "gdwg/detail/serialize.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/traversal.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// A read-only graph kept in a directory on disk, for graphs with more edges than fit in memory.
+//
+// Nodes get the ids of a natural snapshot, their position in graph::nodes(). Only the index is
+// held in memory: the sorted nodes and where each node's edges start, about 8 bytes per node on
+// top of the nodes themselves. The edges live in segment files, each holding the sorted edges of
+// a range of consecutive nodes (about segment_bytes of them) as an array of target ids followed
+// by an array of weights, which are memory mapped, so neighbours() and weights() return spans
+// straight into the files and only the pages that are read take memory. Files use the byte order
+// of the machine that wrote them, and opening checks the index and the segment headers but not
+// every target, so the files must come from external_graph_writer.
+namespace gdwg {
+	struct external_options {
+		// Bytes of edges per segment file. A segment holds at least one node's edges.
+		std::size_t segment_bytes = std::size_t{64} << 20U;
+	};
+
+	namespace detail::external {
+		inline constexpr auto index_magic =
+		   std::array<char, 8>{'g', 'd', 'w', 'g', '-', 'i', 'd', 'x'};
+		inline constexpr auto segment_magic =
+		   std::array<char, 8>{'g', 'd', 'w', 'g', '-', 's', 'e', 'g'};
+		inline constexpr auto version = std::uint32_t{1};
+
+		// Start of a segment file, padded to 64 bytes so that the targets after it are aligned
+		struct segment_header {
+			std::array<char, 8> magic = segment_magic;
+			std::uint32_t version = external::version;
+			std::uint32_t mark = serialize::byte_order_mark;
+			std::uint64_t first_edge = 0;
+			std::uint64_t edges = 0;
+			std::uint32_t weight_size = 0;
+			std::uint32_t weight_alignment = 0;
+		};
+
+		inline constexpr auto targets_offset = std::size_t{64};
+		static_assert(sizeof(segment_header) <= targets_offset);
+
+		template<typename E>
+		constexpr auto weights_offset(std::uint64_t edges) noexcept -> std::uint64_t {
+			auto constexpr alignment = std::max<std::uint64_t>(alignof(E), 8);
+			auto const end = targets_offset + edges * sizeof(std::uint32_t);
+			return (end + alignment - 1) / alignment * alignment;
+		}
+
+		inline auto segment_path(std::filesystem::path const& directory, std::size_t k)
+		   -> std::filesystem::path {
+			return directory / ("segment-" + std::to_string(k));
+		}
+	} // namespace detail::external
+
+	// Writes an external graph one edge at a time, so a graph can be converted without ever being
+	// held in memory. Edges must arrive in the order of graph::begin(), by source, then
+	// destination, then weight; a repeat of the previous edge is ignored. Nothing can be opened
+	// from the directory until finish() is called.
+	template<typename N, typename E>
+	requires detail::serialize::serializable<N> and detail::serialize::trivial<E>
+	class external_graph_writer {
+	public:
+		using id_type = std::uint32_t;
+
+		external_graph_writer(std::filesystem::path directory,
+		                      std::vector<N> nodes,
+		                      external_options options = {})
+		: directory_(std::move(directory))
+		, options_(options)
+		, nodes_(std::move(nodes)) {
+			std::sort(nodes_.begin(), nodes_.end());
+			nodes_.erase(std::unique(nodes_.begin(), nodes_.end()), nodes_.end());
+			auto error = std::error_code();
+			std::filesystem::create_directories(directory_, error);
+			if (error) {
+				throw std::runtime_error("Cannot call gdwg::external_graph_writer<N, E>::"
+				                         "external_graph_writer on a directory that can't be written");
+			}
+			std::filesystem::remove(directory_ / "index", error);
+		}
+
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			if (finished_) {
+				throw std::runtime_error("Cannot call gdwg::external_graph_writer<N, E>::insert_edge "
+				                         "after finish()");
+			}
+			auto const from = id(src);
+			auto const to = id(dst);
+			if (not from or not to) {
+				throw std::runtime_error("Cannot call gdwg::external_graph_writer<N, E>::insert_edge "
+				                         "when either src or dst node does not exist");
+			}
+			if (edges_ > 0) {
+				auto const edge = std::tie(*from, *to);
+				auto const last = std::tie(last_from_, last_to_);
+				if (edge < last or (edge == last and weight < last_weight_)) {
+					throw std::runtime_error("Cannot call gdwg::external_graph_writer<N, E>::"
+					                         "insert_edge with edges out of order");
+				}
+				if (edge == last and not(last_weight_ < weight)) {
+					return false;
+				}
+			}
+			advance_to(*from);
+			targets_.push_back(*to);
+			weights_.push_back(weight);
+			last_from_ = *from;
+			last_to_ = *to;
+			last_weight_ = weight;
+			++edges_;
+			return true;
+		}
+
+		// Writes the last segment and the index
+		auto finish() -> void {
+			if (finished_) {
+				return;
+			}
+			advance_to(static_cast<id_type>(nodes_.size()));
+			write_segment();
+			segment_first_.push_back(static_cast<id_type>(nodes_.size()));
+			auto os = std::ofstream(directory_ / "index", std::ios::binary | std::ios::trunc);
+			auto out = detail::serialize::writer(os);
+			out.write(detail::external::index_magic);
+			out.write(detail::external::version);
+			out.write(detail::serialize::byte_order_mark);
+			out.write(layout());
+			out.write(nodes_);
+			out.write(offsets_);
+			out.write(segment_first_);
+			os.flush();
+			if (not os) {
+				throw std::runtime_error("Cannot call gdwg::external_graph_writer<N, E>::finish on a "
+				                         "directory that can't be written");
+			}
+			finished_ = true;
+		}
+
+		// Sizes that must match between the writer and the reader
+		static constexpr auto layout() noexcept -> std::array<std::uint32_t, 2> {
+			return {static_cast<std::uint32_t>(sizeof(E)), static_cast<std::uint32_t>(alignof(E))};
+		}
+
+	private:
+		auto id(N const& value) const -> std::optional<id_type> {
+			auto const it = std::lower_bound(nodes_.begin(), nodes_.end(), value);
+			if (it == nodes_.end() or value < *it) {
+				return std::nullopt;
+			}
+			return static_cast<id_type>(it - nodes_.begin());
+		}
+
+		// Ends the edges of every node before u, starting a new segment at a node boundary once
+		// the current one is full
+		auto advance_to(id_type u) -> void {
+			while (current_ < u) {
+				offsets_.push_back(edges_);
+				++current_;
+				auto const bytes = targets_.size() * (sizeof(id_type) + sizeof(E));
+				if (current_ < nodes_.size() and bytes >= options_.segment_bytes) {
+					write_segment();
+					segment_first_.push_back(current_);
+				}
+			}
+		}
+
+		auto write_segment() -> void {
+			auto header = detail::external::segment_header{};
+			header.first_edge = edges_ - targets_.size();
+			header.edges = targets_.size();
+			header.weight_size = layout()[0];
+			header.weight_alignment = layout()[1];
+			auto bytes = std::vector<char>(detail::external::weights_offset<E>(header.edges)
+			                               + header.edges * sizeof(E));
+			std::memcpy(bytes.data(), &header, sizeof(header));
+			if (not targets_.empty()) {
+				std::memcpy(bytes.data() + detail::external::targets_offset,
+				            targets_.data(),
+				            targets_.size() * sizeof(id_type));
+				std::memcpy(bytes.data() + detail::external::weights_offset<E>(header.edges),
+				            weights_.data(),
+				            weights_.size() * sizeof(E));
+			}
+			auto const file = detail::external::segment_path(directory_, segment_first_.size() - 1);
+			auto os = std::ofstream(file, std::ios::binary | std::ios::trunc);
+			os.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+			os.flush();
+			if (not os) {
+				throw std::runtime_error("Cannot call gdwg::external_graph_writer<N, E>::insert_edge on "
+				                         "a directory that can't be written");
+			}
+			targets_.clear();
+			weights_.clear();
+		}
+
+		std::filesystem::path directory_;
+		external_options options_;
+		std::vector<N> nodes_;
+		std::vector<std::uint64_t> offsets_ = {0};
+		std::vector<id_type> segment_first_ = {0};
+		id_type current_ = 0; // Source of the edges being written
+		std::uint64_t edges_ = 0;
+		std::vector<id_type> targets_; // Of the current segment
+		std::vector<E> weights_;
+		id_type last_from_ = 0; // The last edge written
+		id_type last_to_ = 0;
+		E last_weight_ = E();
+		bool finished_ = false;
+	};
+
+	template<typename N, typename E>
+	requires detail::serialize::serializable<N> and detail::serialize::trivial<E>
+	class external_graph {
+		class iterator;
+
+	public:
+		using id_type = std::uint32_t;
+		using value_type = typename graph<N, E>::value_type;
+
+		explicit external_graph(std::filesystem::path const& directory) {
+			// Time complexity
+			//        read the index         - n +
+			//        map every segment      - s
+			//     = O(n + s) solution, reading no edges
+			auto is = std::ifstream(directory / "index", std::ios::binary);
+			auto in = detail::serialize::reader(is);
+			auto header = decltype(detail::external::index_magic){};
+			auto file_version = std::uint32_t{0};
+			auto mark = std::uint32_t{0};
+			auto file_layout = decltype(external_graph_writer<N, E>::layout()){};
+			in.read(header);
+			in.read(file_version);
+			in.read(mark);
+			in.read(file_layout);
+			if (header != detail::external::index_magic or file_version != detail::external::version
+			    or mark != detail::serialize::byte_order_mark
+			    or file_layout != external_graph_writer<N, E>::layout())
+			{
+				in.fail();
+			}
+			in.read(nodes_);
+			in.read(offsets_);
+			in.read(segment_first_);
+			if (not in.ok() or not valid_index()) {
+				throw_invalid();
+			}
+			for (auto k = std::size_t{0}; k + 1 < segment_first_.size(); ++k) {
+				segments_.push_back(map_segment(directory, k));
+			}
+		}
+
+		// Writes g to directory, then opens it
+		[[nodiscard]] static auto write(graph<N, E> const& g,
+		                                std::filesystem::path const& directory,
+		                                external_options options = {}) -> external_graph {
+			auto writer = external_graph_writer<N, E>(directory, g.nodes(), options);
+			for (auto const& [from, to, weight] : g) {
+				writer.insert_edge(from, to, weight);
+			}
+			writer.finish();
+			return external_graph(directory);
+		}
+
+		// Accessors, as for graph
+
+		[[nodiscard]] auto is_node(N const& value) const -> bool {
+			return id(value).has_value(); // O(log(n)) solution
+		}
+
+		[[nodiscard]] auto empty() const noexcept -> bool {
+			return nodes_.empty();
+		}
+
+		[[nodiscard]] auto num_nodes() const noexcept -> std::size_t {
+			return nodes_.size();
+		}
+
+		[[nodiscard]] auto num_edges() const noexcept -> std::size_t {
+			return static_cast<std::size_t>(offsets_.back());
+		}
+
+		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
+			// Time complexity
+			//     = O(log(n) + log(e)) solution, reading one or two pages of src's edges
+			auto const from = id(src);
+			auto const to = id(dst);
+			if (not from or not to) {
+				throw std::runtime_error("Cannot call gdwg::external_graph<N, E>::is_connected if src "
+				                         "or dst node don't exist in the graph");
+			}
+			return std::ranges::binary_search(neighbours(*from), *to);
+		}
+
+		[[nodiscard]] auto nodes() const -> std::vector<N> {
+			return nodes_;
+		}
+
+		[[nodiscard]] auto weights(N const& src, N const& dst) const -> std::vector<E> {
+			// Time complexity
+			//     = O(log(n) + log(e) + w) solution, for w weights
+			auto const from = id(src);
+			auto const to = id(dst);
+			if (not from or not to) {
+				throw std::runtime_error("Cannot call gdwg::external_graph<N, E>::weights if src or dst "
+				                         "node don't exist in the graph");
+			}
+			auto const targets = neighbours(*from);
+			auto const [first, last] = std::equal_range(targets.begin(), targets.end(), *to);
+			auto const all = weights(*from);
+			return std::vector<E>(all.begin() + (first - targets.begin()),
+			                      all.begin() + (last - targets.begin()));
+		}
+
+		[[nodiscard]] auto connections(N const& src) const -> std::vector<N> {
+			// Time complexity
+			//     = O(log(n) + e) solution
+			auto const from = id(src);
+			if (not from) {
+				throw std::runtime_error("Cannot call gdwg::external_graph<N, E>::connections if src "
+				                         "doesn't exist in the graph");
+			}
+			auto result = std::vector<N>();
+			auto const targets = neighbours(*from);
+			for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+				if (i == 0 or targets[i] != targets[i - 1]) {
+					result.push_back(nodes_[targets[i]]);
+				}
+			}
+			return result;
+		}
+
+		// Edges in the order of graph::begin(), read sequentially through the segments
+		[[nodiscard]] auto begin() const -> iterator {
+			return iterator(this, 0);
+		}
+
+		[[nodiscard]] auto end() const -> iterator {
+			return iterator(this, offsets_.back());
+		}
+
+		// Accessors by id, as for snapshot
+
+		[[nodiscard]] auto node(id_type id) const -> N const& {
+			return nodes_[id];
+		}
+
+		[[nodiscard]] auto id(N const& value) const -> std::optional<id_type> {
+			auto const it = std::lower_bound(nodes_.begin(), nodes_.end(), value);
+			if (it == nodes_.end() or value < *it) {
+				return std::nullopt;
+			}
+			return static_cast<id_type>(it - nodes_.begin());
+		}
+
+		[[nodiscard]] auto out_degree(id_type id) const noexcept -> std::size_t {
+			return static_cast<std::size_t>(offsets_[id + 1] - offsets_[id]);
+		}
+
+		// Number of edges of the nodes before id, which is num_edges() for id num_nodes()
+		[[nodiscard]] auto edge_offset(id_type id) const noexcept -> std::uint64_t {
+			return offsets_[id];
+		}
+
+		// Sorted, and pointing into the mapped segment, so valid as long as the graph
+		[[nodiscard]] auto neighbours(id_type id) const noexcept -> std::span<id_type const> {
+			auto const& s = segments_[segment_of(id)];
+			return {s.targets + (offsets_[id] - s.first_edge), out_degree(id)};
+		}
+
+		[[nodiscard]] auto weights(id_type id) const noexcept -> std::span<E const> {
+			auto const& s = segments_[segment_of(id)];
+			return {s.weights + (offsets_[id] - s.first_edge), out_degree(id)};
+		}
+
+		// Segments, each holding the edges of the nodes in [first, last)
+
+		[[nodiscard]] auto num_segments() const noexcept -> std::size_t {
+			return segments_.size();
+		}
+
+		[[nodiscard]] auto segment_nodes(std::size_t k) const noexcept -> std::pair<id_type, id_type> {
+			return {segment_first_[k], segment_first_[k + 1]};
+		}
+
+		[[nodiscard]] auto segment_of(id_type id) const noexcept -> std::size_t {
+			auto const it = std::upper_bound(segment_first_.begin(), segment_first_.end() - 1, id);
+			return static_cast<std::size_t>(it - segment_first_.begin()) - 1;
+		}
+
+		// Starts reading segment k from disk in the background, so a scan that will reach it next
+		// doesn't wait for it
+		auto prefetch(std::size_t k) const noexcept -> void {
+			segments_[k].file.will_need();
+		}
+
+		// Lets segment k's pages go once a scan is done with it. The spans into it stay valid, and
+		// read it in again if used.
+		auto release(std::size_t k) const noexcept -> void {
+			segments_[k].file.release();
+		}
+
+		// As prefetch() and release(), for only the pages holding the neighbours of the nodes in
+		// [first, last), which must all be in one segment
+
+		auto prefetch_neighbours(id_type first, id_type last) const noexcept -> void {
+			if (auto const [s, offset, length] = neighbour_bytes(first, last); length != 0) {
+				s->file.will_need(offset, length);
+			}
+		}
+
+		auto release_neighbours(id_type first, id_type last) const noexcept -> void {
+			if (auto const [s, offset, length] = neighbour_bytes(first, last); length != 0) {
+				s->file.release(offset, length);
+			}
+		}
+
+		// Size of the index held in memory, not counting the contents of N
+		[[nodiscard]] auto index_bytes() const noexcept -> std::size_t {
+			return nodes_.size() * sizeof(N) + offsets_.size() * sizeof(std::uint64_t)
+			       + segment_first_.size() * sizeof(id_type) + segments_.size() * sizeof(segment);
+		}
+
+	private:
+		struct segment {
+			detail::mapped_file file;
+			std::uint64_t first_edge = 0;
+			id_type const* targets = nullptr;
+			E const* weights = nullptr;
+		};
+
+		struct byte_range {
+			segment const* s;
+			std::size_t offset;
+			std::size_t length;
+		};
+
+		// Where in its segment's file the neighbours of the nodes in [first, last) are
+		[[nodiscard]] auto neighbour_bytes(id_type first, id_type last) const noexcept -> byte_range {
+			if (first >= last or offsets_[first] == offsets_[last]) {
+				return {nullptr, 0, 0};
+			}
+			auto const& s = segments_[segment_of(first)];
+			auto const* const begin = s.targets + (offsets_[first] - s.first_edge);
+			auto const offset = reinterpret_cast<char const*>(begin) - s.file.data();
+			return {&s,
+			        static_cast<std::size_t>(offset),
+			        static_cast<std::size_t>(offsets_[last] - offsets_[first]) * sizeof(id_type)};
+		}
+
+		[[noreturn]] static auto throw_invalid() -> void {
+			throw std::runtime_error("Cannot call gdwg::external_graph<N, E>::external_graph on a "
+			                         "directory that doesn't hold a valid external graph");
+		}
+
+		[[nodiscard]] auto valid_index() const -> bool {
+			auto const n = nodes_.size();
+			auto const out_of_order = [](N const& a, N const& b) { return not(a < b); };
+			auto const strictly_sorted =
+			   std::adjacent_find(nodes_.begin(), nodes_.end(), out_of_order) == nodes_.end();
+			return strictly_sorted and offsets_.size() == n + 1 and offsets_.front() == 0
+			       and std::is_sorted(offsets_.begin(), offsets_.end()) and segment_first_.size() >= 2
+			       and segment_first_.front() == 0 and segment_first_.back() == n
+			       and std::is_sorted(segment_first_.begin(), segment_first_.end());
+		}
+
+		[[nodiscard]] auto map_segment(std::filesystem::path const& directory, std::size_t k) const
+		   -> segment {
+			auto result = segment{detail::mapped_file(detail::external::segment_path(directory, k))};
+			auto const& file = result.file;
+			auto header = detail::external::segment_header{};
+			if (not file.is_open() or file.size() < detail::external::targets_offset) {
+				throw_invalid();
+			}
+			std::memcpy(&header, file.data(), sizeof(header));
+			auto const first_edge = offsets_[segment_first_[k]];
+			auto const edges = offsets_[segment_first_[k + 1]] - first_edge;
+			auto const layout = external_graph_writer<N, E>::layout();
+			if (header.magic != detail::external::segment_magic
+			    or header.version != detail::external::version
+			    or header.mark != detail::serialize::byte_order_mark or header.first_edge != first_edge
+			    or header.edges != edges or header.weight_size != layout[0]
+			    or header.weight_alignment != layout[1]
+			    or file.size() < detail::external::weights_offset<E>(edges) + edges * sizeof(E))
+			{
+				throw_invalid();
+			}
+			result.first_edge = first_edge;
+			result.targets =
+			   reinterpret_cast<id_type const*>(file.data() + detail::external::targets_offset);
+			result.weights =
+			   reinterpret_cast<E const*>(file.data() + detail::external::weights_offset<E>(edges));
+			file.sequential();
+			return result;
+		}
+
+		std::vector<N> nodes_;
+		std::vector<std::uint64_t> offsets_;
+		std::vector<id_type> segment_first_;
+		std::vector<segment> segments_;
+
+		class iterator {
+		public:
+			using value_type = external_graph::value_type;
+			using reference = value_type;
+			using pointer = void;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			iterator() = default;
+
+			auto operator*() const -> reference {
+				auto const& s = g_->segments_[segment_];
+				auto const local = edge_ - s.first_edge;
+				return value_type{g_->nodes_[node_], g_->nodes_[s.targets[local]], s.weights[local]};
+			}
+
+			auto operator++() -> iterator& {
+				++edge_;
+				settle();
+				return *this;
+			}
+
+			auto operator++(int) -> iterator {
+				auto copy = *this;
+				++*this;
+				return copy;
+			}
+
+			auto operator==(iterator const& other) const noexcept -> bool {
+				return g_ == other.g_ and edge_ == other.edge_;
+			}
+
+		private:
+			iterator(external_graph const* g, std::uint64_t edge)
+			: g_(g)
+			, edge_(edge) {
+				settle();
+			}
+
+			// Moves on to the node, and segment, that the edge belongs to
+			auto settle() noexcept -> void {
+				auto const n = g_->nodes_.size();
+				while (node_ < n and g_->offsets_[node_ + 1] <= edge_) {
+					++node_;
+				}
+				auto const& first = g_->segment_first_;
+				while (segment_ + 2 < first.size() and first[segment_ + 1] <= node_) {
+					++segment_;
+				}
+			}
+
+			external_graph const* g_ = nullptr;
+			std::uint64_t edge_ = 0;
+			std::size_t node_ = 0;
+			std::size_t segment_ = 0;
+
+			friend class external_graph;
+		};
+	};
+
+	// Streaming algorithms. Both read segments in file order, asking for what they need of the
+	// next segment to be read ahead while the current one is processed and releasing what they
+	// read after, so the memory they take beyond the per-node results is a segment or two.
+	// Results are indexed by id.
+
+	// Number of edges on a shortest path from source to every node, ignoring weights. Each level
+	// of the search reads only the pages holding neighbours of its frontier. The pages of the
+	// next segment's frontier nodes are read ahead when they are mostly neighbours of the
+	// frontier and more than a few, and otherwise read on demand.
+	template<typename N, typename E>
+	[[nodiscard]] auto bfs_distances(external_graph<N, E> const& g,
+	                                 typename external_graph<N, E>::id_type source)
+	   -> std::vector<std::uint32_t> {
+		// Time complexity
+		//        visit every reachable node and edge once  - n + e +
+		//        sort each frontier                         - n log(n)
+		//     = O(n log(n) + e) solution, reading each segment at most once per level
+		if (source >= g.num_nodes()) {
+			throw std::runtime_error("Cannot call gdwg::bfs_distances on a source that doesn't exist "
+			                         "in the external graph");
+		}
+		auto distance = std::vector<std::uint32_t>(g.num_nodes(), unreachable);
+		auto frontier = std::vector<std::uint32_t>{source};
+		auto next = std::vector<std::uint32_t>();
+		// The frontier's nodes in one segment: frontier[begin, end)
+		struct group {
+			std::size_t begin;
+			std::size_t end;
+		};
+		auto groups = std::vector<group>();
+		// The nodes from a group's first to its last, which hold the pages it reads
+		auto const span = [&](group const& nodes) {
+			return std::pair(frontier[nodes.begin], frontier[nodes.end - 1] + 1);
+		};
+		auto const prefetch = [&](group const& nodes) {
+			constexpr auto min_read_ahead = std::size_t{64} << 10U; // Bytes
+			auto const [first, last] = span(nodes);
+			auto edges = std::uint64_t{0};
+			for (auto i = nodes.begin; i < nodes.end; ++i) {
+				edges += g.out_degree(frontier[i]);
+			}
+			auto const spanned = g.edge_offset(last) - g.edge_offset(first);
+			if (edges * sizeof(std::uint32_t) >= min_read_ahead and 2 * edges >= spanned) {
+				g.prefetch_neighbours(first, last);
+			}
+		};
+		distance[source] = 0;
+		for (auto level = std::uint32_t{1}; not frontier.empty(); ++level) {
+			// In id order, the frontier's nodes are grouped by segment, in file order
+			std::sort(frontier.begin(), frontier.end());
+			groups.clear();
+			auto segment = g.num_segments();
+			for (auto i = std::size_t{0}; i < frontier.size(); ++i) {
+				auto const k = g.segment_of(frontier[i]);
+				if (k != segment) {
+					groups.push_back({i, i});
+					segment = k;
+				}
+				++groups.back().end;
+			}
+			prefetch(groups.front());
+			for (auto t = std::size_t{0}; t < groups.size(); ++t) {
+				if (t + 1 < groups.size()) {
+					prefetch(groups[t + 1]);
+				}
+				for (auto i = groups[t].begin; i < groups[t].end; ++i) {
+					for (auto const v : g.neighbours(frontier[i])) {
+						if (distance[v] == unreachable) {
+							distance[v] = level;
+							next.push_back(v);
+						}
+					}
+				}
+				auto const [first, last] = span(groups[t]);
+				g.release_neighbours(first, last);
+			}
+			frontier.swap(next);
+			next.clear();
+		}
+		return distance;
+	}
+
+	// PageRank, as for a snapshot, with each node pushing its rank along its edges in one pass
+	// over the segments per iteration
+	template<typename N, typename E>
+	[[nodiscard]] auto pagerank(external_graph<N, E> const& g,
+	                            std::size_t iterations = 20,
+	                            double damping = 0.85) -> std::vector<double> {
+		// Time complexity
+		//     = O(k * (n + e)) solution, reading every segment once per iteration
+		auto const n = g.num_nodes();
+		if (n == 0) {
+			return {};
+		}
+		auto const share = 1.0 / static_cast<double>(n);
+		auto rank = std::vector<double>(n, share);
+		auto next = std::vector<double>(n);
+		for (auto i = std::size_t{0}; i < iterations; ++i) {
+			auto dangling = 0.0;
+			std::fill(next.begin(), next.end(), 0.0);
+			g.prefetch(0);
+			for (auto k = std::size_t{0}; k < g.num_segments(); ++k) {
+				if (k + 1 < g.num_segments()) {
+					g.prefetch(k + 1);
+				}
+				auto const [first, last] = g.segment_nodes(k);
+				for (auto u = first; u < last; ++u) {
+					auto const targets = g.neighbours(u);
+					if (targets.empty()) {
+						dangling += rank[u];
+						continue;
+					}
+					auto const contribution = rank[u] / static_cast<double>(targets.size());
+					for (auto const v : targets) {
+						next[v] += contribution;
+					}
+				}
+				g.release(k);
+			}
+			auto const base = (1.0 - damping) * share + damping * dangling * share;
+			for (auto& value : next) {
+				value = base + damping * value;
+			}
+			rank.swap(next);
+		}
+		return rank;
+	}
+} // namespace gdwg
+
+#endif // GDWG_EXTERNAL_GRAPH_HPP
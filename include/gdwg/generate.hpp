@@ -0,0 +1,300 @@
+#ifndef GDWG_GENERATE_HPP
+#define GDWG_GENERATE_HPP
+
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Synthetic graphs for benchmarks and stress tests.
+//
+// Nodes are the integers 0 to n - 1. Integral weights are uniform in [1, 100] and floating-point
+// weights uniform in [0, 1). The output is split into fixed chunks that each draw from their own
+// random stream, keyed by the seed and the chunk, so a seed always gives the same graph no
+// matter how many threads generate it. Edges are added through graph::insert_edges(). A threads
+// value of 0 uses every hardware thread.
+namespace gdwg::generate {
+	inline constexpr auto default_seed = std::uint64_t{6771};
+
+	namespace detail {
+		using gdwg::detail::parallel_for;
+
+		template<typename N, typename E>
+		concept generated = std::integral<N> and (std::integral<E> or std::floating_point<E>);
+
+		// splitmix64, which passes BigCrush and can be seeded with any key
+		class random_stream {
+		public:
+			random_stream(std::uint64_t seed, std::uint64_t key) noexcept
+			: state_{mix(seed ^ mix(key + 0x243f6a8885a308d3ULL))} {}
+
+			auto next() noexcept -> std::uint64_t {
+				state_ += 0x9e3779b97f4a7c15ULL;
+				return mix(state_);
+			}
+
+			// Uniform in [0, 1)
+			auto uniform() noexcept -> double {
+				return static_cast<double>(next() >> 11U) * 0x1.0p-53;
+			}
+
+			// Uniform in [0, bound), for bound > 0
+			auto below(std::uint64_t bound) noexcept -> std::uint64_t {
+				auto const value = static_cast<std::uint64_t>(uniform() * static_cast<double>(bound));
+				return std::min(value, bound - 1);
+			}
+
+			template<typename E>
+			auto weight() noexcept -> E {
+				if constexpr (std::floating_point<E>) {
+					return static_cast<E>(uniform());
+				}
+				else {
+					return static_cast<E>(1 + below(100));
+				}
+			}
+
+		private:
+			std::uint64_t state_;
+
+			static auto mix(std::uint64_t x) noexcept -> std::uint64_t {
+				x ^= x >> 30U;
+				x *= 0xbf58476d1ce4e5b9ULL;
+				x ^= x >> 27U;
+				x *= 0x94d049bb133111ebULL;
+				x ^= x >> 31U;
+				return x;
+			}
+		};
+
+		inline constexpr auto chunk_size = std::uint64_t{1} << 16U;
+
+		template<typename N>
+		auto check_node_count(std::uint64_t n, char const* generator) -> void {
+			if (n > static_cast<std::uint64_t>(std::numeric_limits<N>::max())) {
+				throw std::runtime_error(std::string("Cannot call gdwg::generate::") + generator
+				                         + " with more nodes than N can represent");
+			}
+		}
+
+		// Builds a graph on nodes [0, n) from chunks, where chunk(c, out) appends the edges of
+		// chunk c to out
+		template<typename N, typename E, typename Chunk>
+		auto build(std::uint64_t n, std::uint64_t chunks, std::size_t threads, Chunk chunk)
+		   -> graph<N, E> {
+			auto parts = std::vector<std::vector<typename graph<N, E>::value_type>>(chunks);
+			parallel_for(
+			   chunks,
+			   threads,
+			   [&](std::size_t c, std::size_t) { chunk(static_cast<std::uint64_t>(c), parts[c]); },
+			   1);
+
+			auto edges = std::vector<typename graph<N, E>::value_type>();
+			auto total = std::size_t{0};
+			for (auto const& part : parts) {
+				total += part.size();
+			}
+			edges.reserve(total);
+			for (auto& part : parts) {
+				edges.insert(edges.end(), part.begin(), part.end());
+				part = {};
+			}
+
+			auto g = graph<N, E>();
+			g.insert_nodes(std::views::iota(N{0}, static_cast<N>(n)));
+			g.insert_edges(std::move(edges), threads);
+			return g;
+		}
+	} // namespace detail
+
+	// Recursive-matrix (R-MAT) graph on 2^scale nodes, drawing edge_factor * 2^scale edges with
+	// the Graph500 quadrant probabilities (0.57, 0.19, 0.19, 0.05). This gives the skewed degrees
+	// and community structure of social and web graphs. Repeated draws of the same edge and
+	// weight are kept once.
+	template<typename N = int, typename E = int>
+	requires detail::generated<N, E>
+	[[nodiscard]] auto rmat(unsigned scale,
+	                        std::uint64_t edge_factor,
+	                        std::uint64_t seed = default_seed,
+	                        std::size_t threads = 0) -> graph<N, E> {
+		// Time complexity
+		//        draw edges    - e * scale +
+		//        bulk build    - e log(e)
+		//     = O(e log(e)) solution
+		if (scale >= 63) {
+			throw std::runtime_error("Cannot call gdwg::generate::rmat with a scale of 63 or more");
+		}
+		auto const n = std::uint64_t{1} << scale;
+		detail::check_node_count<N>(n, "rmat");
+		auto const m = edge_factor * n;
+		return detail::build<N, E>(
+		   n,
+		   (m + detail::chunk_size - 1) / detail::chunk_size,
+		   threads,
+		   [&](std::uint64_t chunk, auto& out) {
+			   auto rng = detail::random_stream(seed, chunk);
+			   auto const end = std::min(m, (chunk + 1) * detail::chunk_size);
+			   for (auto i = chunk * detail::chunk_size; i < end; ++i) {
+				   auto u = std::uint64_t{0};
+				   auto v = std::uint64_t{0};
+				   for (auto bit = std::uint64_t{1}; bit < n; bit <<= 1U) {
+					   auto const r = rng.uniform();
+					   if (r >= 0.57 + 0.19 + 0.19) {
+						   u |= bit;
+						   v |= bit;
+					   }
+					   else if (r >= 0.57 + 0.19) {
+						   u |= bit;
+					   }
+					   else if (r >= 0.57) {
+						   v |= bit;
+					   }
+				   }
+				   out.push_back({static_cast<N>(u), static_cast<N>(v), rng.template weight<E>()});
+			   }
+		   });
+	}
+
+	// Directed Erdos-Renyi graph G(n, p): every ordered pair of distinct nodes is an edge with
+	// probability p, independently. Each row is sampled by geometric skipping, so the work is
+	// proportional to the number of edges rather than n^2.
+	template<typename N = int, typename E = int>
+	requires detail::generated<N, E>
+	[[nodiscard]] auto erdos_renyi(std::uint64_t n,
+	                               double p,
+	                               std::uint64_t seed = default_seed,
+	                               std::size_t threads = 0) -> graph<N, E> {
+		// Time complexity
+		//        sample rows   - n + e +
+		//        bulk build    - e log(e)
+		//     = O(n + e log(e)) solution
+		if (not(p >= 0.0 and p <= 1.0)) {
+			throw std::runtime_error("Cannot call gdwg::generate::erdos_renyi with a probability "
+			                         "outside [0, 1]");
+		}
+		detail::check_node_count<N>(n, "erdos_renyi");
+		constexpr auto rows_per_chunk = std::uint64_t{256};
+		auto const log_q = std::log1p(-p);
+		return detail::build<N, E>(
+		   n,
+		   (n + rows_per_chunk - 1) / rows_per_chunk,
+		   threads,
+		   [&](std::uint64_t chunk, auto& out) {
+			   auto rng = detail::random_stream(seed, chunk);
+			   auto const end = std::min(n, (chunk + 1) * rows_per_chunk);
+			   for (auto u = chunk * rows_per_chunk; u < end; ++u) {
+				   // Candidates are the n - 1 other nodes, with v = j skipping over u itself
+				   for (auto j = std::uint64_t{0}; p > 0.0 and j < n - 1; ++j) {
+					   if (p < 1.0) {
+						   auto const skip = std::floor(std::log1p(-rng.uniform()) / log_q);
+						   if (skip >= static_cast<double>(n - 1 - j)) {
+							   break;
+						   }
+						   j += static_cast<std::uint64_t>(skip);
+					   }
+					   auto const v = j < u ? j : j + 1;
+					   out.push_back({static_cast<N>(u), static_cast<N>(v), rng.template weight<E>()});
+				   }
+			   }
+		   });
+	}
+
+	// width x height grid, where node y * width + x has an edge to and from each of its (up to)
+	// four horizontal and vertical neighbours
+	template<typename N = int, typename E = int>
+	requires detail::generated<N, E>
+	[[nodiscard]] auto grid2d(std::uint64_t width,
+	                          std::uint64_t height,
+	                          std::uint64_t seed = default_seed,
+	                          std::size_t threads = 0) -> graph<N, E> {
+		// Time complexity
+		//        emit edges    - n +
+		//        bulk build    - n log(n)
+		//     = O(n log(n)) solution
+		auto const n = width * height;
+		if (height != 0 and n / height != width) {
+			throw std::runtime_error("Cannot call gdwg::generate::grid2d with more nodes than N can "
+			                         "represent");
+		}
+		detail::check_node_count<N>(n, "grid2d");
+		return detail::build<N, E>(n, height, threads, [&](std::uint64_t y, auto& out) {
+			auto rng = detail::random_stream(seed, y);
+			for (auto x = std::uint64_t{0}; x < width; ++x) {
+				auto const u = static_cast<N>(y * width + x);
+				auto const link = [&](std::uint64_t v) {
+					auto const weight = rng.template weight<E>();
+					out.push_back({u, static_cast<N>(v), weight});
+					out.push_back({static_cast<N>(v), u, weight});
+				};
+				if (x + 1 < width) {
+					link(y * width + x + 1);
+				}
+				if (y + 1 < height) {
+					link((y + 1) * width + x);
+				}
+			}
+		});
+	}
+
+	// Barabasi-Albert preferential attachment graph: every node u > 0 links to m earlier nodes
+	// picked with probability proportional to their degree, giving a power-law degree
+	// distribution. Edges point from the newer node to the older one; repeated picks of the same
+	// node are kept once when they draw the same weight.
+	//
+	// Preferential attachment is usually sequential. Here every edge picks uniformly among the
+	// endpoints of the edges before its source, and an endpoint that is itself a pick is resolved
+	// by following that edge's own (keyed) random choice, so every edge can be drawn
+	// independently and in parallel.
+	template<typename N = int, typename E = int>
+	requires detail::generated<N, E>
+	[[nodiscard]] auto barabasi_albert(std::uint64_t n,
+	                                   std::uint64_t m,
+	                                   std::uint64_t seed = default_seed,
+	                                   std::size_t threads = 0) -> graph<N, E> {
+		// Time complexity
+		//        resolve picks - e (expected O(1) steps per edge) +
+		//        bulk build    - e log(e)
+		//     = O(e log(e)) solution
+		detail::check_node_count<N>(n, "barabasi_albert");
+		auto const edges = n < 2 ? 0 : (n - 1) * m;
+		// Edge e belongs to node 1 + e / m. Endpoint 2e is its source and 2e + 1 its target.
+		auto const source = [&](std::uint64_t e) { return 1 + e / m; };
+		auto const target = [&](std::uint64_t e) {
+			for (;;) {
+				auto const candidates = 2 * (source(e) - 1) * m; // Endpoints of earlier nodes
+				if (candidates == 0) {
+					return std::uint64_t{0};
+				}
+				auto rng = detail::random_stream(seed, ~e);
+				auto const endpoint = rng.below(candidates);
+				if (endpoint % 2 == 0) {
+					return source(endpoint / 2);
+				}
+				e = endpoint / 2;
+			}
+		};
+		return detail::build<N, E>(
+		   n,
+		   (edges + detail::chunk_size - 1) / detail::chunk_size,
+		   threads,
+		   [&](std::uint64_t chunk, auto& out) {
+			   auto rng = detail::random_stream(seed, chunk);
+			   auto const end = std::min(edges, (chunk + 1) * detail::chunk_size);
+			   for (auto e = chunk * detail::chunk_size; e < end; ++e) {
+				   out.push_back(
+				      {static_cast<N>(source(e)), static_cast<N>(target(e)), rng.template weight<E>()});
+			   }
+		   });
+	}
+} // namespace gdwg::generate
+
+#endif // GDWG_GENERATE_HPP
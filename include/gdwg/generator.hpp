@@ -0,0 +1,235 @@
+#ifndef GDWG_GENERATOR_HPP
+#define GDWG_GENERATOR_HPP
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define GDWG_HAS_COROUTINES 1
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+namespace gdwg {
+	namespace detail {
+		// Per-thread cache of released coroutine frames. A generator's frame is allocated when it
+		// is created and released when it is destroyed, so code that makes many short-lived
+		// generators (one traversal per query, say) would otherwise hit the heap for every one.
+		// Frames are kept in a few slots by their size, rounded up to a cache line, and handed
+		// back to the next frame of the same size. A frame may be released on another thread
+		// than the one that allocated it; it then simply joins that thread's cache.
+		class frame_pool {
+		public:
+			frame_pool() = default;
+			frame_pool(frame_pool const&) = delete;
+			auto operator=(frame_pool const&) -> frame_pool& = delete;
+
+			~frame_pool() {
+				for (auto const& cached : slots_) {
+					::operator delete(cached.frame);
+				}
+			}
+
+			[[nodiscard]] static auto allocate(std::size_t size) -> void* {
+				auto& pool = local();
+				size = rounded(size);
+				for (auto& cached : pool.slots_) {
+					if (cached.frame != nullptr and cached.size == size) {
+						return std::exchange(cached.frame, nullptr);
+					}
+				}
+				++pool.fresh_;
+				return ::operator new(size);
+			}
+
+			static auto release(void* frame, std::size_t size) noexcept -> void {
+				auto& pool = local();
+				size = rounded(size);
+				for (auto& cached : pool.slots_) {
+					if (cached.frame == nullptr) {
+						cached = {frame, size};
+						return;
+					}
+				}
+				::operator delete(frame);
+			}
+
+			// Number of frames this thread has had to get from the heap
+			[[nodiscard]] static auto fresh_allocations() noexcept -> std::size_t {
+				return local().fresh_;
+			}
+
+		private:
+			struct slot {
+				void* frame = nullptr;
+				std::size_t size = 0;
+			};
+
+			static constexpr auto line = std::size_t{64};
+
+			static auto local() noexcept -> frame_pool& {
+				thread_local auto pool = frame_pool();
+				return pool;
+			}
+
+			static auto rounded(std::size_t size) noexcept -> std::size_t {
+				return (size + line - 1) / line * line;
+			}
+
+			std::array<slot, 8> slots_ = {};
+			std::size_t fresh_ = 0;
+		};
+	} // namespace detail
+
+	// A lazily evaluated input range over the values a coroutine co_yields. The coroutine runs
+	// only as far as the next value each time the iterator is advanced, so stopping early (with
+	// a break, or std::views::take) skips the rest of its work. T is the reference type of the
+	// range: a yielded value is only valid until the iterator is next advanced, unless T is an
+	// lvalue reference to something that outlives the coroutine. A generator can be iterated
+	// once, and is a move-only view, so it composes with std::views adaptors.
+	template<typename T>
+	class generator : public std::ranges::view_interface<generator<T>> {
+	public:
+		using value_type = std::remove_cvref_t<T>;
+		using reference = std::conditional_t<std::is_reference_v<T>, T, T const&>;
+
+		class promise_type {
+		public:
+			[[nodiscard]] static auto operator new(std::size_t size) -> void* {
+				return detail::frame_pool::allocate(size);
+			}
+
+			static auto operator delete(void* frame, std::size_t size) noexcept -> void {
+				detail::frame_pool::release(frame, size);
+			}
+
+			auto get_return_object() noexcept -> generator {
+				return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+
+			auto initial_suspend() const noexcept -> std::suspend_always {
+				return {};
+			}
+
+			auto final_suspend() const noexcept -> std::suspend_always {
+				return {};
+			}
+
+			// A temporary lives until the end of the co_yield expression, past the suspension
+			auto yield_value(std::remove_reference_t<reference>& value) noexcept -> std::suspend_always {
+				value_ = std::addressof(value);
+				return {};
+			}
+
+			auto return_void() const noexcept -> void {}
+
+			auto unhandled_exception() noexcept -> void {
+				exception_ = std::current_exception();
+			}
+
+			template<typename Awaitable>
+			auto await_transform(Awaitable&&) -> std::suspend_never = delete; // Only co_yield
+
+		private:
+			std::add_pointer_t<reference> value_ = nullptr;
+			std::exception_ptr exception_;
+
+			friend class generator;
+		};
+
+		class iterator {
+		public:
+			using value_type = generator::value_type;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() = default;
+
+			auto operator*() const noexcept -> reference {
+				return static_cast<reference>(*coroutine_.promise().value_);
+			}
+
+			auto operator++() -> iterator& {
+				generator::advance(coroutine_);
+				return *this;
+			}
+
+			auto operator++(int) -> void {
+				++*this;
+			}
+
+			friend auto operator==(iterator const& it, std::default_sentinel_t) noexcept -> bool {
+				return it.coroutine_ == nullptr or it.coroutine_.done();
+			}
+
+		private:
+			explicit iterator(std::coroutine_handle<promise_type> coroutine) noexcept
+			: coroutine_(coroutine) {}
+
+			std::coroutine_handle<promise_type> coroutine_ = nullptr;
+
+			friend class generator;
+		};
+
+		generator() = default;
+
+		generator(generator&& other) noexcept
+		: coroutine_(std::exchange(other.coroutine_, nullptr))
+		, started_(other.started_) {}
+
+		auto operator=(generator&& other) noexcept -> generator& {
+			if (this != &other) {
+				destroy();
+				coroutine_ = std::exchange(other.coroutine_, nullptr);
+				started_ = other.started_;
+			}
+			return *this;
+		}
+
+		~generator() {
+			destroy();
+		}
+
+		// Runs the coroutine to its first value
+		auto begin() -> iterator {
+			if (coroutine_ != nullptr and not started_) {
+				started_ = true;
+				advance(coroutine_);
+			}
+			return iterator(coroutine_);
+		}
+
+		auto end() const noexcept -> std::default_sentinel_t {
+			return std::default_sentinel;
+		}
+
+	private:
+		explicit generator(std::coroutine_handle<promise_type> coroutine) noexcept
+		: coroutine_(coroutine) {}
+
+		static auto advance(std::coroutine_handle<promise_type> coroutine) -> void {
+			coroutine.resume();
+			if (auto const exception = std::exchange(coroutine.promise().exception_, nullptr)) {
+				std::rethrow_exception(exception);
+			}
+		}
+
+		auto destroy() noexcept -> void {
+			if (coroutine_ != nullptr) {
+				coroutine_.destroy();
+				coroutine_ = nullptr;
+			}
+		}
+
+		std::coroutine_handle<promise_type> coroutine_ = nullptr;
+		bool started_ = false;
+	};
+} // namespace gdwg
+
+#endif // coroutines
+
+#endif // GDWG_GENERATOR_HPP
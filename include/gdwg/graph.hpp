@@ -1,14 +1,56 @@
 #ifndef GDWG_GRAPH_HPP
 #define GDWG_GRAPH_HPP
 
+#include "gdwg/detail/parallel.hpp"
+
 #include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <numeric>
+#include <optional>
+#include <ranges>
 #include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace gdwg {
+	template<typename N, typename E>
+	class graph;
+
+	template<typename N, typename E>
+	class snapshot;
+
+	template<typename N, typename E>
+	auto transpose(graph<N, E> const& g, std::size_t threads = 0) -> graph<N, E>;
+
+	namespace detail {
+		template<typename N, typename E>
+		struct graph_access;
+
+		template<typename T>
+		concept hashable = requires(T const& value) {
+			{ std::hash<T>{}(value) } -> std::convertible_to<std::size_t>;
+		};
+	} // namespace detail
+
+	// Order of the edges returned by graph::top_k_out()
+	enum class weight_order {
+		ascending, // lightest first
+		descending, // heaviest first
+	};
+
 	template<typename N, typename E>
 	class graph {
 		class iterator;
@@ -20,59 +62,102 @@ namespace gdwg {
 			E weight;
 		};
 
+		// Order-independent 128-bit fingerprint of the nodes and edges of a graph
+		struct hash_type {
+			std::uint64_t low = 0;
+			std::uint64_t high = 0;
+
+			auto operator==(hash_type const&) const -> bool = default;
+		};
+
 		// Constructors
 		graph() = default;
 		
 		graph(std::initializer_list<N> il) : graph(il.begin(), il.end()) {}
 
+		// Moves the nodes in if the iterators yield rvalues, as std::move_iterator does
 		template<typename InputIt>
 		graph(InputIt first, InputIt last) : nodes_{}, repr_{} {
-			std::for_each(first, last, [&](auto const& value) { insert_node(value); });
+			for (; first != last; ++first) {
+				insert_node(*first);
+			}
 		}
 
 		graph(graph&& other) noexcept 
 		: nodes_{std::exchange(other.nodes_, {})}
-		, repr_{std::exchange(other.repr_, {})} {}
+		, repr_{std::exchange(other.repr_, {})}
+		, num_edges_{std::exchange(other.num_edges_, 0)}
+		, hash_{std::exchange(other.hash_, {})}
+		, weight_index_{std::exchange(other.weight_index_, std::nullopt)} {}
 
-		graph(graph const& other) : nodes_{other.nodes_}, repr_{other.repr_} {}
+		graph(graph const& other)
+		: nodes_{other.nodes_}
+		, repr_{other.repr_}
+		, num_edges_{other.num_edges_}
+		, hash_{other.hash_}
+		, weight_index_{other.weight_index_} {}
 
 		auto operator=(graph&& other) noexcept -> graph& {
 			std::swap(this->nodes_, other.nodes_);
 			std::swap(this->repr_, other.repr_);
+			std::swap(this->num_edges_, other.num_edges_);
+			std::swap(this->hash_, other.hash_);
+			std::swap(this->weight_index_, other.weight_index_);
 			return *this;
 		}
 
 		auto operator=(graph const& other) -> graph& {
 			this->nodes_ = other.nodes_;
 			this->repr_ = other.repr_;
+			this->num_edges_ = other.num_edges_;
+			this->hash_ = other.hash_;
+			this->weight_index_ = other.weight_index_;
 			return *this;
 		}
 
 		// Modifiers
 
+		// Inserting a node or edge that already exists copies and allocates nothing: the graph is
+		// searched first, and the value is only copied or moved in once it is known to be new.
+
 		auto insert_node(N const& value) -> bool {
-			auto const& node_ptr = std::make_shared<N>(value);
-			auto const& ret = nodes_.insert(node_ptr);
-			if (ret.second) { // Only continues if node does not exist
-				repr_.emplace(node_ptr.get(), std::set<std::pair<N*, E>, EdgeCompare>{});
-				return true;
-			}
-			return false;
+			return insert_new_node(value);
 		}
 
-		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
-			auto const& src_node = repr_.find(src);
-			auto const& dst_node = repr_.find(dst);
-			if (src_node != repr_.end() and dst_node != repr_.end()) {
-				auto const& ret = src_node->second.emplace(dst_node->first, weight);
-				return ret.second; // Returns true only if insertion took place
+		auto insert_node(N&& value) -> bool {
+			return insert_new_node(std::move(value)); // value is left alone if it already exists
+		}
+
+		// Builds the node from args if it is new. A single argument that can be ordered against N
+		// (such as a char const* for std::string nodes) is looked up first, so a duplicate builds
+		// and allocates nothing; it must order the same as the N it builds. Any other arguments
+		// build the node before the lookup, so a duplicate may still allocate.
+		template<typename... Args>
+		requires std::constructible_from<N, Args...>
+		auto emplace_node(Args&&... args) -> bool {
+			if constexpr ((sizeof...(Args) == 1) and (ordered_with_node<Args> and ...)) {
+				return insert_new_node_by(args..., std::forward<Args>(args)...);
 			}
 			else {
-				throw std::runtime_error("Cannot call gdwg::graph<N, E>::insert_edge when either src or "
-										"dst node does not exist");
+				return insert_new_node(N(std::forward<Args>(args)...));
 			}
 		}
 
+		auto insert_edge(N const& src, N const& dst, E const& weight) -> bool {
+			return insert_new_edge(src, dst, weight, "insert_edge");
+		}
+
+		auto insert_edge(N const& src, N const& dst, E&& weight) -> bool {
+			return insert_new_edge(src, dst, std::move(weight), "insert_edge");
+		}
+
+		// Builds the weight from args, then moves it in if the edge is new
+		template<typename... Args>
+		requires std::constructible_from<E, Args...>
+		auto emplace_edge(N const& src, N const& dst, Args&&... args) -> bool {
+			return insert_new_edge(src, dst, E(std::forward<Args>(args)...), "emplace_edge");
+		}
+
 		auto replace_node(N const& old_data, N const& new_data) -> bool {
 			// Check old node exists on graph, or otherwise throw an exception
 			auto const& old_node = nodes_.find(old_data);
@@ -85,24 +170,41 @@ namespace gdwg {
 					return false;
 				}
 
+				auto* const old_ptr = (*old_node).get();
+				auto* const new_ptr = node_ptr.get();
+				track_node_inserted(new_ptr);
+
 				// Update the existing directed edges
 				std::for_each(repr_.begin(), repr_.end(), [&](auto& key_value) {
+					auto* const src = key_value.first == old_ptr ? new_ptr : key_value.first;
+					// Every incoming edge is extracted out of the set of edges before any is
+					// reinserted, since a reinserted edge may sort after the rest of the range.
+					// Its destination is then changed to the new node and it is reinserted.
 					auto& edges = key_value.second;
-					// For each old edge, extract it out of the set of edges,
-					// change the destination node to the new node,
-					// and reinsert it into the set of edges
-					auto [begin, end] = edges.equal_range((*old_node).get());
-					std::for_each(begin, end, [&](auto& edge) {
-						auto tmp = edges.extract(edge);
-						tmp.value().first = node_ptr.get();
+					auto [begin, end] = edges.equal_range(old_ptr);
+					auto moved = std::vector<typename edge_set::node_type>();
+					while (begin != end) {
+						track_edge_erased(key_value.first, old_ptr, begin->second);
+						moved.push_back(edges.extract(begin++));
+					}
+					for (auto& tmp : moved) {
+						tmp.value().first = new_ptr;
+						track_edge_inserted(src, new_ptr, tmp.value().second);
 						edges.insert(std::move(tmp));
-					});
+					}
 				});
 				// Replace the directed edges outgoing from the old node
-				auto tmp = repr_.extract((*old_node).get());
-				tmp.key() = node_ptr.get();
+				auto tmp = repr_.extract(old_ptr);
+				for (auto const& [to, weight] : tmp.mapped()) {
+					if (to != new_ptr) { // Reflexive edges were re-keyed above
+						track_edge_erased(old_ptr, to, weight);
+						track_edge_inserted(new_ptr, to, weight);
+					}
+				}
+				tmp.key() = new_ptr;
 				repr_.insert(std::move(tmp));
 
+				track_node_erased(old_ptr);
 				nodes_.erase(old_node);
 				return true;
 			}
@@ -120,26 +222,45 @@ namespace gdwg {
 				if (old_node == new_node) {
 					return; // Abort if nodes are the same
 				}
+				auto* const old_ptr = old_node->first;
+				auto* const new_ptr = new_node->first;
+
 				// Update the existing directed edges
 				std::for_each(repr_.begin(), repr_.end(), [&](auto& key_value) {
 					auto& edges = key_value.second;
 					// For each old edge, extract it out of the set of edges,
 					// change the destination node to the new node,
 					// and reinsert it into the set of edges
-					auto [begin, end] = edges.equal_range(old_node->first);
-					std::for_each(begin, end, [&](auto& edge) {
-						auto tmp = edges.extract(edge);
-						tmp.value().first = new_node->first;
-						edges.insert(std::move(tmp));
+					auto [begin, end] = edges.equal_range(old_ptr);
+					auto moved = std::vector<typename edge_set::node_type>();
+					while (begin != end) {
+						track_edge_erased(key_value.first, old_ptr, begin->second);
+						moved.push_back(edges.extract(begin++));
+					}
+					for (auto& tmp : moved) {
+						tmp.value().first = new_ptr;
+						auto const& ret = edges.insert(std::move(tmp));
 						// If edge does not insert (since it if it already exists),
 						// edge will be removed by destructor of node handler at the end of the loop
-					});
+						if (ret.inserted) {
+							track_edge_inserted(key_value.first, new_ptr, ret.position->second);
+						}
+					}
 				});
 				// Replace the directed edges outgoing from the old node.
 				// Since key already exists, merge all edges to existing key
 				// and delete key of old node
-				new_node->second.merge(old_node->second);
+				auto& old_edges = old_node->second;
+				while (not old_edges.empty()) {
+					auto tmp = old_edges.extract(old_edges.begin());
+					track_edge_erased(old_ptr, tmp.value().first, tmp.value().second);
+					auto const& ret = new_node->second.insert(std::move(tmp));
+					if (ret.inserted) {
+						track_edge_inserted(new_ptr, ret.position->first, ret.position->second);
+					}
+				}
 
+				track_node_erased(old_ptr);
 				repr_.erase(old_node->first);
 				nodes_.erase(nodes_.find(old_data));
 			}
@@ -152,22 +273,22 @@ namespace gdwg {
 		auto erase_node(N const& value) noexcept -> bool {
 			auto const& node = nodes_.find(value);
 			if (node != nodes_.end()) {
+				auto* const node_ptr = (*node).get();
 				// Erase all incoming edges
 				for (auto& [src, edges] : repr_) {
-					for (auto it = edges.find((*node).get()); it != edges.end(); ++it) {
-						if (*(it->first) == **node) {
-							it = edges.erase(it);
-							if (it == edges.end()) {
-								break;
-							}
-						}
-						else {
-							break;
-						}
+					auto [begin, end] = edges.equal_range(node_ptr);
+					for (auto it = begin; it != end; ++it) {
+						track_edge_erased(src, node_ptr, it->second);
 					}
+					edges.erase(begin, end);
 				}
 				// Erase all outgoing edges and the node
-				repr_.erase((*node).get());
+				auto const& outgoing = repr_.find(node_ptr);
+				for (auto const& [to, weight] : outgoing->second) {
+					track_edge_erased(node_ptr, to, weight);
+				}
+				repr_.erase(outgoing);
+				track_node_erased(node_ptr);
 				nodes_.erase(node);
 
 				return true;
@@ -184,8 +305,14 @@ namespace gdwg {
 			auto const& src_node = repr_.find(src);
 			auto const& dst_node = repr_.find(dst);
 			if (src_node != repr_.end() and dst_node != repr_.end()) {
-				auto const& ret = src_node->second.erase(std::make_pair(dst_node->first, weight));
-				return (ret == 1); // Return true if edge is successfully erased
+				auto& edges = src_node->second;
+				auto const& edge = edges.find(std::make_pair(dst_node->first, weight));
+				if (edge == edges.end()) {
+					return false;
+				}
+				track_edge_erased(src_node->first, dst_node->first, weight);
+				edges.erase(edge);
+				return true; // Return true if edge is successfully erased
 			}
 			else {
 				throw std::runtime_error("Cannot call gdwg::graph<N, E>::erase_edge on src or dst if they "
@@ -200,6 +327,7 @@ namespace gdwg {
 			auto copy = i;
 			++copy;
 			auto non_const_outer = repr_.erase(i.outer_, i.outer_);
+			track_edge_erased(non_const_outer->first, i.inner_->first, i.inner_->second);
 			non_const_outer->second.erase(i.inner_); // Amortised O(1) solution
 			return copy;
 		}
@@ -214,6 +342,392 @@ namespace gdwg {
 		auto clear() noexcept -> void {
 			repr_.clear();
 			nodes_.clear();
+			num_edges_ = 0;
+			hash_ = {};
+			if (weight_index_) {
+				weight_index_->clear();
+			}
+		}
+
+		// Adds every node and edge of other that is not already in this graph. Both graphs keep
+		// their nodes and edge sets sorted by the same comparators, so this is a single sorted
+		// merge: each missing node or edge is inserted with a hint at the position the merge has
+		// reached, which is amortised O(1). New nodes share their values with other.
+		auto merge(graph const& other) -> void {
+			// Time complexity
+			//        merge nodes    - n1 + n2 +
+			//        merge edges    - e1 + e2
+			//     = O(n1 + n2 + e1 + e2) solution
+			if (&other == this) {
+				return;
+			}
+			auto remap = std::unordered_map<N const*, N*>(other.repr_.size());
+			auto node = nodes_.begin();
+			auto entry = repr_.begin();
+			for (auto const& other_node : other.nodes_) {
+				auto* const ptr = other_node.get();
+				while (node != nodes_.end() and **node < *ptr) {
+					++node;
+					++entry;
+				}
+				if (node != nodes_.end() and not(*ptr < **node)) {
+					remap.emplace(ptr, node->get());
+				}
+				else {
+					nodes_.emplace_hint(node, other_node);
+					repr_.emplace_hint(entry, ptr, edge_set{});
+					track_node_inserted(ptr);
+					remap.emplace(ptr, ptr);
+				}
+			}
+
+			// Every source of other now has an edge set here, in the same order
+			entry = repr_.begin();
+			for (auto const& [src, edges] : other.repr_) {
+				auto* const this_src = remap.find(src)->second;
+				while (entry->first != this_src) {
+					++entry;
+				}
+				auto& into = entry->second;
+				auto hint = into.begin();
+				for (auto const& [dst, weight] : edges) {
+					auto const edge = std::make_pair(remap.find(dst)->second, weight);
+					while (hint != into.end() and EdgeCompare{}(*hint, edge)) {
+						++hint;
+					}
+					if (hint != into.end() and not EdgeCompare{}(edge, *hint)) {
+						continue; // Already in this graph
+					}
+					into.emplace_hint(hint, edge);
+					track_edge_inserted(this_src, edge.first, weight);
+				}
+			}
+		}
+
+		// As above, but the nodes, edge sets and edges of other are spliced in as node handles
+		// rather than copied, so no N or E value is copied or allocated; only the bookkeeping that
+		// maps other's nodes to this graph's is. other is left empty.
+		auto merge(graph&& other) -> void {
+			// Time complexity
+			//        merge nodes    - n1 + n2 +
+			//        merge edges    - e1 + e2
+			//     = O(n1 + n2 + e1 + e2) solution
+			if (&other == this) {
+				return;
+			}
+			auto remap = std::unordered_map<N const*, N*>(other.repr_.size());
+			auto adopted = std::vector<N*>();
+			auto node = nodes_.begin();
+			auto entry = repr_.begin();
+			auto other_node = other.nodes_.begin();
+			auto other_entry = other.repr_.begin();
+			while (other_node != other.nodes_.end()) {
+				auto* const ptr = other_node->get();
+				while (node != nodes_.end() and **node < *ptr) {
+					++node;
+					++entry;
+				}
+				if (node != nodes_.end() and not(*ptr < **node)) {
+					remap.emplace(ptr, node->get());
+					++other_node;
+					++other_entry;
+				}
+				else {
+					// Moves the node together with its whole edge set
+					auto const next_node = std::next(other_node);
+					auto const next_entry = std::next(other_entry);
+					nodes_.insert(node, other.nodes_.extract(other_node));
+					repr_.insert(entry, other.repr_.extract(other_entry));
+					track_node_inserted(ptr);
+					remap.emplace(ptr, ptr);
+					adopted.push_back(ptr);
+					other_node = next_node;
+					other_entry = next_entry;
+				}
+			}
+
+			// Adopted edge sets may still point at other's copies of nodes both graphs had. The
+			// destinations are relinked in order, which keeps each set sorted.
+			entry = repr_.begin();
+			for (auto* const src : adopted) {
+				while (entry->first != src) {
+					++entry;
+				}
+				auto& edges = entry->second;
+				auto relinked = edge_set();
+				while (not edges.empty()) {
+					auto tmp = edges.extract(edges.begin());
+					tmp.value().first = remap.find(tmp.value().first)->second;
+					track_edge_inserted(src, tmp.value().first, tmp.value().second);
+					relinked.insert(relinked.end(), std::move(tmp));
+				}
+				edges.swap(relinked);
+			}
+
+			// What is left of other are the nodes both graphs had
+			entry = repr_.begin();
+			for (auto& [src, edges] : other.repr_) {
+				auto* const this_src = remap.find(src)->second;
+				while (entry->first != this_src) {
+					++entry;
+				}
+				auto& into = entry->second;
+				auto hint = into.begin();
+				while (not edges.empty()) {
+					auto tmp = edges.extract(edges.begin());
+					tmp.value().first = remap.find(tmp.value().first)->second;
+					while (hint != into.end() and EdgeCompare{}(*hint, tmp.value())) {
+						++hint;
+					}
+					if (hint != into.end() and not EdgeCompare{}(tmp.value(), *hint)) {
+						continue; // Already in this graph, so the handle is dropped
+					}
+					track_edge_inserted(this_src, tmp.value().first, tmp.value().second);
+					into.insert(hint, std::move(tmp));
+				}
+			}
+			other.clear();
+		}
+
+		// Bulk modifiers
+		//
+		// The new values are sorted first, so that the node set and each edge set are filled in a
+		// single pass of hinted insertion, which is amortised O(1) per element, rather than with
+		// a separate search per element. Both return how many nodes or edges were inserted.
+
+		template<std::ranges::input_range Range>
+		requires std::convertible_to<std::ranges::range_reference_t<Range>, N>
+		auto insert_nodes(Range&& values) -> std::size_t {
+			// Time complexity
+			//        sort values    - k log(k) +
+			//        merge          - n + k
+			//     = O(n + k log(k)) solution
+			auto sorted = std::vector<N>();
+			for (auto&& value : values) {
+				sorted.emplace_back(std::forward<decltype(value)>(value));
+			}
+			if (not std::is_sorted(sorted.begin(), sorted.end())) {
+				std::sort(sorted.begin(), sorted.end());
+			}
+			sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+			auto inserted = std::size_t{0};
+			auto node = nodes_.begin();
+			auto entry = repr_.begin();
+			for (auto& value : sorted) {
+				while (node != nodes_.end() and **node < value) {
+					++node;
+					++entry;
+				}
+				if (node != nodes_.end() and not(value < **node)) {
+					continue; // Already in the graph
+				}
+				auto const& node_ptr = std::make_shared<N>(std::move(value));
+				nodes_.emplace_hint(node, node_ptr);
+				repr_.emplace_hint(entry, node_ptr.get(), edge_set{});
+				track_node_inserted(node_ptr.get());
+				++inserted;
+			}
+			return inserted;
+		}
+
+		// Every edge's src and dst must exist, which is checked before any edge is inserted. A
+		// threads value other than 1 looks up nodes and fills the edge sets of different sources
+		// concurrently; 0 uses every hardware thread.
+		template<std::ranges::input_range Range>
+		requires std::convertible_to<std::ranges::range_reference_t<Range>, value_type>
+		auto insert_edges(Range&& edges, std::size_t threads = 1) -> std::size_t {
+			// Time complexity
+			//        sort edges          - k log(k) +
+			//        look up nodes       - k log(n) +
+			//        fill edge sets      - k + d (existing edges of the sources touched)
+			//     = O(k log(k) + k log(n) + d) solution
+			auto sorted = std::vector<value_type>();
+			if constexpr (std::same_as<Range, std::vector<value_type>>) {
+				sorted = std::move(edges); // Taken by rvalue, so its storage is reused
+			}
+			else {
+				for (auto&& edge : edges) {
+					sorted.emplace_back(std::forward<decltype(edge)>(edge));
+				}
+			}
+			std::sort(sorted.begin(), sorted.end(), [](value_type const& lhs, value_type const& rhs) {
+				if (not(lhs.from == rhs.from)) {
+					return lhs.from < rhs.from;
+				}
+				if (not(lhs.to == rhs.to)) {
+					return lhs.to < rhs.to;
+				}
+				return lhs.weight < rhs.weight;
+			});
+
+			// Edges from one source form a run, which becomes one task
+			struct run {
+				N* src;
+				edge_set* into;
+				std::size_t begin;
+				std::size_t end;
+			};
+			auto runs = std::vector<run>();
+			for (auto i = std::size_t{0}; i < sorted.size(); ++i) {
+				if (runs.empty() or not(sorted[i].from == *runs.back().src)) {
+					auto const& src_node = repr_.find(sorted[i].from);
+					if (src_node == repr_.end()) {
+						throw_missing_bulk_edge_node();
+					}
+					runs.push_back({src_node->first, &src_node->second, i, i});
+				}
+				runs.back().end = i + 1;
+			}
+			auto dsts = std::vector<N*>(sorted.size());
+			detail::parallel_for(
+			   sorted.size(),
+			   threads,
+			   [&](std::size_t i, std::size_t) {
+				   auto const& dst_node = repr_.find(sorted[i].to);
+				   if (dst_node == repr_.end()) {
+					   throw_missing_bulk_edge_node();
+				   }
+				   dsts[i] = dst_node->first;
+			   },
+			   1024);
+
+			auto tallies = std::vector<edge_tally>(runs.size());
+			detail::parallel_for(runs.size(), threads, [&](std::size_t r, std::size_t) {
+				auto const& task = runs[r];
+				auto& into = *task.into;
+				auto hint = into.begin();
+				for (auto i = task.begin; i < task.end; ++i) {
+					auto edge = std::make_pair(dsts[i], std::move(sorted[i].weight));
+					while (hint != into.end() and EdgeCompare{}(*hint, edge)) {
+						++hint;
+					}
+					if (hint != into.end() and not EdgeCompare{}(edge, *hint)) {
+						continue; // Already in the graph, or a repeated edge
+					}
+					// The hint stays on the new edge, so that a repeat of it is seen next time
+					hint = into.emplace_hint(hint, std::move(edge));
+					tallies[r].add(*task.src, *hint->first, hint->second);
+				}
+			});
+			auto inserted = std::size_t{0};
+			for (auto const& tally : tallies) {
+				absorb(tally);
+				inserted += tally.count;
+			}
+			if (weight_index_) {
+				auto sources = std::vector<N*>(runs.size());
+				std::transform(runs.begin(), runs.end(), sources.begin(), [](run const& task) {
+					return task.src;
+				});
+				index_weights(sources, threads);
+			}
+			return inserted;
+		}
+
+		// Erasing a node one at a time sweeps every edge set for its incoming edges. Both bulk
+		// erasers instead decide what goes first, then make a single pass over every edge set, so
+		// the cost is O(n + e) however many nodes or edges are erased. Both return how many nodes
+		// or edges were erased.
+
+		// Erases the nodes of the range that are in the graph, with all their edges
+		template<std::ranges::input_range Range>
+		requires std::convertible_to<std::ranges::range_reference_t<Range>, N>
+		auto erase_nodes(Range&& values) -> std::size_t {
+			// Time complexity
+			//        mark victims    - k log(n) +
+			//        sweep edges     - n + e +
+			//        erase nodes     - k log(n)
+			//     = O(n + e + k log(n)) solution
+			auto victims = std::unordered_set<N const*>();
+			for (auto&& value : values) {
+				auto const& node = nodes_.find(value);
+				if (node != nodes_.end()) {
+					victims.insert(node->get());
+				}
+			}
+			if (victims.empty()) {
+				return 0;
+			}
+
+			for (auto& [src, edges] : repr_) {
+				if (victims.contains(src)) {
+					for (auto const& [to, weight] : edges) {
+						track_edge_erased(src, to, weight);
+					}
+					continue; // The whole entry goes below
+				}
+				for (auto it = edges.begin(); it != edges.end();) {
+					if (victims.contains(it->first)) {
+						track_edge_erased(src, it->first, it->second);
+						it = edges.erase(it);
+					}
+					else {
+						++it;
+					}
+				}
+			}
+			for (auto const* const victim : victims) {
+				repr_.erase(repr_.find(*victim));
+				track_node_erased(victim);
+				nodes_.erase(nodes_.find(*victim));
+			}
+			return victims.size();
+		}
+
+		// Erases every edge for which pred(from, to, weight) returns true
+		template<typename Predicate>
+		requires std::predicate<Predicate&, N const&, N const&, E const&>
+		auto erase_edges_if(Predicate pred) -> std::size_t {
+			// Time complexity
+			//     = O(n + e) solution, plus O(log(d)) per erased edge with the weight index
+			auto erased = std::size_t{0};
+			for (auto& [src, edges] : repr_) {
+				for (auto it = edges.begin(); it != edges.end();) {
+					if (pred(*src, *it->first, it->second)) {
+						track_edge_erased(src, it->first, it->second);
+						it = edges.erase(it);
+						++erased;
+					}
+					else {
+						++it;
+					}
+				}
+			}
+			return erased;
+		}
+
+		// Gives every node the label mapping(node), all at once, so labels can be swapped or
+		// shifted. Nodes that end up with the same label are merged as merge_replace_node() does:
+		// the merged node keeps every edge of each of them, without duplicates. The labels are all
+		// computed before the graph is changed. Node values and edge allocations are reused, so
+		// only new labels are allocated.
+		template<typename Mapping>
+		requires std::invocable<Mapping&, N const&>
+		         and std::convertible_to<std::invoke_result_t<Mapping&, N const&>, N>
+		auto relabel(Mapping mapping) -> void {
+			auto labels = std::vector<std::pair<N, std::shared_ptr<N> const*>>();
+			labels.reserve(nodes_.size());
+			for (auto const& node : nodes_) {
+				labels.emplace_back(mapping(*node), &node);
+			}
+			relabel_nodes(labels);
+		}
+
+		// Relabels the nodes that are keys of mapping, such as a std::map<N, N>, leaving the rest
+		template<typename Mapping>
+		requires requires(Mapping const& mapping, N const& value) {
+			{ mapping.find(value)->second } -> std::convertible_to<N const&>;
+			mapping.find(value) == mapping.end();
+		}
+		auto relabel(Mapping const& mapping) -> void {
+			auto labels = std::vector<std::pair<N, std::shared_ptr<N> const*>>();
+			labels.reserve(nodes_.size());
+			for (auto const& node : nodes_) {
+				auto const& found = mapping.find(*node);
+				labels.emplace_back(found == mapping.end() ? *node : N(found->second), &node);
+			}
+			relabel_nodes(labels);
 		}
 
 		// Accessors
@@ -226,6 +740,21 @@ namespace gdwg {
 			return nodes_.empty() and repr_.empty();
 		}
 
+		[[nodiscard]] auto num_nodes() const noexcept -> std::size_t {
+			return nodes_.size(); // O(1) solution
+		}
+
+		[[nodiscard]] auto num_edges() const noexcept -> std::size_t {
+			return num_edges_; // O(1) solution, maintained by every modifier
+		}
+
+		// Equal graphs always have equal hashes. The hash is kept up to date by every modifier,
+		// so it can be read in O(1).
+		[[nodiscard]] auto hash() const noexcept -> hash_type
+		requires detail::hashable<N> and detail::hashable<E> {
+			return hash_;
+		}
+
 		[[nodiscard]] auto is_connected(N const& src, N const& dst) const -> bool {
 			auto const& src_node = repr_.find(src);
 			auto const& dst_node = repr_.find(dst);
@@ -327,6 +856,343 @@ namespace gdwg {
 			}
 		}
 
+		// Weight-ordered queries
+		//
+		// Edge sets are ordered by destination, so finding the heaviest or lightest edges of a
+		// source needs a scan of all of them. The weight index keeps a second copy of every edge
+		// set ordered by (weight, destination), maintained by every modifier, which answers these
+		// queries without a scan. It costs one tree entry per edge and slows insertion, so it is
+		// off until enabled. Copies and the results of filter(), induced_subgraph() and
+		// transpose() keep the index of the graph they came from. Both queries return the same
+		// edges, in the same order, with or without the index.
+
+		// A threads value other than 1 indexes different sources concurrently
+		auto enable_weight_index(std::size_t threads = 1) -> void {
+			// O(e log(d)) solution, sorting every edge set by weight
+			if (weight_index_) {
+				return;
+			}
+			auto sources = std::vector<N*>();
+			sources.reserve(repr_.size());
+			for (auto const& [src, edges] : repr_) {
+				sources.push_back(src);
+			}
+			weight_index_.emplace();
+			index_weights(sources, threads);
+		}
+
+		auto disable_weight_index() noexcept -> void {
+			weight_index_.reset();
+		}
+
+		[[nodiscard]] auto has_weight_index() const noexcept -> bool {
+			return weight_index_.has_value();
+		}
+
+		// The k lightest or heaviest outgoing edges of src, ordered by (weight, dst), or in
+		// reverse for weight_order::descending. Fewer are returned if src has fewer edges.
+		[[nodiscard]] auto top_k_out(N const& src,
+		                             std::size_t k,
+		                             weight_order order = weight_order::descending) const
+		   -> std::vector<value_type> {
+			// Time complexity
+			//        find src node    - log(n) +
+			//        with index       - k
+			//        without index    - d log(k)
+			//     = O(log(n) + k) solution with the index
+			auto const& src_node = repr_.find(src);
+			if (src_node == repr_.end()) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::top_k_out if src doesn't exist "
+				                         "in the graph");
+			}
+			auto result = std::vector<value_type>();
+			auto const emit = [&](auto first, auto last) {
+				for (; first != last and result.size() < k; ++first) {
+					result.push_back({*src_node->first, *first->second, first->first});
+				}
+			};
+			if (weight_index_) {
+				auto const& index = weight_index_->find(src_node->first);
+				if (index != weight_index_->end()) {
+					if (order == weight_order::ascending) {
+						emit(index->second.begin(), index->second.end());
+					}
+					else {
+						emit(index->second.rbegin(), index->second.rend());
+					}
+				}
+				return result;
+			}
+
+			auto const& edges = src_node->second;
+			auto sorted = std::vector<weight_entry>();
+			sorted.reserve(edges.size());
+			for (auto const& [to, weight] : edges) {
+				sorted.emplace_back(weight, to);
+			}
+			auto const count = static_cast<std::ptrdiff_t>(std::min(k, sorted.size()));
+			if (order == weight_order::ascending) {
+				std::partial_sort(sorted.begin(), sorted.begin() + count, sorted.end(), WeightCompare{});
+			}
+			else {
+				std::partial_sort(sorted.begin(),
+				                  sorted.begin() + count,
+				                  sorted.end(),
+				                  [](weight_entry const& lhs, weight_entry const& rhs) {
+					                  return WeightCompare{}(rhs, lhs);
+				                  });
+			}
+			emit(sorted.begin(), sorted.end());
+			return result;
+		}
+
+		// Outgoing edges of src with lo <= weight <= hi, ordered by (weight, dst)
+		[[nodiscard]] auto out_edges_in_weight_range(N const& src, E const& lo, E const& hi) const
+		   -> std::vector<value_type> {
+			// Time complexity
+			//        find src node    - log(n) +
+			//        with index       - log(d) + k
+			//        without index    - d + k log(k)
+			//     = O(log(n) + log(d) + k) solution with the index, for k edges in range
+			auto const& src_node = repr_.find(src);
+			if (src_node == repr_.end()) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::out_edges_in_weight_range if "
+				                         "src doesn't exist in the graph");
+			}
+			auto result = std::vector<value_type>();
+			if (hi < lo) {
+				return result;
+			}
+			if (weight_index_) {
+				auto const& index = weight_index_->find(src_node->first);
+				if (index != weight_index_->end()) {
+					auto const last = index->second.upper_bound(hi);
+					for (auto it = index->second.lower_bound(lo); it != last; ++it) {
+						result.push_back({*src_node->first, *it->second, it->first});
+					}
+				}
+				return result;
+			}
+
+			auto in_range = std::vector<weight_entry>();
+			for (auto const& [to, weight] : src_node->second) {
+				if (not(weight < lo) and not(hi < weight)) {
+					in_range.emplace_back(weight, to);
+				}
+			}
+			std::sort(in_range.begin(), in_range.end(), WeightCompare{});
+			for (auto const& [weight, to] : in_range) {
+				result.push_back({*src_node->first, *to, weight});
+			}
+			return result;
+		}
+
+		// Batched queries
+		//
+		// is_connected(), weights() and find() each search the node tree for both of their nodes.
+		// The batch versions sort the queries first and answer them in that order, so each search
+		// carries on from where the previous query's left off, and queries on the same or nearby
+		// nodes cost O(1) rather than O(log(n)) each. Results are written to the caller's outputs
+		// in the order of the queries, with no allocation per query. A threads value other than 1
+		// answers different parts of the sorted batch concurrently; 0 uses every hardware thread.
+
+		// out[i] = is_connected(queries[i].first, queries[i].second). Every node is checked
+		// before any result is written.
+		auto batch_is_connected(std::span<std::pair<N, N> const> queries,
+		                        std::span<bool> out,
+		                        std::size_t threads = 1) const -> void {
+			// Time complexity
+			//        sort queries     - k log(k) +
+			//        look up nodes    - k, for nearby nodes, up to k log(n) +
+			//        find edges       - k, for nearby nodes, up to k log(d)
+			//     = O(k log(k)) solution for clustered batches, O(k log(k) + k log(n)) at worst
+			if (out.size() != queries.size()) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::batch_is_connected with an "
+				                         "output of a different size to the queries");
+			}
+			auto const entries = look_up_batch(
+			   queries.size(),
+			   [&](std::size_t i) -> N const& { return queries[i].first; },
+			   [&](std::size_t i) -> N const& { return queries[i].second; },
+			   [](auto const&, auto const&) { return false; },
+			   threads);
+			throw_if_missing(entries,
+			                 "Cannot call gdwg::graph<N, E>::batch_is_connected if src or dst node "
+			                 "don't exist in the graph");
+			for_each_batch_edge(
+			   entries,
+			   threads,
+			   [](batch_entry const& entry) { return entry.dst; },
+			   [&](batch_entry const& entry, edge_iterator edge) {
+				   out[entry.query] = edge != entry.src->second.end() and edge->first == entry.dst;
+			   });
+		}
+
+		// The weights of queries[i] are weights[offsets[i]] to weights[offsets[i + 1]], in
+		// increasing order, as weights() would return them. offsets must be one longer than
+		// queries, and weights is resized to fit, so a reused vector doesn't allocate once it is
+		// large enough. Every node is checked before any result is written.
+		auto batch_weights(std::span<std::pair<N, N> const> queries,
+		                   std::span<std::size_t> offsets,
+		                   std::vector<E>& weights,
+		                   std::size_t threads = 1) const -> void {
+			// Time complexity
+			//     = O(k log(k) + w) solution for clustered batches, for w weights in total
+			if (offsets.size() != queries.size() + 1) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::batch_weights with offsets "
+				                         "that aren't one longer than the queries");
+			}
+			auto const entries = look_up_batch(
+			   queries.size(),
+			   [&](std::size_t i) -> N const& { return queries[i].first; },
+			   [&](std::size_t i) -> N const& { return queries[i].second; },
+			   [](auto const&, auto const&) { return false; },
+			   threads);
+			throw_if_missing(entries,
+			                 "Cannot call gdwg::graph<N, E>::batch_weights if src or dst node don't "
+			                 "exist in the graph");
+
+			// Count each query's weights, then copy them once their positions are known
+			auto firsts = std::vector<edge_iterator>(entries.size());
+			offsets[0] = 0;
+			for_each_batch_edge(
+			   entries,
+			   threads,
+			   [](batch_entry const& entry) { return entry.dst; },
+			   [&](batch_entry const& entry, edge_iterator edge) {
+				   firsts[entry.position] = edge;
+				   auto count = std::size_t{0};
+				   for (; edge != entry.src->second.end() and edge->first == entry.dst; ++edge) {
+					   ++count;
+				   }
+				   offsets[entry.query + 1] = count;
+			   });
+			for (auto i = std::size_t{0}; i < queries.size(); ++i) {
+				offsets[i + 1] += offsets[i];
+			}
+			weights.resize(offsets[queries.size()]);
+			detail::parallel_for(
+			   entries.size(),
+			   threads,
+			   [&](std::size_t i, std::size_t) {
+				   auto out = weights.begin() + static_cast<std::ptrdiff_t>(offsets[entries[i].query]);
+				   auto const last = weights.begin()
+				                     + static_cast<std::ptrdiff_t>(offsets[entries[i].query + 1]);
+				   for (auto edge = firsts[i]; out != last; ++edge, ++out) {
+					   *out = edge->second;
+				   }
+			   },
+			   batch_chunk);
+		}
+
+		// out[i] = find(queries[i].from, queries[i].to, queries[i].weight), which is end() if
+		// either node doesn't exist
+		auto batch_find(std::span<value_type const> queries,
+		                std::span<iterator> out,
+		                std::size_t threads = 1) const -> void {
+			// Time complexity
+			//     = O(k log(k)) solution for clustered batches, O(k log(k) + k log(n)) at worst
+			if (out.size() != queries.size()) {
+				throw std::runtime_error("Cannot call gdwg::graph<N, E>::batch_find with an output of "
+				                         "a different size to the queries");
+			}
+			auto const entries = look_up_batch(
+			   queries.size(),
+			   [&](std::size_t i) -> N const& { return queries[i].from; },
+			   [&](std::size_t i) -> N const& { return queries[i].to; },
+			   [&](std::size_t a, std::size_t b) { return queries[a].weight < queries[b].weight; },
+			   threads);
+			std::fill(out.begin(), out.end(), end()); // For queries with a missing node
+			for_each_batch_edge(
+			   entries,
+			   threads,
+			   [&](batch_entry const& entry) {
+				   return std::pair<N*, E>(entry.dst, queries[entry.query].weight);
+			   },
+			   [&](batch_entry const& entry, edge_iterator edge) {
+				   auto const& edges = entry.src->second;
+				   auto const found = edge != edges.end() and edge->first == entry.dst
+				                      and not(queries[entry.query].weight < edge->second)
+				                      and not(edge->second < queries[entry.query].weight);
+				   out[entry.query] = found ? iterator(repr_.end(), entry.src, edge) : end();
+			   });
+		}
+
+		// Subgraphs
+		//
+		// The result shares its node values with this graph, the same way a copy does, so no N is
+		// copied. Edge sets are rebuilt in sorted order with hinted insertion, which is amortised
+		// O(1) per edge. A threads value other than 1 builds the edge sets of different sources
+		// concurrently; 0 uses every hardware thread.
+
+		template<std::ranges::input_range Range>
+		[[nodiscard]] auto induced_subgraph(Range const& nodes, std::size_t threads = 1) const
+		   -> graph {
+			// Time complexity
+			//        find selected nodes    - k log(n) +
+			//        sort selected nodes    - k log(k) +
+			//        copy kept edges        - d (sum of degrees of selected nodes)
+			//     = O(k log(n) + d) solution
+			auto selected = std::vector<std::shared_ptr<N>>();
+			for (auto const& value : nodes) {
+				auto const& node = nodes_.find(value);
+				if (node == nodes_.end()) {
+					throw std::runtime_error("Cannot call gdwg::graph<N, E>::induced_subgraph on nodes "
+					                         "that don't exist in the graph");
+				}
+				selected.push_back(*node);
+			}
+			std::sort(selected.begin(), selected.end(), NodeCompare{});
+			selected.erase(std::unique(selected.begin(), selected.end()), selected.end());
+
+			auto members = std::unordered_set<N const*>(selected.size());
+			auto result = graph();
+			auto tasks = std::vector<edge_copy>();
+			tasks.reserve(selected.size());
+			for (auto const& node : selected) {
+				members.insert(node.get());
+				result.nodes_.emplace_hint(result.nodes_.end(), node);
+				auto const& dst = result.repr_.emplace_hint(result.repr_.end(), node.get(), edge_set{});
+				result.track_node_inserted(node.get());
+				tasks.push_back({node.get(), &repr_.find(node.get())->second, &dst->second});
+			}
+
+			copy_edges(result, tasks, threads, [&](N const*, std::pair<N*, E> const& edge) {
+				return members.contains(edge.first);
+			});
+			if (weight_index_) {
+				result.enable_weight_index(threads);
+			}
+			return result;
+		}
+
+		// Keeps every node, and the edges for which pred(from, to, weight) returns true
+		template<typename Predicate>
+		requires std::predicate<Predicate&, N const&, N const&, E const&>
+		[[nodiscard]] auto filter(Predicate pred, std::size_t threads = 1) const -> graph {
+			// Time complexity
+			//        copy nodes    - n +
+			//        test edges    - e
+			//     = O(n + e) solution
+			auto result = graph();
+			result.nodes_ = nodes_; // O(n) copy of a sorted tree
+			auto tasks = std::vector<edge_copy>();
+			tasks.reserve(repr_.size());
+			for (auto const& [src, edges] : repr_) {
+				auto const& dst = result.repr_.emplace_hint(result.repr_.end(), src, edge_set{});
+				result.track_node_inserted(src);
+				tasks.push_back({src, &edges, &dst->second});
+			}
+
+			copy_edges(result, tasks, threads, [&](N const* src, std::pair<N*, E> const& edge) {
+				return static_cast<bool>(pred(*src, *edge.first, edge.second));
+			});
+			if (weight_index_) {
+				result.enable_weight_index(threads);
+			}
+			return result;
+		}
+
 		// Iterator access
 
 		[[nodiscard]] auto begin() const -> iterator {
@@ -341,9 +1207,18 @@ namespace gdwg {
 
 		[[nodiscard]] auto operator==(graph const& other) const noexcept -> bool {
 			// Time complexity
-			//        nodes      - n +
-			//        edges      - e
+			//        counts and hash - 1 (for unequal graphs) +
+			//        nodes           - n +
+			//        edges           - e
 			//     = O(n + e) solution
+			if (this->num_nodes() != other.num_nodes() or this->num_edges_ != other.num_edges_) {
+				return false;
+			}
+			if constexpr (detail::hashable<N> and detail::hashable<E>) {
+				if (this->hash_ != other.hash_) {
+					return false;
+				}
+			}
 			auto nodes_are_equal =
 			std::equal(this->nodes_.begin(),
 						this->nodes_.end(),
@@ -372,6 +1247,11 @@ namespace gdwg {
 		using iterator = iterator; // custom iterator is defined private
 
 	private:
+		// A key that can be looked up among the nodes without first building an N from it
+		template<typename Key>
+		static constexpr auto ordered_with_node =
+		   std::totally_ordered_with<std::remove_cvref_t<Key> const&, N const&>;
+
 		// Data Structure and Custom Comparators
 
 		// Allow lexigraphical sorting of pointers based on their underlying values
@@ -386,6 +1266,16 @@ namespace gdwg {
 			auto operator()(std::shared_ptr<N> const& lhs, N const& rhs) const -> bool {
 				return *lhs < rhs;
 			}
+			template<typename Key>
+			requires ordered_with_node<Key> and (not std::same_as<Key, N>)
+			auto operator()(Key const& lhs, std::shared_ptr<N> const& rhs) const -> bool {
+				return lhs < *rhs;
+			}
+			template<typename Key>
+			requires ordered_with_node<Key> and (not std::same_as<Key, N>)
+			auto operator()(std::shared_ptr<N> const& lhs, Key const& rhs) const -> bool {
+				return *lhs < rhs;
+			}
 		};
 		struct MapCompare {
 			using is_transparent = void;
@@ -399,6 +1289,12 @@ namespace gdwg {
 				return *lhs < rhs;
 			}
 		};
+		// An edge to look up without copying its destination or weight
+		struct edge_key {
+			N const& dst;
+			E const& weight;
+		};
+
 		struct EdgeCompare {
 			using is_transparent = void;
 			auto operator()(std::pair<N*, E> const& lhs, std::pair<N*, E> const& rhs) const -> bool {
@@ -425,10 +1321,479 @@ namespace gdwg {
 			auto operator()(std::pair<N*, E> const& lhs, N* const& rhs) const -> bool {
 				return *(lhs.first) < *rhs;
 			}
+			auto operator()(edge_key const& lhs, std::pair<N*, E> const& rhs) const -> bool {
+				if (lhs.dst == *(rhs.first)) {
+					return lhs.weight < rhs.second;
+				}
+				return lhs.dst < *(rhs.first);
+			}
+			auto operator()(std::pair<N*, E> const& lhs, edge_key const& rhs) const -> bool {
+				if (*(lhs.first) == rhs.dst) {
+					return lhs.second < rhs.weight;
+				}
+				return *(lhs.first) < rhs.dst;
+			}
 		};
 
+		using edge_set = std::set<std::pair<N*, E>, EdgeCompare>;
+
+		// Orders the edges of one source by (weight, dst) for the weight index. A lone weight
+		// compares against the weight of an entry, to find where a range of weights starts.
+		using weight_entry = std::pair<E, N const*>;
+		struct WeightCompare {
+			using is_transparent = void;
+			auto operator()(weight_entry const& lhs, weight_entry const& rhs) const -> bool {
+				if (lhs.first < rhs.first) {
+					return true;
+				}
+				if (rhs.first < lhs.first) {
+					return false;
+				}
+				return *(lhs.second) < *(rhs.second);
+			}
+			auto operator()(E const& lhs, weight_entry const& rhs) const -> bool {
+				return lhs < rhs.first;
+			}
+			auto operator()(weight_entry const& lhs, E const& rhs) const -> bool {
+				return lhs.first < rhs;
+			}
+		};
+
+		using weight_set = std::set<weight_entry, WeightCompare>;
+
 		std::set<std::shared_ptr<N>, NodeCompare> nodes_;
-		std::map<N*, std::set<std::pair<N*, E>, EdgeCompare>, MapCompare> repr_;
+		std::map<N*, edge_set, MapCompare> repr_;
+		std::size_t num_edges_ = 0;
+		hash_type hash_ = {};
+		// Sources without edges have no entry. Empty unless enabled.
+		std::optional<std::unordered_map<N const*, weight_set>> weight_index_;
+
+		// Copies the kept edges of each task's source into the matching (empty) edge set of
+		// result, keeping result's edge count and hash in step
+		struct edge_copy {
+			N* src;
+			edge_set const* from;
+			edge_set* to;
+		};
+
+		template<typename Keep>
+		auto copy_edges(graph& result,
+		                std::vector<edge_copy> const& tasks,
+		                std::size_t threads,
+		                Keep keep) const -> void {
+			auto tallies = std::vector<edge_tally>(tasks.size());
+			detail::parallel_for(tasks.size(), threads, [&](std::size_t i, std::size_t) {
+				auto const& task = tasks[i];
+				for (auto const& edge : *task.from) {
+					if (keep(task.src, edge)) {
+						task.to->emplace_hint(task.to->end(), edge);
+						tallies[i].add(*task.src, *edge.first, edge.second);
+					}
+				}
+			});
+			for (auto const& tally : tallies) {
+				result.absorb(tally);
+			}
+		}
+
+		template<typename Value>
+		auto insert_new_node(Value&& value) -> bool {
+			return insert_new_node_by(value, std::forward<Value>(value));
+		}
+
+		// Inserts the node built from args unless a node equal to key already exists
+		template<typename Key, typename... Args>
+		auto insert_new_node_by(Key const& key, Args&&... args) -> bool {
+			// Time complexity
+			//        find position    - log(n) +
+			//        insert           - log(n), and nothing for an existing node
+			//     = O(log(n)) solution
+			auto const hint = nodes_.lower_bound(key);
+			if (hint != nodes_.end() and not(key < **hint)) {
+				return false;
+			}
+			auto node_ptr = std::make_shared<N>(std::forward<Args>(args)...);
+			auto* const node = node_ptr.get();
+			nodes_.emplace_hint(hint, std::move(node_ptr));
+			repr_.emplace(node, edge_set{});
+			track_node_inserted(node);
+			return true;
+		}
+
+		template<typename Weight>
+		auto insert_new_edge(N const& src, N const& dst, Weight&& weight, char const* name) -> bool {
+			auto const& src_node = repr_.find(src);
+			auto const& dst_node = repr_.find(dst);
+			if (src_node == repr_.end() or dst_node == repr_.end()) {
+				throw std::runtime_error(std::string("Cannot call gdwg::graph<N, E>::") + name
+				                         + " when either src or dst node does not exist");
+			}
+			auto& edges = src_node->second;
+			auto const key = edge_key{*dst_node->first, weight};
+			auto const hint = edges.lower_bound(key);
+			if (hint != edges.end() and not EdgeCompare{}(key, *hint)) {
+				return false;
+			}
+			auto const& edge = edges.emplace_hint(hint, dst_node->first, std::forward<Weight>(weight));
+			track_edge_inserted(src_node->first, dst_node->first, edge->second);
+			return true;
+		}
+
+		// Rebuilds the graph with labels[i].first as the label of the node labels[i].second. The
+		// old edge sets are emptied into the new ones by moving their node handles, and the edge
+		// count, hash and weight index are rebuilt from scratch.
+		auto relabel_nodes(std::vector<std::pair<N, std::shared_ptr<N> const*>>& labels) -> void {
+			// Time complexity
+			//        sort labels        - n log(n) +
+			//        move edges         - e log(d) +
+			//        rebuild tracking   - n + e (plus e log(d) with the weight index)
+			//     = O(n log(n) + e log(d)) solution
+			std::stable_sort(labels.begin(), labels.end(), [](auto const& lhs, auto const& rhs) {
+				return lhs.first < rhs.first;
+			});
+
+			// Nodes with equal labels form a group, which becomes one node. A member that
+			// already has the label keeps its value, so unchanged nodes aren't reallocated.
+			struct target {
+				N* node;
+				edge_set* edges;
+			};
+			auto remap = std::unordered_map<N const*, target>(labels.size());
+			auto nodes = std::set<std::shared_ptr<N>, NodeCompare>();
+			auto repr = std::map<N*, edge_set, MapCompare>();
+			for (auto begin = std::size_t{0}; begin < labels.size();) {
+				auto end = begin + 1;
+				while (end < labels.size() and not(labels[begin].first < labels[end].first)) {
+					++end;
+				}
+				auto kept = std::shared_ptr<N>();
+				for (auto i = begin; i < end; ++i) {
+					if (**labels[i].second == labels[i].first) {
+						kept = *labels[i].second;
+					}
+				}
+				if (not kept) {
+					kept = std::make_shared<N>(std::move(labels[begin].first));
+				}
+				auto const& entry = repr.emplace_hint(repr.end(), kept.get(), edge_set{});
+				for (auto i = begin; i < end; ++i) {
+					remap.emplace(labels[i].second->get(), target{kept.get(), &entry->second});
+				}
+				nodes.emplace_hint(nodes.end(), std::move(kept));
+				begin = end;
+			}
+
+			// Every edge handle is moved into the edge set of its source's group, sorted
+			auto moved = std::vector<typename edge_set::node_type>();
+			for (auto begin = std::size_t{0}; begin < labels.size();) {
+				auto const& into = remap.find(labels[begin].second->get())->second;
+				moved.clear();
+				for (; begin < labels.size()
+				       and remap.find(labels[begin].second->get())->second.node == into.node;
+				     ++begin) {
+					auto& edges = repr_.find(labels[begin].second->get())->second;
+					while (not edges.empty()) {
+						moved.push_back(edges.extract(edges.begin()));
+						moved.back().value().first = remap.find(moved.back().value().first)->second.node;
+					}
+				}
+				std::stable_sort(moved.begin(), moved.end(), [](auto const& lhs, auto const& rhs) {
+					return EdgeCompare{}(lhs.value(), rhs.value());
+				});
+				for (auto& handle : moved) {
+					auto& edges = *into.edges;
+					if (edges.empty() or EdgeCompare{}(*std::prev(edges.end()), handle.value())) {
+						edges.insert(edges.end(), std::move(handle));
+					}
+				}
+			}
+
+			auto const indexed = weight_index_.has_value();
+			weight_index_.reset();
+			repr_ = std::move(repr);
+			nodes_ = std::move(nodes);
+			num_edges_ = 0;
+			hash_ = {};
+			for (auto const& [src, edges] : repr_) {
+				track_node_inserted(src);
+				for (auto const& [to, weight] : edges) {
+					track_edge_inserted(src, to, weight);
+				}
+			}
+			if (indexed) {
+				enable_weight_index();
+			}
+		}
+
+		// Edge count and hash of edges inserted by a bulk operation, accumulated per task so that
+		// tasks can run concurrently and be absorbed into the graph afterwards
+		struct edge_tally {
+			std::size_t count = 0;
+			hash_type hash = {};
+
+			auto add(N const& src, N const& dst, E const& weight) noexcept -> void {
+				++count;
+				if constexpr (detail::hashable<N> and detail::hashable<E>) {
+					auto const h = edge_hash(src, dst, weight);
+					hash.low += h.low;
+					hash.high += h.high;
+				}
+			}
+		};
+
+		auto absorb(edge_tally const& tally) noexcept -> void {
+			num_edges_ += tally.count;
+			add_hash(tally.hash);
+		}
+
+		[[noreturn]] static auto throw_missing_bulk_edge_node() -> void {
+			throw std::runtime_error("Cannot call gdwg::graph<N, E>::insert_edges when either src or "
+			                         "dst node does not exist");
+		}
+
+		// A query of a batch with its nodes looked up, where a missing src is repr_.end() and a
+		// missing dst is nullptr. Entries are in sorted order, and position is the entry's own
+		// index.
+		using node_iterator = typename std::map<N*, edge_set, MapCompare>::const_iterator;
+		using edge_iterator = typename edge_set::const_iterator;
+		struct batch_entry {
+			node_iterator src;
+			N* dst;
+			std::size_t query;
+			std::size_t position;
+		};
+
+		// Queries per task, and how many entries a walk steps over before it searches instead
+		static constexpr auto batch_chunk = std::size_t{1024};
+		static constexpr auto batch_steps = 8;
+
+		// Moves it forward to the first element that less() is false for. Sorted queries mostly
+		// move a short way, so stepping is tried before a search of the whole tree.
+		template<typename Iterator, typename Less, typename Search>
+		static auto seek(Iterator it, Iterator end, bool fresh, Less less, Search search) -> Iterator {
+			if (not fresh) {
+				for (auto step = 0; step < batch_steps; ++step, ++it) {
+					if (it == end or not less(*it)) {
+						return it;
+					}
+				}
+			}
+			return search();
+		}
+
+		// Sorts the queries by (src, dst), then by tie, and looks up their nodes. Destinations
+		// are looked up in their own sorted order, so both lookups are walks along repr_.
+		template<typename Src, typename Dst, typename Tie>
+		auto look_up_batch(std::size_t k, Src src_of, Dst dst_of, Tie tie, std::size_t threads) const
+		   -> std::vector<batch_entry> {
+			auto order = std::vector<std::size_t>(k);
+			std::iota(order.begin(), order.end(), std::size_t{0});
+			auto const by_query = [&](std::size_t a, std::size_t b) {
+				if (not(src_of(a) == src_of(b))) {
+					return src_of(a) < src_of(b);
+				}
+				if (not(dst_of(a) == dst_of(b))) {
+					return dst_of(a) < dst_of(b);
+				}
+				return tie(a, b);
+			};
+			if (not std::is_sorted(order.begin(), order.end(), by_query)) {
+				std::sort(order.begin(), order.end(), by_query);
+			}
+			auto by_dst = order;
+			std::stable_sort(by_dst.begin(), by_dst.end(), [&](std::size_t a, std::size_t b) {
+				return dst_of(a) < dst_of(b);
+			});
+
+			// Each chunk walks repr_ from its own starting point, for both lookups at once
+			auto dsts = std::vector<N*>(k);
+			auto entries = std::vector<batch_entry>(k);
+			auto const look_up = [&](node_iterator it, N const& value, bool fresh) {
+				return seek(
+				   it,
+				   repr_.end(),
+				   fresh,
+				   [&](auto const& entry) { return *entry.first < value; },
+				   [&] { return repr_.lower_bound(value); });
+			};
+			auto const found = [&](node_iterator it, N const& value) {
+				return it != repr_.end() and not(value < *it->first);
+			};
+			detail::parallel_for(
+			   (k + batch_chunk - 1) / batch_chunk,
+			   threads,
+			   [&](std::size_t chunk, std::size_t) {
+				   auto src = repr_.end();
+				   auto dst = repr_.end();
+				   auto const first = chunk * batch_chunk;
+				   for (auto i = first; i < std::min(k, first + batch_chunk); ++i) {
+					   src = look_up(src, src_of(order[i]), i == first);
+					   dst = look_up(dst, dst_of(by_dst[i]), i == first);
+					   entries[i].src = found(src, src_of(order[i])) ? src : repr_.end();
+					   entries[i].query = order[i];
+					   entries[i].position = i;
+					   dsts[by_dst[i]] = found(dst, dst_of(by_dst[i])) ? dst->first : nullptr;
+				   }
+			   },
+			   1);
+			for (auto& entry : entries) {
+				entry.dst = dsts[entry.query];
+			}
+			return entries;
+		}
+
+		auto throw_if_missing(std::vector<batch_entry> const& entries, char const* what) const -> void {
+			for (auto const& entry : entries) {
+				if (entry.src == repr_.end() or entry.dst == nullptr) {
+					throw std::runtime_error(what);
+				}
+			}
+		}
+
+		// Calls answer(entry, edge) for every entry with both nodes, where edge is the first edge
+		// of entry.src not less than key(entry), walking each source's edge set along with the
+		// sorted entries
+		template<typename Key, typename Answer>
+		auto for_each_batch_edge(std::vector<batch_entry> const& entries,
+		                         std::size_t threads,
+		                         Key key,
+		                         Answer answer) const -> void {
+			detail::parallel_for(
+			   (entries.size() + batch_chunk - 1) / batch_chunk,
+			   threads,
+			   [&](std::size_t chunk, std::size_t) {
+				   auto edge = edge_iterator();
+				   auto const first = chunk * batch_chunk;
+				   for (auto i = first; i < std::min(entries.size(), first + batch_chunk); ++i) {
+					   auto const& entry = entries[i];
+					   if (entry.src == repr_.end() or entry.dst == nullptr) {
+						   continue;
+					   }
+					   auto const& edges = entry.src->second;
+					   auto const fresh = i == first or entries[i - 1].src != entry.src
+					                      or entries[i - 1].dst == nullptr;
+					   auto const target = key(entry);
+					   edge = seek(
+					      edge,
+					      edges.end(),
+					      fresh,
+					      [&](auto const& element) { return EdgeCompare{}(element, target); },
+					      [&] { return edges.lower_bound(target); });
+					   answer(entry, edge);
+				   }
+			   },
+			   1);
+		}
+
+		// Rebuilds the weight index entries of the given distinct sources from their edge sets.
+		// Entries are created first, so that different sources can then be sorted concurrently.
+		auto index_weights(std::vector<N*> const& sources, std::size_t threads) -> void {
+			auto entries = std::vector<weight_set*>(sources.size(), nullptr);
+			for (auto i = std::size_t{0}; i < sources.size(); ++i) {
+				if (not repr_.find(sources[i])->second.empty()) {
+					entries[i] = &(*weight_index_)[sources[i]];
+				}
+			}
+			detail::parallel_for(sources.size(), threads, [&](std::size_t i, std::size_t) {
+				if (entries[i] == nullptr) {
+					return;
+				}
+				auto const& edges = repr_.find(sources[i])->second;
+				auto sorted = std::vector<weight_entry>();
+				sorted.reserve(edges.size());
+				for (auto const& [to, weight] : edges) {
+					sorted.emplace_back(weight, to);
+				}
+				std::sort(sorted.begin(), sorted.end(), WeightCompare{});
+				// Sorted input is inserted at the end in amortised O(1)
+				*entries[i] = weight_set(sorted.begin(), sorted.end());
+			});
+		}
+
+		// Bookkeeping shared by every modifier, keeping the edge count, hash and weight index in
+		// step. Each is called once per node or edge that is added to or removed from the graph,
+		// with the node pointers owned by nodes_, while they are still alive.
+
+		auto track_node_inserted(N const* node) noexcept -> void {
+			if constexpr (detail::hashable<N> and detail::hashable<E>) {
+				add_hash(node_hash(*node));
+			}
+		}
+
+		auto track_node_erased(N const* node) noexcept -> void {
+			if constexpr (detail::hashable<N> and detail::hashable<E>) {
+				subtract_hash(node_hash(*node));
+			}
+		}
+
+		// Only throws if the weight index is enabled and cannot allocate
+		auto track_edge_inserted(N const* src, N const* dst, E const& weight) -> void {
+			if (weight_index_) {
+				(*weight_index_)[src].emplace(weight, dst);
+			}
+			++num_edges_;
+			if constexpr (detail::hashable<N> and detail::hashable<E>) {
+				add_hash(edge_hash(*src, *dst, weight));
+			}
+		}
+
+		auto track_edge_erased(N const* src, N const* dst, E const& weight) noexcept -> void {
+			if (weight_index_) {
+				auto const& index = weight_index_->find(src);
+				index->second.erase(weight_entry(weight, dst));
+				if (index->second.empty()) {
+					weight_index_->erase(index);
+				}
+			}
+			--num_edges_;
+			if constexpr (detail::hashable<N> and detail::hashable<E>) {
+				subtract_hash(edge_hash(*src, *dst, weight));
+			}
+		}
+
+		// The graph's hash is the lane-wise sum (mod 2^64) of a well-mixed hash of every node and
+		// every edge. Addition is commutative and invertible, so the result does not depend on
+		// insertion order and each modifier only adds or subtracts what it touched.
+
+		static auto mix(std::uint64_t x) noexcept -> std::uint64_t {
+			// splitmix64 finaliser
+			x ^= x >> 30U;
+			x *= 0xbf58476d1ce4e5b9ULL;
+			x ^= x >> 27U;
+			x *= 0x94d049bb133111ebULL;
+			x ^= x >> 31U;
+			return x;
+		}
+
+		static auto node_hash(N const& node) noexcept -> hash_type {
+			auto const h = static_cast<std::uint64_t>(std::hash<N>{}(node));
+			return {mix(h ^ 0x243f6a8885a308d3ULL), mix(h ^ 0x13198a2e03707344ULL)};
+		}
+
+		static auto edge_hash(N const& src, N const& dst, E const& weight) noexcept -> hash_type {
+			auto const h_src = static_cast<std::uint64_t>(std::hash<N>{}(src));
+			auto const h_dst = static_cast<std::uint64_t>(std::hash<N>{}(dst));
+			auto const h_weight = static_cast<std::uint64_t>(std::hash<E>{}(weight));
+			// Chained so that swapping src and dst gives a different edge
+			auto const low = mix(mix(mix(h_src ^ 0xa4093822299f31d0ULL) ^ h_dst) ^ h_weight);
+			auto const high = mix(mix(mix(h_src + 0x082efa98ec4e6c89ULL) + h_dst) + h_weight);
+			return {low, high};
+		}
+
+		auto add_hash(hash_type const& h) noexcept -> void {
+			hash_.low += h.low;
+			hash_.high += h.high;
+		}
+
+		auto subtract_hash(hash_type const& h) noexcept -> void {
+			hash_.low -= h.low;
+			hash_.high -= h.high;
+		}
+
+		// Read-only views and whole-graph operations built directly from repr_
+		friend class snapshot<N, E>;
+		friend auto transpose<>(graph const& g, std::size_t threads) -> graph;
+		friend struct detail::graph_access<N, E>;
 
 		class iterator {
 		public:
@@ -521,6 +1886,102 @@ namespace gdwg {
 		};
 	};
 
+	// The graph with every edge reversed, keeping the node set and all parallel edges. A threads
+	// value other than 1 builds the edge sets of different nodes concurrently; 0 uses every
+	// hardware thread.
+	template<typename N, typename E>
+	auto transpose(graph<N, E> const& g, std::size_t threads) -> graph<N, E> {
+		// Time complexity
+		//        index nodes          - n +
+		//        bucket edges         - n + e +
+		//        build edge sets      - e (amortised O(1) hinted insertion)
+		//     = O(n + e) solution
+		using edge_set = typename graph<N, E>::edge_set;
+		auto result = graph<N, E>();
+		result.nodes_ = g.nodes_; // Node values are shared, as in a copy
+
+		auto index = std::unordered_map<N const*, std::size_t>(g.repr_.size());
+		auto nodes = std::vector<N*>();
+		auto sets = std::vector<edge_set*>();
+		nodes.reserve(g.repr_.size());
+		sets.reserve(g.repr_.size());
+		for (auto const& [node, edges] : g.repr_) {
+			index.emplace(node, nodes.size());
+			auto const& it = result.repr_.emplace_hint(result.repr_.end(), node, edge_set{});
+			result.track_node_inserted(node);
+			nodes.push_back(node);
+			sets.push_back(&it->second);
+		}
+
+		// Counting sort of the edges by destination. Sources are visited in ascending order and
+		// the edges from one source to one destination in ascending weight order, so every
+		// bucket comes out in the (source, weight) order of the reversed edge set.
+		auto offsets = std::vector<std::size_t>(nodes.size() + 1, 0);
+		for (auto const& [node, edges] : g.repr_) {
+			for (auto const& edge : edges) {
+				++offsets[index.find(edge.first)->second + 1];
+			}
+		}
+		for (auto i = std::size_t{0}; i < nodes.size(); ++i) {
+			offsets[i + 1] += offsets[i];
+		}
+		auto buckets = std::vector<std::pair<N*, E const*>>(offsets.back());
+		auto cursor = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+		for (auto const& [node, edges] : g.repr_) {
+			for (auto const& edge : edges) {
+				buckets[cursor[index.find(edge.first)->second]++] = {node, &edge.second};
+			}
+		}
+
+		auto tallies = std::vector<typename graph<N, E>::edge_tally>(nodes.size());
+		detail::parallel_for(nodes.size(), threads, [&](std::size_t i, std::size_t) {
+			auto& edges = *sets[i];
+			for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+				auto const& [src, weight] = buckets[k];
+				edges.emplace_hint(edges.end(), src, *weight);
+				tallies[i].add(*nodes[i], *src, *weight);
+			}
+		});
+		for (auto const& tally : tallies) {
+			result.absorb(tally);
+		}
+		if (g.weight_index_) {
+			result.enable_weight_index(threads);
+		}
+		return result;
+	}
+
+	// The graph holding every node and edge of a or b. An rvalue argument is merged into in
+	// place, so its storage is reused rather than copied.
+	template<typename N, typename E>
+	[[nodiscard]] auto graph_union(graph<N, E> const& a, graph<N, E> const& b) -> graph<N, E> {
+		auto result = a;
+		result.merge(b);
+		return result;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto graph_union(graph<N, E>&& a, graph<N, E> const& b) -> graph<N, E> {
+		a.merge(b);
+		return std::move(a);
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto graph_union(graph<N, E> const& a, graph<N, E>&& b) -> graph<N, E> {
+		b.merge(a);
+		return std::move(b);
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto graph_union(graph<N, E>&& a, graph<N, E>&& b) -> graph<N, E> {
+		// The smaller graph is spliced into the larger one
+		if (a.num_nodes() + a.num_edges() >= b.num_nodes() + b.num_edges()) {
+			a.merge(std::move(b));
+			return std::move(a);
+		}
+		b.merge(std::move(a));
+		return std::move(b);
+	}
 } // namespace gdwg
 
 #endif // GDWG_GRAPH_HPP
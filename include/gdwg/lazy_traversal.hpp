@@ -0,0 +1,197 @@
+#ifndef GDWG_LAZY_TRAVERSAL_HPP
+#define GDWG_LAZY_TRAVERSAL_HPP
+
+#include "gdwg/generator.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+
+#ifdef GDWG_HAS_COROUTINES
+
+#include <cstddef>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+// Traversals that produce nodes one at a time, as a generator, instead of a whole result vector.
+// Each step does only the work needed to reach the next node, so taking the first few nodes of a
+// traversal of a large graph costs little more than those nodes' edges. The graph or snapshot must
+// outlive the generator and must not be modified while it is in use.
+namespace gdwg {
+	namespace detail {
+		// Read-only access to the representation of a graph, for traversals that walk it without
+		// copying it into a snapshot first
+		template<typename N, typename E>
+		struct graph_access {
+			using edge_set = typename graph<N, E>::edge_set;
+
+			[[nodiscard]] static auto repr(graph<N, E> const& g) noexcept -> auto const& {
+				return g.repr_;
+			}
+		};
+
+		template<typename N, typename E>
+		auto lazy_bfs(graph<N, E> const& g, N* source) -> generator<N const&> {
+			auto const& repr = graph_access<N, E>::repr(g);
+			auto seen = std::unordered_set<N const*>{source};
+			auto queue = std::vector<N*>{source};
+			co_yield *source;
+			for (auto head = std::size_t{0}; head < queue.size(); ++head) {
+				for (auto const& [to, weight] : repr.find(queue[head])->second) {
+					if (seen.insert(to).second) {
+						queue.push_back(to);
+						co_yield *to;
+					}
+				}
+			}
+		}
+
+		template<typename N, typename E>
+		auto lazy_dfs(graph<N, E> const& g, N* source) -> generator<N const&> {
+			using edge_iterator = typename graph_access<N, E>::edge_set::const_iterator;
+			struct frame {
+				edge_iterator next;
+				edge_iterator end;
+			};
+			auto const& repr = graph_access<N, E>::repr(g);
+			auto seen = std::unordered_set<N const*>{source};
+			auto const& first = repr.find(source)->second;
+			auto stack = std::vector<frame>{{first.begin(), first.end()}};
+			co_yield *source;
+			while (not stack.empty()) {
+				auto& top = stack.back();
+				if (top.next == top.end) {
+					stack.pop_back();
+					continue;
+				}
+				auto const to = (top.next++)->first;
+				if (seen.insert(to).second) {
+					co_yield *to;
+					auto const& edges = repr.find(to)->second;
+					stack.push_back({edges.begin(), edges.end()});
+				}
+			}
+		}
+
+		template<typename N, typename E>
+		auto lazy_bfs(snapshot<N, E> const& s, typename snapshot<N, E>::id_type source)
+		   -> generator<typename snapshot<N, E>::id_type> {
+			auto seen = std::vector<bool>(s.num_nodes(), false);
+			auto queue = std::vector<typename snapshot<N, E>::id_type>{source};
+			seen[source] = true;
+			co_yield source;
+			for (auto head = std::size_t{0}; head < queue.size(); ++head) {
+				for (auto const v : s.neighbours(queue[head])) {
+					if (not seen[v]) {
+						seen[v] = true;
+						queue.push_back(v);
+						co_yield v;
+					}
+				}
+			}
+		}
+
+		template<typename N, typename E>
+		auto lazy_dfs(snapshot<N, E> const& s, typename snapshot<N, E>::id_type source)
+		   -> generator<typename snapshot<N, E>::id_type> {
+			struct frame {
+				typename snapshot<N, E>::id_type node;
+				std::size_t next; // Position in the node's neighbours
+			};
+			auto seen = std::vector<bool>(s.num_nodes(), false);
+			auto stack = std::vector<frame>{{source, 0}};
+			seen[source] = true;
+			co_yield source;
+			while (not stack.empty()) {
+				auto& top = stack.back();
+				auto const neighbours = s.neighbours(top.node);
+				if (top.next == neighbours.size()) {
+					stack.pop_back();
+					continue;
+				}
+				auto const v = neighbours[top.next++];
+				if (not seen[v]) {
+					seen[v] = true;
+					co_yield v;
+					stack.push_back({v, 0});
+				}
+			}
+		}
+
+		template<typename N, typename E>
+		auto lazy_edges(graph<N, E> const& g) -> generator<typename graph<N, E>::value_type> {
+			for (auto const& [from, edges] : graph_access<N, E>::repr(g)) {
+				for (auto const& [to, weight] : edges) {
+					co_yield typename graph<N, E>::value_type{*from, *to, weight};
+				}
+			}
+		}
+	} // namespace detail
+
+	// Nodes reachable from source in breadth-first order, starting with source. Neighbours are
+	// visited in the order of graph::connections().
+	template<typename N, typename E>
+	[[nodiscard]] auto bfs_range(graph<N, E> const& g, N const& source) -> generator<N const&> {
+		// Time complexity, for the first k nodes
+		//        find source                  - log(n) +
+		//        edges of the expanded nodes  - (k + e_k) log(n)
+		//     = O((k + e_k) log(n)) solution, or O((n + e) log(n)) to exhaust it
+		auto const& repr = detail::graph_access<N, E>::repr(g);
+		auto const node = repr.find(source);
+		if (node == repr.end()) {
+			throw std::runtime_error("Cannot call gdwg::bfs_range if source doesn't exist in the graph");
+		}
+		return detail::lazy_bfs(g, node->first);
+	}
+
+	// Nodes reachable from source in depth-first preorder, starting with source, as a recursive
+	// search that tries neighbours in the order of graph::connections() would produce them
+	template<typename N, typename E>
+	[[nodiscard]] auto dfs_range(graph<N, E> const& g, N const& source) -> generator<N const&> {
+		// Time complexity
+		//     = O((n + e) log(n)) solution to exhaust it, stopping early at any point
+		auto const& repr = detail::graph_access<N, E>::repr(g);
+		auto const node = repr.find(source);
+		if (node == repr.end()) {
+			throw std::runtime_error("Cannot call gdwg::dfs_range if source doesn't exist in the graph");
+		}
+		return detail::lazy_dfs(g, node->first);
+	}
+
+	// The snapshot overloads yield ids. They set aside one bit per node up front.
+	template<typename N, typename E>
+	[[nodiscard]] auto bfs_range(snapshot<N, E> const& s, typename snapshot<N, E>::id_type source)
+	   -> generator<typename snapshot<N, E>::id_type> {
+		// Time complexity
+		//     = O(n + e) solution to exhaust it, stopping early at any point
+		if (source >= s.num_nodes()) {
+			throw std::runtime_error("Cannot call gdwg::bfs_range on a source that doesn't exist in "
+			                         "the snapshot");
+		}
+		return detail::lazy_bfs(s, source);
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto dfs_range(snapshot<N, E> const& s, typename snapshot<N, E>::id_type source)
+	   -> generator<typename snapshot<N, E>::id_type> {
+		// Time complexity
+		//     = O(n + e) solution to exhaust it, stopping early at any point
+		if (source >= s.num_nodes()) {
+			throw std::runtime_error("Cannot call gdwg::dfs_range on a source that doesn't exist in "
+			                         "the snapshot");
+		}
+		return detail::lazy_dfs(s, source);
+	}
+
+	// Every edge, in the order of graph::begin()
+	template<typename N, typename E>
+	[[nodiscard]] auto edges_range(graph<N, E> const& g)
+	   -> generator<typename graph<N, E>::value_type> {
+		// Time complexity
+		//     = O(n + e) solution to exhaust it, stopping early at any point
+		return detail::lazy_edges(g);
+	}
+} // namespace gdwg
+
+#endif // GDWG_HAS_COROUTINES
+
+#endif // GDWG_LAZY_TRAVERSAL_HPP
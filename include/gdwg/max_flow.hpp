@@ -0,0 +1,361 @@
+#ifndef GDWG_MAX_FLOW_HPP
+#define GDWG_MAX_FLOW_HPP
+
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	template<typename N, typename E>
+	struct flow_result {
+		E value;
+		// Every edge of the graph, in the order of graph::begin(), with the flow through it as
+		// its weight
+		std::vector<typename graph<N, E>::value_type> edge_flows;
+		// The source side of a minimum cut, in increasing order; the edges leaving it are
+		// saturated, and their capacities sum to value
+		std::vector<N> source_side;
+	};
+
+	namespace detail {
+		// Highest-label push-relabel over a residual graph in CSR form. Every pair of nodes with
+		// an edge in either direction gets one arc each way, holding the summed capacity of the
+		// edges in that direction.
+		//
+		// A first pass pushes as much flow as it can into the sink, which gives the value of the
+		// flow and a minimum cut but may leave excess stranded on the source side. A second pass
+		// runs the same algorithm towards the source to return that excess. Each pass keeps
+		// labels exact with a global relabel (a breadth-first search back from its target)
+		// whenever the work since the last one exceeds the size of the graph, and uses the gap
+		// heuristic: once no node has some label k, no node above k can reach the target.
+		template<typename E>
+		class push_relabel {
+		public:
+			using id_type = std::uint32_t;
+
+			template<typename N>
+			explicit push_relabel(snapshot<N, E> const& s)
+			: n_(static_cast<id_type>(s.num_nodes())) {
+				struct pair_capacity {
+					id_type low;
+					id_type high;
+					E forward; // From low to high
+					E backward;
+				};
+				auto pairs = std::vector<pair_capacity>();
+				pairs.reserve(s.num_edges());
+				for (auto u = id_type{0}; u < n_; ++u) {
+					auto const targets = s.neighbours(u);
+					auto const weights = s.weights(u);
+					for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+						auto const v = targets[k];
+						if (weights[k] < E{}) {
+							throw std::runtime_error("Cannot call gdwg::max_flow on a graph with negative "
+							                         "capacities");
+						}
+						if (u < v) {
+							pairs.push_back({u, v, weights[k], E{}});
+						}
+						else if (v < u) {
+							pairs.push_back({v, u, E{}, weights[k]});
+						}
+					}
+				}
+				std::sort(pairs.begin(), pairs.end(), [](auto const& a, auto const& b) {
+					return a.low < b.low or (a.low == b.low and a.high < b.high);
+				});
+				auto merged = std::size_t{0};
+				for (auto i = std::size_t{0}; i < pairs.size(); ++i) {
+					if (merged > 0 and pairs[merged - 1].low == pairs[i].low
+					    and pairs[merged - 1].high == pairs[i].high) {
+						pairs[merged - 1].forward += pairs[i].forward;
+						pairs[merged - 1].backward += pairs[i].backward;
+					}
+					else {
+						pairs[merged++] = pairs[i];
+					}
+				}
+				pairs.resize(merged);
+
+				offsets_.assign(n_ + 1, 0);
+				for (auto const& pair : pairs) {
+					++offsets_[pair.low + 1];
+					++offsets_[pair.high + 1];
+				}
+				for (auto u = id_type{0}; u < n_; ++u) {
+					offsets_[u + 1] += offsets_[u];
+				}
+				heads_.resize(2 * pairs.size());
+				residual_.resize(2 * pairs.size());
+				capacity_.resize(2 * pairs.size());
+				reverse_.resize(2 * pairs.size());
+				auto next = std::vector<std::size_t>(offsets_.begin(), offsets_.end() - 1);
+				for (auto const& pair : pairs) {
+					auto const a = next[pair.low]++;
+					auto const b = next[pair.high]++;
+					heads_[a] = pair.high;
+					heads_[b] = pair.low;
+					capacity_[a] = residual_[a] = pair.forward;
+					capacity_[b] = residual_[b] = pair.backward;
+					reverse_[a] = b;
+					reverse_[b] = a;
+				}
+				excess_.assign(n_, E{});
+				label_.assign(n_, 0);
+				current_.assign(n_, 0);
+			}
+
+			// Pushes a maximum flow from source to sink, returning its value
+			auto run(id_type source, id_type sink) -> E {
+				// Time complexity
+				//        push-relabel      - n^2 sqrt(e) in the worst case, with global relabels
+				//                            and gaps making it close to linear in practice
+				//     = O(n^2 sqrt(e)) solution
+				for (auto a = offsets_[source]; a < offsets_[source + 1]; ++a) {
+					auto const delta = residual_[a];
+					if (E{} < delta) {
+						push(source, a, delta);
+					}
+				}
+				discharge_all(sink, source);
+				auto const value = excess_[sink];
+				discharge_all(source, sink);
+				return value;
+			}
+
+			// Net flow from u to v along arc a, if positive
+			[[nodiscard]] auto flow(std::size_t a) const noexcept -> E {
+				auto const net = static_cast<E>(capacity_[a] - residual_[a]);
+				return E{} < net ? net : E{};
+			}
+
+			// Arc from u to v, which must exist
+			[[nodiscard]] auto arc(id_type u, id_type v) const noexcept -> std::size_t {
+				auto const begin = heads_.begin() + static_cast<std::ptrdiff_t>(offsets_[u]);
+				auto const end = heads_.begin() + static_cast<std::ptrdiff_t>(offsets_[u + 1]);
+				return static_cast<std::size_t>(std::lower_bound(begin, end, v) - heads_.begin());
+			}
+
+			// Nodes reachable from source through arcs with residual capacity
+			[[nodiscard]] auto reachable(id_type source) const -> std::vector<bool> {
+				auto seen = std::vector<bool>(n_, false);
+				auto queue = std::vector<id_type>{source};
+				seen[source] = true;
+				for (auto head = std::size_t{0}; head < queue.size(); ++head) {
+					auto const u = queue[head];
+					for (auto a = offsets_[u]; a < offsets_[u + 1]; ++a) {
+						if (E{} < residual_[a] and not seen[heads_[a]]) {
+							seen[heads_[a]] = true;
+							queue.push_back(heads_[a]);
+						}
+					}
+				}
+				return seen;
+			}
+
+		private:
+			static constexpr auto none = std::numeric_limits<id_type>::max();
+
+			auto push(id_type u, std::size_t a, E delta) -> void {
+				residual_[a] = static_cast<E>(residual_[a] - delta);
+				residual_[reverse_[a]] = static_cast<E>(residual_[reverse_[a]] + delta);
+				excess_[u] = static_cast<E>(excess_[u] - delta);
+				excess_[heads_[a]] = static_cast<E>(excess_[heads_[a]] + delta);
+			}
+
+			// Moves all the excess it can into target, never through blocked
+			auto discharge_all(id_type target, id_type blocked) -> void {
+				global_relabel(target, blocked);
+				while (highest_ != none) {
+					auto const u = active_[highest_].back();
+					active_[highest_].pop_back();
+					discharge(u, target, blocked);
+					while (highest_ != none and active_[highest_].empty()) {
+						highest_ = highest_ == 0 ? none : highest_ - 1;
+					}
+					if (work_ > relabel_interval()) {
+						global_relabel(target, blocked);
+					}
+				}
+			}
+
+			auto discharge(id_type u, id_type target, id_type blocked) -> void {
+				while (E{} < excess_[u]) {
+					auto const end = offsets_[u + 1];
+					for (auto& a = current_[u]; a < end and E{} < excess_[u]; ++a) {
+						auto const v = heads_[a];
+						if (E{} < residual_[a] and label_[u] == label_[v] + 1) {
+							auto const was_idle = not(E{} < excess_[v]);
+							push(u, a, std::min(excess_[u], residual_[a]));
+							if (was_idle and v != target and v != blocked) {
+								activate(v);
+							}
+							if (not(E{} < excess_[u])) {
+								return; // Keeps a, which may still have residual capacity
+							}
+						}
+					}
+					if (not relabel(u)) {
+						return;
+					}
+				}
+			}
+
+			// Lifts u to one above its lowest residual neighbour, returning false if u can no
+			// longer reach the target
+			auto relabel(id_type u) -> bool {
+				work_ += offsets_[u + 1] - offsets_[u] + 12;
+				auto const old = label_[u];
+				auto lowest = n_;
+				for (auto a = offsets_[u]; a < offsets_[u + 1]; ++a) {
+					if (E{} < residual_[a]) {
+						lowest = std::min(lowest, label_[heads_[a]] + 1);
+					}
+				}
+				current_[u] = offsets_[u];
+				--count_[old];
+				if (count_[old] == 0) {
+					// Gap: nothing above old can reach the target any more
+					for (auto k = old + 1; k <= max_label_; ++k) {
+						for (auto const v : members_[k]) {
+							if (label_[v] == k) {
+								label_[v] = n_;
+							}
+						}
+						members_[k].clear();
+						active_[k].clear();
+						count_[k] = 0;
+					}
+					max_label_ = old;
+					label_[u] = n_;
+					return false;
+				}
+				label_[u] = lowest;
+				if (lowest >= n_) {
+					return false;
+				}
+				++count_[lowest];
+				members_[lowest].push_back(u);
+				max_label_ = std::max(max_label_, lowest);
+				return true;
+			}
+
+			auto activate(id_type v) -> void {
+				auto const k = label_[v];
+				if (k < n_) {
+					active_[k].push_back(v);
+					highest_ = highest_ == none ? k : std::max(highest_, k);
+				}
+			}
+
+			// Sets every label to the exact distance to target through residual arcs, or n for
+			// nodes that can't reach it, and rebuilds the buckets
+			auto global_relabel(id_type target, id_type blocked) -> void {
+				work_ = 0;
+				label_.assign(n_, n_);
+				members_.assign(n_, {});
+				active_.assign(n_, {});
+				count_.assign(n_, 0);
+				highest_ = none;
+				max_label_ = 0;
+				label_[target] = 0;
+				auto queue = std::vector<id_type>{target};
+				for (auto head = std::size_t{0}; head < queue.size(); ++head) {
+					auto const v = queue[head];
+					++count_[label_[v]];
+					members_[label_[v]].push_back(v);
+					max_label_ = label_[v];
+					for (auto a = offsets_[v]; a < offsets_[v + 1]; ++a) {
+						auto const u = heads_[a];
+						// u reaches v if the arc from u to v has residual capacity
+						if (u != blocked and label_[u] == n_ and E{} < residual_[reverse_[a]]) {
+							label_[u] = label_[v] + 1;
+							queue.push_back(u);
+						}
+					}
+				}
+				for (auto u = id_type{0}; u < n_; ++u) {
+					current_[u] = offsets_[u];
+					if (u != target and u != blocked and E{} < excess_[u]) {
+						activate(u);
+					}
+				}
+			}
+
+			auto relabel_interval() const noexcept -> std::size_t {
+				return 6 * std::size_t{n_} + heads_.size() / 2;
+			}
+
+			id_type n_;
+			std::vector<std::size_t> offsets_;
+			std::vector<id_type> heads_; // Sorted within each node
+			std::vector<E> residual_;
+			std::vector<E> capacity_;
+			std::vector<std::size_t> reverse_;
+			std::vector<E> excess_;
+			std::vector<id_type> label_;
+			std::vector<std::size_t> current_; // Next arc to try when discharging each node
+			std::vector<std::vector<id_type>> active_; // Nodes with excess, by label
+			std::vector<std::vector<id_type>> members_; // Nodes with each label below n, or stale
+			std::vector<id_type> count_; // Number of nodes with each label below n
+			id_type highest_ = none; // Highest label with an active node
+			id_type max_label_ = 0; // Highest label below n held by any node
+			std::size_t work_ = 0;
+		};
+	} // namespace detail
+
+	// Maximum flow from source to sink, with each edge's weight as its capacity and parallel
+	// edges adding their capacities, along with the flow through every edge and a minimum cut.
+	// Uses highest-label push-relabel with global relabelling and the gap heuristic.
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	[[nodiscard]] auto max_flow(graph<N, E> const& g, N const& source, N const& sink)
+	   -> flow_result<N, E> {
+		auto const s = snapshot<N, E>(g);
+		auto const source_id = s.id(source);
+		auto const sink_id = s.id(sink);
+		if (not source_id or not sink_id) {
+			throw std::runtime_error("Cannot call gdwg::max_flow if source or sink node don't exist "
+			                         "in the graph");
+		}
+		if (*source_id == *sink_id) {
+			throw std::runtime_error("Cannot call gdwg::max_flow with the same source and sink");
+		}
+		auto solver = detail::push_relabel<E>(s);
+		auto result = flow_result<N, E>{solver.run(*source_id, *sink_id), {}, {}};
+
+		// The flow of a pair of nodes is shared out over its parallel edges in order
+		result.edge_flows.reserve(s.num_edges());
+		for (auto u = std::uint32_t{0}; u < s.num_nodes(); ++u) {
+			auto const targets = s.neighbours(u);
+			auto const weights = s.weights(u);
+			auto remaining = E{};
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				if (k == 0 or targets[k] != targets[k - 1]) {
+					remaining = targets[k] == u ? E{} : solver.flow(solver.arc(u, targets[k]));
+				}
+				auto const share = std::min(remaining, weights[k]);
+				remaining = static_cast<E>(remaining - share);
+				result.edge_flows.push_back({s.node(u), s.node(targets[k]), share});
+			}
+		}
+
+		auto const side = solver.reachable(*source_id);
+		for (auto u = std::uint32_t{0}; u < s.num_nodes(); ++u) {
+			if (side[u]) {
+				result.source_side.push_back(s.node(u));
+			}
+		}
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_MAX_FLOW_HPP
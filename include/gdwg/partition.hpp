@@ -0,0 +1,528 @@
+#ifndef GDWG_PARTITION_HPP
+#define GDWG_PARTITION_HPP
+
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	struct partition_options {
+		// Every part holds at most (1 + imbalance) * ceil(n / k) nodes
+		double imbalance = 0.03;
+		// Label propagation rounds on each level, stopping early once nodes stop moving
+		std::size_t rounds = 10;
+		std::uint64_t seed = generate::default_seed;
+		std::size_t threads = 0;
+	};
+
+	struct partition_result {
+		// Part of every node, by snapshot id, or by position in graph::nodes() for a graph
+		std::vector<std::uint32_t> parts;
+		std::vector<std::size_t> part_sizes;
+		std::size_t edge_cut = 0; // Edges between nodes in different parts
+		double balance = 0.0; // Largest part over the average part, 1 when perfectly balanced
+	};
+
+	// One part of a graph, with the ghost (halo) nodes it needs: every node of another part with an
+	// edge to or from a node of this part. The subgraph holds the part's nodes, its ghosts, and
+	// every edge with at least one end in the part, so an edge between parts is in both shards.
+	template<typename N, typename E>
+	struct shard {
+		graph<N, E> subgraph;
+		std::vector<N> ghosts; // Sorted
+	};
+
+	namespace detail::partitioning {
+		// An undirected graph with weighted nodes and edges in CSR form, where both directions of
+		// every edge are stored
+		struct weighted_graph {
+			std::vector<std::uint64_t> node_weights;
+			std::vector<std::size_t> offsets;
+			std::vector<std::uint32_t> targets;
+			std::vector<std::uint64_t> edge_weights;
+
+			[[nodiscard]] auto size() const noexcept -> std::size_t {
+				return node_weights.size();
+			}
+		};
+
+		struct weighted_edge {
+			std::uint32_t from;
+			std::uint32_t to;
+			std::uint64_t weight;
+		};
+
+		// Adds up the weights of parallel edges
+		inline auto build(std::vector<std::uint64_t> node_weights, std::vector<weighted_edge> edges)
+		   -> weighted_graph {
+			std::sort(edges.begin(), edges.end(), [](weighted_edge const& a, weighted_edge const& b) {
+				return std::pair(a.from, a.to) < std::pair(b.from, b.to);
+			});
+			auto result = weighted_graph{std::move(node_weights), {}, {}, {}};
+			result.offsets.assign(result.size() + 1, 0);
+			for (auto i = std::size_t{0}; i < edges.size(); ++i) {
+				auto const& edge = edges[i];
+				if (i > 0 and edges[i - 1].from == edge.from and edges[i - 1].to == edge.to) {
+					result.edge_weights.back() += edge.weight;
+					continue;
+				}
+				result.targets.push_back(edge.to);
+				result.edge_weights.push_back(edge.weight);
+				++result.offsets[edge.from + 1];
+			}
+			std::partial_sum(result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+			return result;
+		}
+
+		// Each edge of the snapshot, other than a self-loop, weighs 1 in both directions
+		template<typename N, typename E>
+		auto undirected(snapshot<N, E> const& s) -> weighted_graph {
+			auto edges = std::vector<weighted_edge>();
+			edges.reserve(2 * s.num_edges());
+			for (auto u = std::uint32_t{0}; u < s.num_nodes(); ++u) {
+				for (auto const v : s.neighbours(u)) {
+					if (u != v) {
+						edges.push_back({u, v, 1});
+						edges.push_back({v, u, 1});
+					}
+				}
+			}
+			return build(std::vector<std::uint64_t>(s.num_nodes(), 1), std::move(edges));
+		}
+
+		// One node per cluster, with the clusters' total weights, and the edges between clusters
+		inline auto contract(weighted_graph const& g,
+		                     std::vector<std::uint32_t> const& cluster,
+		                     std::size_t clusters) -> weighted_graph {
+			auto node_weights = std::vector<std::uint64_t>(clusters, 0);
+			auto edges = std::vector<weighted_edge>();
+			for (auto u = std::size_t{0}; u < g.size(); ++u) {
+				node_weights[cluster[u]] += g.node_weights[u];
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+					if (cluster[u] != cluster[g.targets[e]]) {
+						edges.push_back({cluster[u], cluster[g.targets[e]], g.edge_weights[e]});
+					}
+				}
+			}
+			return build(std::move(node_weights), std::move(edges));
+		}
+
+		inline constexpr auto none_label() noexcept -> std::uint32_t {
+			return static_cast<std::uint32_t>(-1);
+		}
+
+		// Renumbers labels to [0, count), in order of first appearance, returning count
+		inline auto compact(std::vector<std::uint32_t>& labels) -> std::size_t {
+			auto renumbered = std::vector<std::uint32_t>(labels.size(), none_label());
+			auto count = std::uint32_t{0};
+			for (auto& label : labels) {
+				if (renumbered[label] == none_label()) {
+					renumbered[label] = count++;
+				}
+				label = renumbered[label];
+			}
+			return count;
+		}
+
+		// The total weight of the edges from one node to each label, in an open-addressing table
+		// that grows to twice the largest degree seen, so a worker needs memory for its largest
+		// neighbourhood rather than for every label. Labels are listed in the order they were
+		// first added.
+		class label_ratings {
+		public:
+			auto reserve(std::size_t degree) -> void {
+				auto const capacity = std::bit_ceil(std::max<std::size_t>(2 * degree, 16));
+				if (keys_.size() < capacity) {
+					keys_.assign(capacity, none_label());
+					weights_.assign(capacity, 0);
+					shift_ = 64 - std::countr_zero(capacity);
+				}
+			}
+
+			auto add(std::uint32_t label, std::uint64_t weight) -> void {
+				auto const slot = find(label);
+				if (keys_[slot] == none_label()) {
+					keys_[slot] = label;
+					used_.push_back(slot);
+				}
+				weights_[slot] += weight;
+			}
+
+			[[nodiscard]] auto weight(std::uint32_t label) const noexcept -> std::uint64_t {
+				return weights_[find(label)];
+			}
+
+			template<typename F>
+			auto for_each(F f) const -> void {
+				for (auto const slot : used_) {
+					f(keys_[slot], weights_[slot]);
+				}
+			}
+
+			auto clear() noexcept -> void {
+				for (auto const slot : used_) {
+					keys_[slot] = none_label();
+					weights_[slot] = 0;
+				}
+				used_.clear();
+			}
+
+		private:
+			// The slot holding label, or the empty slot where it belongs
+			[[nodiscard]] auto find(std::uint32_t label) const noexcept -> std::size_t {
+				auto const mask = keys_.size() - 1;
+				auto const hash = label * std::uint64_t{0x9e3779b97f4a7c15};
+				auto slot = static_cast<std::size_t>(hash >> shift_);
+				while (keys_[slot] != label and keys_[slot] != none_label()) {
+					slot = (slot + 1) & mask;
+				}
+				return slot;
+			}
+
+			std::vector<std::uint32_t> keys_;
+			std::vector<std::uint64_t> weights_;
+			std::vector<std::size_t> used_;
+			int shift_ = 64;
+		};
+
+		// Size-constrained label propagation: each node moves to the label it has the heaviest
+		// edges to, if that is heavier than its own label and the label's total weight stays within
+		// limit. Every round splits the nodes into two random halves. The nodes of a half choose
+		// their labels concurrently, from the labels as they were before the half, and the moves
+		// are then applied in id order, so the result doesn't depend on the number of threads, and
+		// two neighbours can't keep swapping labels.
+		class label_propagation {
+		public:
+			explicit label_propagation(std::size_t threads)
+			: threads_(detail::thread_count(threads))
+			, ratings_(threads_) {}
+
+			auto run(weighted_graph const& g,
+			         std::vector<std::uint32_t>& label,
+			         std::vector<std::uint64_t>& label_weight,
+			         std::uint64_t limit,
+			         std::size_t rounds,
+			         std::uint64_t seed) -> void {
+				auto const n = g.size();
+				auto wanted = std::vector<std::uint32_t>(n);
+				for (auto round = std::size_t{0}; round < rounds; ++round) {
+					auto moved = std::size_t{0};
+					for (auto half = std::uint64_t{0}; half < 2; ++half) {
+						auto const in_half = [&](std::size_t u) {
+							auto stream = generate::detail::random_stream(seed + round, u);
+							return (stream.next() & 1U) == half;
+						};
+						detail::parallel_for(
+						   n,
+						   threads_,
+						   [&](std::size_t u, std::size_t worker) {
+							   wanted[u] = in_half(u)
+							                  ? best_label(g, u, label, label_weight, limit, worker)
+							                  : label[u];
+						   },
+						   1024);
+						for (auto u = std::size_t{0}; u < n; ++u) {
+							auto const to = wanted[u];
+							if (to != label[u] and label_weight[to] + g.node_weights[u] <= limit) {
+								label_weight[label[u]] -= g.node_weights[u];
+								label_weight[to] += g.node_weights[u];
+								label[u] = to;
+								++moved;
+							}
+						}
+					}
+					if (moved == 0) {
+						return;
+					}
+				}
+			}
+
+		private:
+			auto best_label(weighted_graph const& g,
+			                std::size_t u,
+			                std::vector<std::uint32_t> const& label,
+			                std::vector<std::uint64_t> const& label_weight,
+			                std::uint64_t limit,
+			                std::size_t worker) -> std::uint32_t {
+				auto& ratings = ratings_[worker].value;
+				ratings.reserve(g.offsets[u + 1] - g.offsets[u]);
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+					ratings.add(label[g.targets[e]], g.edge_weights[e]);
+				}
+				auto best = label[u];
+				auto best_weight = ratings.weight(best);
+				ratings.for_each([&](std::uint32_t l, std::uint64_t weight) {
+					if (weight > best_weight and label_weight[l] + g.node_weights[u] <= limit) {
+						best = l;
+						best_weight = weight;
+					}
+				});
+				ratings.clear();
+				return best;
+			}
+
+			std::size_t threads_;
+			std::vector<detail::padded<label_ratings>> ratings_;
+		};
+
+		// Moves nodes out of parts heavier than limit, each to the part it has the heaviest edges to
+		// among those with room, or else the lightest part, preferring the nodes that lose the
+		// least
+		inline auto rebalance(weighted_graph const& g,
+		                      std::vector<std::uint32_t>& part,
+		                      std::vector<std::uint64_t>& part_weight,
+		                      std::uint64_t limit) -> void {
+			auto const k = part_weight.size();
+			if (std::all_of(part_weight.begin(), part_weight.end(), [&](std::uint64_t w) {
+				    return w <= limit;
+			    }))
+			{
+				return;
+			}
+			struct candidate {
+				std::int64_t loss;
+				std::uint32_t node;
+			};
+			auto candidates = std::vector<candidate>();
+			auto connection = std::vector<std::int64_t>(k, 0);
+			for (auto u = std::uint32_t{0}; u < g.size(); ++u) {
+				if (part_weight[part[u]] > limit) {
+					auto internal = std::int64_t{0};
+					auto external = std::int64_t{0};
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+						auto const w = static_cast<std::int64_t>(g.edge_weights[e]);
+						(part[g.targets[e]] == part[u] ? internal : external) += w;
+					}
+					candidates.push_back({internal - external, u});
+				}
+			}
+			std::sort(candidates.begin(),
+			          candidates.end(),
+			          [](candidate const& a, candidate const& b) {
+				          return std::pair(a.loss, a.node) < std::pair(b.loss, b.node);
+			          });
+			for (auto const& [loss, u] : candidates) {
+				auto const from = part[u];
+				if (part_weight[from] <= limit) {
+					continue;
+				}
+				std::fill(connection.begin(), connection.end(), 0);
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+					connection[part[g.targets[e]]] += static_cast<std::int64_t>(g.edge_weights[e]);
+				}
+				auto to = static_cast<std::uint32_t>(
+				   std::min_element(part_weight.begin(), part_weight.end()) - part_weight.begin());
+				for (auto p = std::uint32_t{0}; p < k; ++p) {
+					if (p != from and part_weight[p] + g.node_weights[u] <= limit
+					    and connection[p] > connection[to])
+					{
+						to = p;
+					}
+				}
+				if (to != from) {
+					part_weight[from] -= g.node_weights[u];
+					part_weight[to] += g.node_weights[u];
+					part[u] = to;
+				}
+			}
+		}
+
+		// Fills the parts one after another with nodes in breadth-first order, so each part starts
+		// out as a connected region where it can
+		inline auto grow_parts(weighted_graph const& g, std::size_t k) -> std::vector<std::uint32_t> {
+			auto const n = g.size();
+			auto const total =
+			   std::accumulate(g.node_weights.begin(), g.node_weights.end(), std::uint64_t{0});
+			auto part = std::vector<std::uint32_t>(n, 0);
+			auto seen = std::vector<bool>(n, false);
+			auto queue = std::vector<std::uint32_t>();
+			queue.reserve(n);
+			for (auto root = std::uint32_t{0}; root < n; ++root) {
+				if (not seen[root]) {
+					seen[root] = true;
+					queue.push_back(root);
+					for (auto head = queue.size() - 1; head < queue.size(); ++head) {
+						auto const u = queue[head];
+						for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+							if (not seen[g.targets[e]]) {
+								seen[g.targets[e]] = true;
+								queue.push_back(g.targets[e]);
+							}
+						}
+					}
+				}
+			}
+			auto filled = std::uint64_t{0};
+			for (auto const u : queue) {
+				// The part whose share of the total weight the node's midpoint falls in
+				auto const middle = 2 * filled + g.node_weights[u];
+				part[u] =
+				   static_cast<std::uint32_t>(std::min<std::uint64_t>(middle * k / (2 * total), k - 1));
+				filled += g.node_weights[u];
+			}
+			return part;
+		}
+	} // namespace detail::partitioning
+
+	// Splits the nodes of a snapshot into k parts of balanced size with few edges between them,
+	// treating edges as undirected and counting each parallel edge.
+	//
+	// Multilevel label propagation: the graph is coarsened by clustering nodes with size-limited
+	// label propagation and contracting the clusters, until it is small or stops shrinking. The
+	// coarsest graph is split by growing parts in breadth-first order, and the parts are then
+	// carried back down level by level, refined by label propagation between parts on every
+	// level. The result depends on the seed, but not on the number of threads.
+	template<typename N, typename E>
+	[[nodiscard]] auto
+	partition(snapshot<N, E> const& s, std::size_t k, partition_options const& options = {})
+	   -> partition_result {
+		// Time complexity, for L levels and r rounds
+		//        build and contract levels  - L e log(e) +
+		//        label propagation           - L r (n + e) / p, for p threads
+		//     = O(L (e log(e) + r (n + e) / p)) solution, with L about log(n) at most
+		namespace lp = detail::partitioning;
+		if (k == 0) {
+			throw std::runtime_error("Cannot call gdwg::partition with 0 parts");
+		}
+		auto const n = s.num_nodes();
+		auto const limit = static_cast<std::uint64_t>(
+		   std::floor((1.0 + options.imbalance) * static_cast<double>((n + k - 1) / k)));
+		auto const coarsest = std::max<std::size_t>(64, 32 * k);
+
+		auto levels = std::vector<lp::weighted_graph>{lp::undirected(s)};
+		auto clusterings = std::vector<std::vector<std::uint32_t>>();
+		while (levels.back().size() > coarsest) {
+			auto const& fine = levels.back();
+			// Clusters of at most a fraction of a part, so the coarsest graph can still be balanced
+			auto const cluster_limit = std::max<std::uint64_t>(limit / 8, 1);
+			auto cluster = std::vector<std::uint32_t>(fine.size());
+			std::iota(cluster.begin(), cluster.end(), std::uint32_t{0});
+			auto cluster_weight = fine.node_weights;
+			lp::label_propagation(options.threads)
+			   .run(fine,
+			        cluster,
+			        cluster_weight,
+			        cluster_limit,
+			        options.rounds,
+			        options.seed + levels.size());
+			auto const clusters = lp::compact(cluster);
+			if (clusters > fine.size() - fine.size() / 20) {
+				break; // Less than 5% smaller
+			}
+			auto coarse = lp::contract(fine, cluster, clusters);
+			clusterings.push_back(std::move(cluster));
+			levels.push_back(std::move(coarse));
+		}
+
+		auto part = lp::grow_parts(levels.back(), k);
+		auto refine = lp::label_propagation(options.threads);
+		for (auto level = levels.size(); level-- > 0;) {
+			auto const& g = levels[level];
+			if (level + 1 < levels.size()) {
+				auto fine_part = std::vector<std::uint32_t>(g.size());
+				for (auto u = std::size_t{0}; u < g.size(); ++u) {
+					fine_part[u] = part[clusterings[level][u]];
+				}
+				part = std::move(fine_part);
+			}
+			auto part_weight = std::vector<std::uint64_t>(k, 0);
+			for (auto u = std::size_t{0}; u < g.size(); ++u) {
+				part_weight[part[u]] += g.node_weights[u];
+			}
+			lp::rebalance(g, part, part_weight, limit);
+			refine.run(g, part, part_weight, limit, options.rounds, options.seed + level);
+		}
+
+		auto result = partition_result{std::move(part), std::vector<std::size_t>(k, 0), 0, 0.0};
+		for (auto const p : result.parts) {
+			++result.part_sizes[p];
+		}
+		for (auto u = std::uint32_t{0}; u < n; ++u) {
+			for (auto const v : s.neighbours(u)) {
+				if (result.parts[u] != result.parts[v]) {
+					++result.edge_cut;
+				}
+			}
+		}
+		if (n > 0) {
+			auto const largest =
+			   *std::max_element(result.part_sizes.begin(), result.part_sizes.end());
+			result.balance =
+			   static_cast<double>(largest) * static_cast<double>(k) / static_cast<double>(n);
+		}
+		return result;
+	}
+
+	// The parts are indexed by position in graph::nodes()
+	template<typename N, typename E>
+	[[nodiscard]] auto
+	partition(graph<N, E> const& g, std::size_t k, partition_options const& options = {})
+	   -> partition_result {
+		return partition(snapshot<N, E>(g), k, options);
+	}
+
+	// One shard per part, as returned by partition() for g
+	template<typename N, typename E>
+	[[nodiscard]] auto shards(graph<N, E> const& g, partition_result const& p)
+	   -> std::vector<shard<N, E>> {
+		// Time complexity
+		//        place every edge      - e log(n) +
+		//        build the subgraphs   - (n + e) log(n)
+		//     = O((n + e) log(n)) solution
+		auto const nodes = g.nodes();
+		if (p.parts.size() != nodes.size()) {
+			throw std::runtime_error("Cannot call gdwg::shards with a partition of another graph");
+		}
+		auto const k = p.part_sizes.size();
+		auto edges = std::vector<std::vector<typename graph<N, E>::value_type>>(k);
+		auto ghosts = std::vector<std::vector<std::size_t>>(k);
+		auto from = std::size_t{0};
+		for (auto const& edge : g) {
+			while (nodes[from] < edge.from) {
+				++from;
+			}
+			auto const to = static_cast<std::size_t>(
+			   std::lower_bound(nodes.begin(), nodes.end(), edge.to) - nodes.begin());
+			auto const a = p.parts[from];
+			auto const b = p.parts[to];
+			edges[a].push_back(edge);
+			if (a != b) {
+				edges[b].push_back(edge);
+				ghosts[a].push_back(to);
+				ghosts[b].push_back(from);
+			}
+		}
+
+		auto owned = std::vector<std::vector<N>>(k);
+		for (auto i = std::size_t{0}; i < nodes.size(); ++i) {
+			owned[p.parts[i]].push_back(nodes[i]);
+		}
+		auto result = std::vector<shard<N, E>>(k);
+		for (auto part = std::size_t{0}; part < k; ++part) {
+			auto& ids = ghosts[part];
+			std::sort(ids.begin(), ids.end());
+			ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+			auto& [subgraph, ghost_nodes] = result[part];
+			for (auto const i : ids) {
+				ghost_nodes.push_back(nodes[i]);
+			}
+			subgraph.insert_nodes(owned[part]);
+			subgraph.insert_nodes(ghost_nodes);
+			subgraph.insert_edges(edges[part]);
+		}
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_PARTITION_HPP
@@ -0,0 +1,433 @@
+#ifndef GDWG_SHORTEST_PATH_HPP
+#define GDWG_SHORTEST_PATH_HPP
+
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Point-to-point shortest paths over a snapshot, for arithmetic weights that are never negative.
+// Nodes are snapshot ids, except in shortest_path_query and the graph overloads, which take and
+// return node values.
+//
+// A search only touches the nodes it reaches, so its per-node state lives in a search_context
+// that is kept between queries. Each query starts a new generation: a node's state is valid only
+// if its stamp matches the current generation, so nothing has to be cleared or reallocated,
+// and a query costs time in proportion to the part of the graph it explores rather than n.
+namespace gdwg {
+	template<typename E, typename Node = std::uint32_t>
+	struct weighted_path {
+		E distance;
+		std::vector<Node> nodes; // From src to dst, both included
+	};
+
+	namespace detail {
+		// Distances, parents and the priority queue of one direction of a search
+		template<typename E>
+		struct search_state {
+			struct entry {
+				E key; // Distance, plus the heuristic for A*
+				E distance;
+				std::uint32_t node;
+			};
+
+			std::vector<std::uint32_t> stamp;
+			std::vector<E> distance;
+			std::vector<std::uint32_t> parent;
+			std::vector<entry> heap;
+			std::uint32_t generation = 0;
+			std::size_t settled = 0;
+
+			auto reserve(std::size_t n) -> void {
+				if (stamp.size() < n) {
+					stamp.resize(n, 0);
+					distance.resize(n);
+					parent.resize(n);
+				}
+			}
+
+			// Forgets the previous search in O(1), except once every 2^32 searches
+			auto begin(std::size_t n) -> void {
+				reserve(n);
+				heap.clear();
+				settled = 0;
+				if (++generation == 0) {
+					std::fill(stamp.begin(), stamp.end(), 0);
+					generation = 1;
+				}
+			}
+
+			[[nodiscard]] auto reached(std::uint32_t v) const noexcept -> bool {
+				return stamp[v] == generation;
+			}
+
+			// Records a path to v through from if it is shorter than any found so far
+			auto relax(std::uint32_t v, E d, E key, std::uint32_t from) -> bool {
+				if (reached(v) and not(d < distance[v])) {
+					return false;
+				}
+				stamp[v] = generation;
+				distance[v] = d;
+				parent[v] = from;
+				heap.push_back({key, d, v});
+				std::push_heap(heap.begin(), heap.end(), later);
+				return true;
+			}
+
+			// Drops queued entries of nodes that have since been reached by a shorter path
+			auto prune() -> void {
+				while (not heap.empty() and distance[heap.front().node] < heap.front().distance) {
+					pop();
+				}
+			}
+
+			auto pop() -> entry {
+				std::pop_heap(heap.begin(), heap.end(), later);
+				auto const top = heap.back();
+				heap.pop_back();
+				return top;
+			}
+
+			static auto later(entry const& lhs, entry const& rhs) -> bool {
+				return rhs.key < lhs.key;
+			}
+		};
+
+		template<typename E>
+		auto check_weight(E const& weight, char const* algorithm) -> void {
+			if constexpr (std::is_signed_v<E>) {
+				if (weight < E{}) {
+					throw std::runtime_error(std::string("Cannot call gdwg::") + algorithm
+					                         + " on a snapshot with negative edge weights");
+				}
+			}
+		}
+
+		template<typename N, typename E>
+		auto check_endpoints(snapshot<N, E> const& s,
+		                     std::uint32_t src,
+		                     std::uint32_t dst,
+		                     char const* algorithm) -> void {
+			if (src >= s.num_nodes() or dst >= s.num_nodes()) {
+				throw std::runtime_error(std::string("Cannot call gdwg::") + algorithm
+				                         + " on a src or dst that doesn't exist in the snapshot");
+			}
+		}
+
+		template<typename N, typename E>
+		auto node_endpoints(snapshot<N, E> const& s,
+		                    N const& src,
+		                    N const& dst,
+		                    char const* algorithm) -> std::pair<std::uint32_t, std::uint32_t> {
+			auto const src_id = s.id(src);
+			auto const dst_id = s.id(dst);
+			if (not src_id or not dst_id) {
+				throw std::runtime_error(std::string("Cannot call gdwg::") + algorithm
+				                         + " if src or dst node don't exist in the graph");
+			}
+			return {*src_id, *dst_id};
+		}
+
+		template<typename N, typename E>
+		auto node_path(snapshot<N, E> const& s, std::optional<weighted_path<E>> const& path)
+		   -> std::optional<weighted_path<E, N>> {
+			if (not path) {
+				return std::nullopt;
+			}
+			auto result = weighted_path<E, N>{path->distance, {}};
+			result.nodes.reserve(path->nodes.size());
+			for (auto const id : path->nodes) {
+				result.nodes.push_back(s.node(id));
+			}
+			return result;
+		}
+
+		// Follows parents from v back to the start of the search, appending each node
+		template<typename E>
+		auto append_parents(search_state<E> const& state,
+		                    std::uint32_t v,
+		                    std::vector<std::uint32_t>& out) -> void {
+			out.push_back(v);
+			while (state.parent[v] != v) {
+				v = state.parent[v];
+				out.push_back(v);
+			}
+		}
+	} // namespace detail
+
+	// Search state that is reused across queries, so that repeated searches allocate nothing
+	// once it has grown to the size of the snapshot. A context may be shared by snapshots of
+	// different sizes, but not by two searches running at the same time.
+	template<typename E>
+	class search_context {
+	public:
+		search_context() = default;
+
+		explicit search_context(std::size_t num_nodes) {
+			reserve(num_nodes);
+		}
+
+		auto reserve(std::size_t num_nodes) -> void {
+			forward_.reserve(num_nodes);
+			backward_.reserve(num_nodes);
+		}
+
+		// Number of nodes the state is sized for
+		[[nodiscard]] auto capacity() const noexcept -> std::size_t {
+			return forward_.stamp.size();
+		}
+
+		// Nodes whose distance was settled by the last search, in either direction
+		[[nodiscard]] auto settled() const noexcept -> std::size_t {
+			return forward_.settled + backward_.settled;
+		}
+
+		// The state of each direction, used by the searches below
+		[[nodiscard]] auto forward() noexcept -> detail::search_state<E>& {
+			return forward_;
+		}
+
+		[[nodiscard]] auto backward() noexcept -> detail::search_state<E>& {
+			return backward_;
+		}
+
+	private:
+		detail::search_state<E> forward_;
+		detail::search_state<E> backward_;
+	};
+
+	// Shortest path from src to dst, or std::nullopt if dst cannot be reached. heuristic(v) must
+	// never overestimate the distance from v to dst; it only changes how many nodes are explored,
+	// and a heuristic of 0 gives Dijkstra's algorithm.
+	template<typename N, typename E, typename Heuristic>
+	requires std::is_arithmetic_v<E> and std::invocable<Heuristic&, std::uint32_t>
+	[[nodiscard]] auto astar(snapshot<N, E> const& s,
+	                         std::uint32_t src,
+	                         std::uint32_t dst,
+	                         Heuristic heuristic,
+	                         search_context<E>& context) -> std::optional<weighted_path<E>> {
+		// Time complexity
+		//        settle nodes     - k log(k), for the k nodes and edges explored
+		//     = O((n + e) log(n)) solution in the worst case
+		detail::check_endpoints(s, src, dst, "astar");
+		auto& state = context.forward();
+		state.begin(s.num_nodes());
+		context.backward().settled = 0;
+		state.relax(src, E{}, static_cast<E>(heuristic(src)), src);
+		while (not state.heap.empty()) {
+			auto const top = state.pop();
+			auto const u = top.node;
+			if (state.distance[u] < top.distance) {
+				continue; // Reached by a shorter path since this entry was queued
+			}
+			++state.settled;
+			if (u == dst) {
+				auto result = weighted_path<E>{top.distance, {}};
+				detail::append_parents(state, dst, result.nodes);
+				std::reverse(result.nodes.begin(), result.nodes.end());
+				return result;
+			}
+			auto const targets = s.neighbours(u);
+			auto const weights = s.weights(u);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				detail::check_weight(weights[k], "astar");
+				auto const v = targets[k];
+				auto const d = static_cast<E>(top.distance + weights[k]);
+				if (not state.reached(v) or d < state.distance[v]) {
+					state.relax(v, d, static_cast<E>(d + heuristic(v)), u);
+				}
+			}
+		}
+		return std::nullopt;
+	}
+
+	template<typename N, typename E, typename Heuristic>
+	requires std::is_arithmetic_v<E> and std::invocable<Heuristic&, std::uint32_t>
+	[[nodiscard]] auto astar(snapshot<N, E> const& s,
+	                         std::uint32_t src,
+	                         std::uint32_t dst,
+	                         Heuristic heuristic) -> std::optional<weighted_path<E>> {
+		auto context = search_context<E>();
+		return astar(s, src, dst, heuristic, context);
+	}
+
+	// Shortest path from src to dst, or std::nullopt if dst cannot be reached, searching
+	// forwards from src over s and backwards from dst over reversed, which must be transpose(s).
+	// Each step grows whichever search has the closer frontier, and the searches stop once no
+	// path through either frontier can be shorter than the best path found where they meet. On
+	// graphs without a useful heuristic this explores roughly two balls of half the radius of a
+	// one-sided search.
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	[[nodiscard]] auto bidirectional_dijkstra(snapshot<N, E> const& s,
+	                                          snapshot<N, E> const& reversed,
+	                                          std::uint32_t src,
+	                                          std::uint32_t dst,
+	                                          search_context<E>& context)
+	   -> std::optional<weighted_path<E>> {
+		// Time complexity
+		//        settle nodes     - k log(k), for the k nodes and edges explored
+		//     = O((n + e) log(n)) solution in the worst case
+		detail::check_endpoints(s, src, dst, "bidirectional_dijkstra");
+		if (reversed.num_nodes() != s.num_nodes() or reversed.num_edges() != s.num_edges()) {
+			throw std::runtime_error("Cannot call gdwg::bidirectional_dijkstra with a reversed "
+			                         "snapshot that is not the transpose of the snapshot");
+		}
+		auto& forward = context.forward();
+		auto& backward = context.backward();
+		forward.begin(s.num_nodes());
+		backward.begin(s.num_nodes());
+		forward.relax(src, E{}, E{}, src);
+		backward.relax(dst, E{}, E{}, dst);
+
+		// The shortest path found so far runs through meet
+		auto best = std::optional<E>();
+		auto meet = src;
+		if (src == dst) {
+			best = E{};
+		}
+		for (;;) {
+			forward.prune();
+			backward.prune();
+			if (forward.heap.empty() or backward.heap.empty()) {
+				break;
+			}
+			auto const bound = static_cast<E>(forward.heap.front().key + backward.heap.front().key);
+			if (best and not(bound < *best)) {
+				break;
+			}
+			auto const grow_forward = not(backward.heap.front().key < forward.heap.front().key);
+			auto& side = grow_forward ? forward : backward;
+			auto const& other = grow_forward ? backward : forward;
+			auto const& adjacency = grow_forward ? s : reversed;
+			auto const top = side.pop();
+			auto const u = top.node;
+			++side.settled;
+			auto const targets = adjacency.neighbours(u);
+			auto const weights = adjacency.weights(u);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				detail::check_weight(weights[k], "bidirectional_dijkstra");
+				auto const v = targets[k];
+				auto const d = static_cast<E>(top.distance + weights[k]);
+				side.relax(v, d, d, u);
+				if (other.reached(v)) {
+					auto const through = static_cast<E>(side.distance[v] + other.distance[v]);
+					if (not best or through < *best) {
+						best = through;
+						meet = v;
+					}
+				}
+			}
+		}
+		if (not best) {
+			return std::nullopt;
+		}
+
+		// Every parent was settled when it was recorded, so both halves add up to the current
+		// distances of meet, which can only have fallen to the optimum since it was chosen
+		auto const distance = static_cast<E>(forward.distance[meet] + backward.distance[meet]);
+		auto result = weighted_path<E>{distance, {}};
+		detail::append_parents(forward, meet, result.nodes);
+		std::reverse(result.nodes.begin(), result.nodes.end());
+		result.nodes.pop_back();
+		detail::append_parents(backward, meet, result.nodes);
+		return result;
+	}
+
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	[[nodiscard]] auto bidirectional_dijkstra(snapshot<N, E> const& s,
+	                                          snapshot<N, E> const& reversed,
+	                                          std::uint32_t src,
+	                                          std::uint32_t dst) -> std::optional<weighted_path<E>> {
+		auto context = search_context<E>();
+		return bidirectional_dijkstra(s, reversed, src, dst, context);
+	}
+
+	// Point-to-point queries on node values of a graph. The snapshot of the graph, its transpose
+	// and the search state are built once and kept, so each query costs only the part of the
+	// graph it explores. The query doesn't follow later changes to the graph.
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	class shortest_path_query {
+	public:
+		explicit shortest_path_query(graph<N, E> const& g)
+		: snapshot_(g)
+		, context_(snapshot_.num_nodes()) {}
+
+		[[nodiscard]] auto snapshot() const noexcept -> gdwg::snapshot<N, E> const& {
+			return snapshot_;
+		}
+
+		// Nodes whose distance was settled by the last query
+		[[nodiscard]] auto settled() const noexcept -> std::size_t {
+			return context_.settled();
+		}
+
+		// As astar() above, with heuristic(v) taking node values
+		template<typename Heuristic>
+		requires std::invocable<Heuristic&, N const&>
+		[[nodiscard]] auto astar(N const& src, N const& dst, Heuristic heuristic)
+		   -> std::optional<weighted_path<E, N>> {
+			auto const [src_id, dst_id] = detail::node_endpoints(snapshot_, src, dst, "astar");
+			auto const by_id = [&](std::uint32_t v) { return heuristic(snapshot_.node(v)); };
+			auto const path = gdwg::astar(snapshot_, src_id, dst_id, by_id, context_);
+			return detail::node_path(snapshot_, path);
+		}
+
+		// As bidirectional_dijkstra() above. The transpose is built by the first call.
+		[[nodiscard]] auto bidirectional_dijkstra(N const& src, N const& dst)
+		   -> std::optional<weighted_path<E, N>> {
+			auto const [src_id, dst_id] =
+			   detail::node_endpoints(snapshot_, src, dst, "bidirectional_dijkstra");
+			if (not reversed_) {
+				reversed_ = transpose(snapshot_);
+			}
+			auto const path =
+			   gdwg::bidirectional_dijkstra(snapshot_, *reversed_, src_id, dst_id, context_);
+			return detail::node_path(snapshot_, path);
+		}
+
+	private:
+		gdwg::snapshot<N, E> snapshot_;
+		std::optional<gdwg::snapshot<N, E>> reversed_;
+		search_context<E> context_;
+	};
+
+	// One-shot searches on node values. Each call snapshots the whole graph (and
+	// bidirectional_dijkstra also transposes it) and allocates fresh search state, so a single
+	// query costs O((n + e) log(n)) however little of the graph it explores. Repeated queries
+	// should use a shortest_path_query, or the snapshot overloads with a search_context.
+	template<typename N, typename E, typename Heuristic>
+	requires std::is_arithmetic_v<E> and std::invocable<Heuristic&, N const&>
+	[[nodiscard]] auto astar(graph<N, E> const& g, N const& src, N const& dst, Heuristic heuristic)
+	   -> std::optional<weighted_path<E, N>> {
+		// Time complexity
+		//        snapshot         - (n + e) log(n) +
+		//        search           - (n + e) log(n)
+		//     = O((n + e) log(n)) solution
+		return shortest_path_query<N, E>(g).astar(src, dst, heuristic);
+	}
+
+	template<typename N, typename E>
+	requires std::is_arithmetic_v<E>
+	[[nodiscard]] auto bidirectional_dijkstra(graph<N, E> const& g, N const& src, N const& dst)
+	   -> std::optional<weighted_path<E, N>> {
+		// Time complexity
+		//        snapshots        - (n + e) log(n) +
+		//        search           - (n + e) log(n)
+		//     = O((n + e) log(n)) solution
+		return shortest_path_query<N, E>(g).bidirectional_dijkstra(src, dst);
+	}
+} // namespace gdwg
+
+#endif // GDWG_SHORTEST_PATH_HPP
@@ -0,0 +1,533 @@
+#ifndef GDWG_SNAPSHOT_HPP
+#define GDWG_SNAPSHOT_HPP
+
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	template<typename N, typename E>
+	auto transpose(snapshot<N, E> const& s, std::size_t threads = 0) -> snapshot<N, E>;
+
+	// How a snapshot assigns ids to nodes. Every order other than natural gives up N-ordered
+	// ids for a layout where nodes that are visited together get nearby ids, which keeps
+	// traversals of large graphs inside fewer cache lines.
+	enum class ordering {
+		natural, // ids follow N's operator<
+		degree, // descending total (incoming + outgoing) degree, so hubs are packed together
+		rcm, // reverse Cuthill-McKee over the undirected graph, keeping neighbours' ids close
+		gorder, // greedy Gorder-style placement next to the nodes sharing the most neighbours
+	};
+
+	namespace detail {
+		// Unweighted CSR adjacency over snapshot ids
+		struct adjacency {
+			std::vector<std::size_t> offsets = std::vector<std::size_t>(1, 0);
+			std::vector<std::uint32_t> targets;
+
+			[[nodiscard]] auto degree(std::size_t id) const noexcept -> std::size_t {
+				return offsets[id + 1] - offsets[id];
+			}
+
+			[[nodiscard]] auto neighbours(std::size_t id) const noexcept -> std::span<std::uint32_t const> {
+				return {targets.data() + offsets[id], degree(id)};
+			}
+		};
+
+		template<typename N, typename E>
+		auto undirected_adjacency(snapshot<N, E> const& s) -> adjacency;
+
+		template<typename N, typename E>
+		auto reordering(snapshot<N, E> const& s, ordering order) -> std::vector<std::uint32_t>;
+	} // namespace detail
+
+	// An immutable, contiguous (CSR) copy of a graph.
+	//
+	// Every node is given a dense integer id, so ids can index plain arrays. By default ids follow
+	// the order of N's operator<; another ordering permutes them, and permutation() and
+	// inverse_permutation() translate between ids and positions in graph::nodes(). The outgoing
+	// edges of node u are targets()[offsets()[u]] up to targets()[offsets()[u + 1]], with their
+	// weights in the parallel weights() array. Each neighbour list is sorted by target id, with
+	// parallel edges next to each other in ascending weight order.
+	template<typename N, typename E>
+	class snapshot {
+	public:
+		using id_type = std::uint32_t;
+
+		// Constructors
+
+		snapshot() = default;
+
+		explicit snapshot(graph<N, E> const& g, ordering order = ordering::natural) {
+			// Time complexity
+			//        assign ids       - n +
+			//        copy edges       - e +
+			//        reorder          - e log(d) (plus the ordering itself)
+			//     = O(n + e log(d)) solution
+			if (g.repr_.size() >= std::numeric_limits<id_type>::max()) {
+				throw std::runtime_error("Cannot build gdwg::snapshot<N, E> from a graph with more "
+				                         "than 2^32 - 1 nodes");
+			}
+			auto ids = std::unordered_map<N const*, id_type>(g.repr_.size());
+			nodes_.reserve(g.repr_.size());
+			for (auto const& [node, edges] : g.repr_) {
+				ids.emplace(node, static_cast<id_type>(nodes_.size()));
+				nodes_.push_back(*node);
+			}
+
+			offsets_.reserve(nodes_.size() + 1); // offsets_ already holds the leading 0
+			for (auto const& [node, edges] : g.repr_) {
+				for (auto const& [to, weight] : edges) {
+					targets_.push_back(ids.find(to)->second);
+					weights_.push_back(weight);
+				}
+				offsets_.push_back(targets_.size());
+			}
+
+			permutation_.resize(nodes_.size());
+			std::iota(permutation_.begin(), permutation_.end(), id_type{0});
+			inverse_permutation_ = permutation_;
+			if (order != ordering::natural) {
+				relabel(detail::reordering(*this, order));
+			}
+			order_ = order;
+		}
+
+		// Accessors
+
+		[[nodiscard]] auto num_nodes() const noexcept -> std::size_t {
+			return nodes_.size();
+		}
+
+		[[nodiscard]] auto num_edges() const noexcept -> std::size_t {
+			return targets_.size();
+		}
+
+		[[nodiscard]] auto order() const noexcept -> ordering {
+			return order_;
+		}
+
+		[[nodiscard]] auto node(id_type id) const -> N const& {
+			return nodes_.at(id);
+		}
+
+		[[nodiscard]] auto id(N const& value) const -> std::optional<id_type> {
+			// O(log(n)), searching the ids in N order
+			auto const it = std::ranges::lower_bound(permutation_,
+			                                         value,
+			                                         std::less<>{},
+			                                         [&](id_type id) -> N const& { return nodes_[id]; });
+			if (it != permutation_.end() and not(value < nodes_[*it])) {
+				return *it;
+			}
+			return std::nullopt;
+		}
+
+		[[nodiscard]] auto out_degree(id_type id) const noexcept -> std::size_t {
+			return offsets_[id + 1] - offsets_[id];
+		}
+
+		[[nodiscard]] auto neighbours(id_type id) const noexcept -> std::span<id_type const> {
+			return {targets_.data() + offsets_[id], out_degree(id)};
+		}
+
+		[[nodiscard]] auto weights(id_type id) const noexcept -> std::span<E const> {
+			return {weights_.data() + offsets_[id], out_degree(id)};
+		}
+
+		[[nodiscard]] auto nodes() const noexcept -> std::span<N const> {
+			return nodes_;
+		}
+
+		[[nodiscard]] auto offsets() const noexcept -> std::span<std::size_t const> {
+			return offsets_;
+		}
+
+		[[nodiscard]] auto targets() const noexcept -> std::span<id_type const> {
+			return targets_;
+		}
+
+		[[nodiscard]] auto weights() const noexcept -> std::span<E const> {
+			return weights_;
+		}
+
+		// permutation()[i] is the id of the i-th node of graph::nodes(), and
+		// inverse_permutation()[id] is that node's position in graph::nodes(). Both are the
+		// identity for ordering::natural.
+
+		[[nodiscard]] auto permutation() const noexcept -> std::span<id_type const> {
+			return permutation_;
+		}
+
+		[[nodiscard]] auto inverse_permutation() const noexcept -> std::span<id_type const> {
+			return inverse_permutation_;
+		}
+
+	private:
+		std::vector<N> nodes_;
+		std::vector<std::size_t> offsets_ = std::vector<std::size_t>(1, 0);
+		std::vector<id_type> targets_;
+		std::vector<E> weights_;
+		std::vector<id_type> permutation_;
+		std::vector<id_type> inverse_permutation_;
+		ordering order_ = ordering::natural;
+
+		// Renumbers every node u of a naturally ordered snapshot to new_id[u]
+		auto relabel(std::vector<id_type> const& new_id) -> void {
+			auto const n = nodes_.size();
+			auto old_id = std::vector<id_type>(n);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				old_id[new_id[u]] = static_cast<id_type>(u);
+			}
+
+			auto nodes = std::vector<N>();
+			auto offsets = std::vector<std::size_t>(1, 0);
+			auto targets = std::vector<id_type>();
+			auto weights = std::vector<E>();
+			nodes.reserve(n);
+			offsets.reserve(n + 1);
+			targets.reserve(targets_.size());
+			weights.reserve(weights_.size());
+			auto order = std::vector<std::size_t>();
+			for (auto const u : old_id) {
+				nodes.push_back(std::move(nodes_[u]));
+				// A stable sort by new target id keeps parallel edges in weight order
+				order.resize(offsets_[u + 1] - offsets_[u]);
+				std::iota(order.begin(), order.end(), offsets_[u]);
+				std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+					return new_id[targets_[a]] < new_id[targets_[b]];
+				});
+				for (auto const e : order) {
+					targets.push_back(new_id[targets_[e]]);
+					weights.push_back(std::move(weights_[e]));
+				}
+				offsets.push_back(targets.size());
+			}
+
+			nodes_ = std::move(nodes);
+			offsets_ = std::move(offsets);
+			targets_ = std::move(targets);
+			weights_ = std::move(weights);
+			permutation_ = new_id;
+			inverse_permutation_ = std::move(old_id);
+		}
+
+		friend auto transpose<>(snapshot const& s, std::size_t threads) -> snapshot;
+	};
+
+	template<typename N, typename E>
+	snapshot(graph<N, E> const&) -> snapshot<N, E>;
+
+	// The snapshot of the reversed graph: neighbours(u) lists the sources of u's incoming edges,
+	// sorted, with parallel edges in ascending weight order. Ids are unchanged.
+	template<typename N, typename E>
+	auto transpose(snapshot<N, E> const& s, std::size_t threads) -> snapshot<N, E> {
+		// Time complexity
+		//        count per block      - e +
+		//        prefix sums          - n * b +
+		//        scatter per block    - e
+		//     = O(n * b + e) solution, for b blocks of sources
+		auto const n = s.num_nodes();
+		auto const m = s.num_edges();
+
+		// Sources are split into contiguous blocks that are counted and scattered independently.
+		// Each block owns a column of per-destination cursors, so the number of blocks is capped
+		// to keep that table no larger than the edge arrays.
+		auto const blocks = std::clamp<std::size_t>(m / std::max<std::size_t>(n, 1),
+		                                            1,
+		                                            detail::thread_count(threads));
+		auto const block_begin = [&](std::size_t b) { return n * b / blocks; };
+		auto cursor = std::vector<std::size_t>(blocks * n, 0);
+		detail::parallel_for(
+		   blocks,
+		   threads,
+		   [&](std::size_t b, std::size_t) {
+			   auto* const count = cursor.data() + b * n;
+			   for (auto e = s.offsets_[block_begin(b)]; e < s.offsets_[block_begin(b + 1)]; ++e) {
+				   ++count[s.targets_[e]];
+			   }
+		   },
+		   1);
+
+		auto result = snapshot<N, E>();
+		result.nodes_ = s.nodes_;
+		result.permutation_ = s.permutation_;
+		result.inverse_permutation_ = s.inverse_permutation_;
+		result.order_ = s.order_;
+		result.offsets_.resize(n + 1);
+		auto position = std::size_t{0};
+		for (auto v = std::size_t{0}; v < n; ++v) {
+			// Within a destination, lower blocks (i.e. lower sources) come first
+			for (auto b = std::size_t{0}; b < blocks; ++b) {
+				auto const count = cursor[b * n + v];
+				cursor[b * n + v] = position;
+				position += count;
+			}
+			result.offsets_[v + 1] = position;
+		}
+
+		result.targets_.resize(m);
+		result.weights_.resize(m);
+		detail::parallel_for(
+		   blocks,
+		   threads,
+		   [&](std::size_t b, std::size_t) {
+			   auto* const next = cursor.data() + b * n;
+			   for (auto u = block_begin(b); u < block_begin(b + 1); ++u) {
+				   for (auto e = s.offsets_[u]; e < s.offsets_[u + 1]; ++e) {
+					   auto const slot = next[s.targets_[e]]++;
+					   result.targets_[slot] = static_cast<typename snapshot<N, E>::id_type>(u);
+					   result.weights_[slot] = s.weights_[e];
+				   }
+			   }
+		   },
+		   1);
+		return result;
+	}
+
+	namespace detail {
+		// The simple undirected graph underlying a snapshot: u and v are neighbours when u -> v or
+		// v -> u, ignoring weights, parallel edges and self-loops. Every list is strictly increasing.
+		template<typename N, typename E>
+		auto undirected_adjacency(snapshot<N, E> const& s) -> adjacency {
+			// Time complexity
+			//        bucket incoming edges    - n + e +
+			//        merge in and out lists   - n + e
+			//     = O(n + e) solution
+			auto const n = s.num_nodes();
+			auto const offsets = s.offsets();
+			auto const targets = s.targets();
+
+			// Counting sort by target. Sources are visited in ascending order, so every incoming
+			// list comes out sorted.
+			auto in_offsets = std::vector<std::size_t>(n + 1, 0);
+			for (auto const target : targets) {
+				++in_offsets[target + 1];
+			}
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				in_offsets[u + 1] += in_offsets[u];
+			}
+			auto in_sources = std::vector<std::uint32_t>(targets.size());
+			auto cursor = std::vector<std::size_t>(in_offsets.begin(), in_offsets.end() - 1);
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+					in_sources[cursor[targets[e]]++] = static_cast<std::uint32_t>(u);
+				}
+			}
+
+			auto result = adjacency{};
+			result.offsets.reserve(n + 1);
+			result.targets.reserve(2 * targets.size());
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				auto const first = result.targets.size();
+				auto const append = [&](std::uint32_t v) {
+					if (v != u and (result.targets.size() == first or result.targets.back() != v)) {
+						result.targets.push_back(v);
+					}
+				};
+				auto i = offsets[u];
+				auto j = in_offsets[u];
+				while (i < offsets[u + 1] or j < in_offsets[u + 1]) {
+					if (j == in_offsets[u + 1] or (i < offsets[u + 1] and targets[i] <= in_sources[j])) {
+						append(targets[i++]);
+					}
+					else {
+						append(in_sources[j++]);
+					}
+				}
+				result.offsets.push_back(result.targets.size());
+			}
+			return result;
+		}
+
+		// Ids numbered in the order of a sequence holding every node once
+		inline auto ids_from_sequence(std::vector<std::uint32_t> const& sequence)
+		   -> std::vector<std::uint32_t> {
+			auto result = std::vector<std::uint32_t>(sequence.size());
+			for (auto i = std::size_t{0}; i < sequence.size(); ++i) {
+				result[sequence[i]] = static_cast<std::uint32_t>(i);
+			}
+			return result;
+		}
+
+		// Nodes sorted by descending degree, breaking ties by id
+		template<typename Degree>
+		auto by_degree_descending(std::size_t n, Degree degree) -> std::vector<std::uint32_t> {
+			auto result = std::vector<std::uint32_t>(n);
+			std::iota(result.begin(), result.end(), std::uint32_t{0});
+			std::stable_sort(result.begin(), result.end(), [&](std::uint32_t a, std::uint32_t b) {
+				return degree(a) > degree(b);
+			});
+			return result;
+		}
+
+		template<typename N, typename E>
+		auto degree_ordering(snapshot<N, E> const& s) -> std::vector<std::uint32_t> {
+			// Time complexity
+			//        count degrees    - n + e +
+			//        sort             - n log(n)
+			//     = O(e + n log(n)) solution
+			auto degree = std::vector<std::size_t>(s.num_nodes(), 0);
+			for (auto u = std::size_t{0}; u < s.num_nodes(); ++u) {
+				degree[u] += s.out_degree(static_cast<std::uint32_t>(u));
+			}
+			for (auto const v : s.targets()) {
+				++degree[v];
+			}
+			return ids_from_sequence(
+			   by_degree_descending(s.num_nodes(), [&](std::uint32_t u) { return degree[u]; }));
+		}
+
+		template<typename N, typename E>
+		auto rcm_ordering(snapshot<N, E> const& s) -> std::vector<std::uint32_t> {
+			// Time complexity
+			//        undirected adjacency    - n + e +
+			//        breadth-first search    - e log(d) (neighbours sorted by degree)
+			//     = O(n log(n) + e log(d)) solution
+			auto const adj = undirected_adjacency(s);
+			auto const n = s.num_nodes();
+			// Each component is searched from its lowest-degree node, a cheap stand-in for a
+			// pseudo-peripheral start
+			auto starts = by_degree_descending(n, [&](std::uint32_t u) { return adj.degree(u); });
+			std::reverse(starts.begin(), starts.end());
+
+			auto visited = std::vector<bool>(n, false);
+			auto sequence = std::vector<std::uint32_t>();
+			sequence.reserve(n);
+			auto next = std::vector<std::uint32_t>();
+			for (auto const start : starts) {
+				if (visited[start]) {
+					continue;
+				}
+				visited[start] = true;
+				sequence.push_back(start);
+				// sequence doubles as the queue of the breadth-first search
+				for (auto head = sequence.size() - 1; head < sequence.size(); ++head) {
+					next.clear();
+					for (auto const v : adj.neighbours(sequence[head])) {
+						if (not visited[v]) {
+							visited[v] = true;
+							next.push_back(v);
+						}
+					}
+					std::stable_sort(next.begin(), next.end(), [&](std::uint32_t a, std::uint32_t b) {
+						return adj.degree(a) < adj.degree(b);
+					});
+					sequence.insert(sequence.end(), next.begin(), next.end());
+				}
+			}
+			std::reverse(sequence.begin(), sequence.end());
+			return ids_from_sequence(sequence);
+		}
+
+		template<typename N, typename E>
+		auto gorder_ordering(snapshot<N, E> const& s) -> std::vector<std::uint32_t> {
+			// Time complexity
+			//        undirected adjacency    - n + e +
+			//        window updates          - e * 32 * log(n)
+			//
+			// Gorder places, one at a time, the node with the most neighbour and shared-neighbour
+			// relations to the last few nodes placed. This keeps its window and scoring, but only
+			// counts shared neighbours through nodes of low degree, since relations through hubs
+			// say little about locality and dominate the cost, and replaces its unit heap with a
+			// lazy binary heap.
+			constexpr auto window = std::size_t{5};
+			constexpr auto hub_degree = std::size_t{32};
+			auto const adj = undirected_adjacency(s);
+			auto const n = s.num_nodes();
+
+			auto score = std::vector<std::uint32_t>(n, 0);
+			auto placed = std::vector<bool>(n, false);
+			auto heap = std::priority_queue<std::pair<std::uint32_t, std::uint32_t>>();
+			auto const bump = [&](std::uint32_t v, bool up) {
+				if (not placed[v]) {
+					if (up) {
+						heap.emplace(++score[v], v); // Older entries for v are now stale
+					}
+					else {
+						--score[v]; // v's entry is refreshed when it reaches the top
+					}
+				}
+			};
+			auto const update = [&](std::uint32_t u, bool up) {
+				for (auto const v : adj.neighbours(u)) {
+					bump(v, up);
+					if (adj.degree(v) <= hub_degree) {
+						for (auto const w : adj.neighbours(v)) {
+							if (w != u) {
+								bump(w, up);
+							}
+						}
+					}
+				}
+			};
+
+			auto const seeds = by_degree_descending(n, [&](std::uint32_t u) { return adj.degree(u); });
+			auto next_seed = std::size_t{0};
+			auto sequence = std::vector<std::uint32_t>();
+			sequence.reserve(n);
+			while (sequence.size() < n) {
+				auto best = std::optional<std::uint32_t>();
+				while (not heap.empty() and not best) {
+					auto const [value, v] = heap.top();
+					heap.pop();
+					if (placed[v] or value < score[v]) {
+						continue; // Stale, as v was placed or has a newer entry
+					}
+					if (value > score[v]) {
+						if (score[v] > 0) {
+							heap.emplace(score[v], v); // Lowered since it was pushed
+						}
+						continue;
+					}
+					best = v;
+				}
+				if (not best) {
+					// Nothing relates to the window, so start again from the largest hub left
+					while (placed[seeds[next_seed]]) {
+						++next_seed;
+					}
+					best = seeds[next_seed];
+				}
+
+				placed[*best] = true;
+				sequence.push_back(*best);
+				update(*best, true);
+				if (sequence.size() > window) {
+					update(sequence[sequence.size() - 1 - window], false);
+				}
+			}
+			return ids_from_sequence(sequence);
+		}
+
+		// The new id of every node of a naturally ordered snapshot
+		template<typename N, typename E>
+		auto reordering(snapshot<N, E> const& s, ordering order) -> std::vector<std::uint32_t> {
+			switch (order) {
+			case ordering::degree: return degree_ordering(s);
+			case ordering::rcm: return rcm_ordering(s);
+			case ordering::gorder: return gorder_ordering(s);
+			case ordering::natural: break;
+			}
+			auto result = std::vector<std::uint32_t>(s.num_nodes());
+			std::iota(result.begin(), result.end(), std::uint32_t{0});
+			return result;
+		}
+	} // namespace detail
+} // namespace gdwg
+
+#endif // GDWG_SNAPSHOT_HPP
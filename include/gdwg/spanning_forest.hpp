@@ -0,0 +1,139 @@
+#ifndef GDWG_SPANNING_FOREST_HPP
+#define GDWG_SPANNING_FOREST_HPP
+
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/detail/union_find.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace gdwg {
+	// Minimum spanning forest of the undirected graph underlying a graph: a spanning tree of
+	// every connected component, ignoring edge direction, with the smallest total weight.
+	// Self-loops are never used, and of parallel edges (in either direction) only the lightest
+	// can be. The edges are returned as they are in the graph, lightest first.
+	//
+	// Boruvka's algorithm: in each round every component picks its lightest edge to another
+	// component, and all those edges are added at once through a concurrent union-find. Ties
+	// are broken by the order of the snapshot's edges (that of graph::begin() for a natural
+	// snapshot), which makes the forest unique, so the result does not depend on the number of
+	// threads. Edges inside a component are dropped after each round, and the number of
+	// components at least halves, so there are at most log(n) rounds.
+	template<typename N, typename E>
+	[[nodiscard]] auto minimum_spanning_forest(snapshot<N, E> const& s, std::size_t threads = 0)
+	   -> std::vector<typename graph<N, E>::value_type> {
+		// Time complexity
+		//        sort edges        - e log(e) +
+		//        rounds            - (n + e) log(n) / p, for p threads
+		//     = O(e log(e) + (n + e) log(n) / p) solution
+		constexpr auto none = std::numeric_limits<std::uint64_t>::max();
+		auto const n = s.num_nodes();
+
+		// edges[r] is the edge of rank r, lightest first, so comparing ranks compares
+		// (weight, position in the snapshot)
+		auto sources = std::vector<std::uint32_t>(s.num_edges());
+		auto const offsets = s.offsets();
+		for (auto u = std::uint32_t{0}; u < n; ++u) {
+			std::fill(sources.begin() + static_cast<std::ptrdiff_t>(offsets[u]),
+			          sources.begin() + static_cast<std::ptrdiff_t>(offsets[u + 1]),
+			          u);
+		}
+		auto const targets = s.targets();
+		auto const weights = s.weights();
+		auto edges = std::vector<std::size_t>(s.num_edges());
+		std::iota(edges.begin(), edges.end(), std::size_t{0});
+		std::erase_if(edges, [&](std::size_t e) { return sources[e] == targets[e]; });
+		std::stable_sort(edges.begin(), edges.end(), [&](std::size_t a, std::size_t b) {
+			return weights[a] < weights[b];
+		});
+
+		auto sets = detail::concurrent_union_find(n);
+		auto lightest = std::vector<std::atomic<std::uint64_t>>(n);
+		auto chosen = std::vector<std::vector<std::size_t>>(detail::thread_count(threads));
+		auto live = std::vector<std::size_t>(edges.size()); // Ranks of edges between components
+		std::iota(live.begin(), live.end(), std::size_t{0});
+		auto keep = std::vector<std::uint8_t>();
+		while (not live.empty()) {
+			detail::parallel_for(
+			   n,
+			   threads,
+			   [&](std::size_t u, std::size_t) { lightest[u].store(none, std::memory_order_relaxed); },
+			   4096);
+
+			// Every component keeps the lowest rank among its edges
+			auto const offer = [&](std::uint32_t root, std::uint64_t r) {
+				auto& slot = lightest[root];
+				auto current = slot.load(std::memory_order_relaxed);
+				while (r < current
+				       and not slot.compare_exchange_weak(current, r, std::memory_order_relaxed)) {
+				}
+			};
+			detail::parallel_for(
+			   live.size(),
+			   threads,
+			   [&](std::size_t i, std::size_t) {
+				   auto const e = edges[live[i]];
+				   offer(sets.find(sources[e]), live[i]);
+				   offer(sets.find(targets[e]), live[i]);
+			   },
+			   1024);
+
+			// Two components may pick the same edge, but only the first union adds it
+			detail::parallel_for(
+			   n,
+			   threads,
+			   [&](std::size_t u, std::size_t worker) {
+				   auto const r = lightest[u].load(std::memory_order_relaxed);
+				   if (r != none and sets.unite(sources[edges[r]], targets[edges[r]])) {
+					   chosen[worker].push_back(r);
+				   }
+			   },
+			   1024);
+
+			keep.assign(live.size(), 0);
+			detail::parallel_for(
+			   live.size(),
+			   threads,
+			   [&](std::size_t i, std::size_t) {
+				   auto const e = edges[live[i]];
+				   keep[i] = sets.find(sources[e]) != sets.find(targets[e]) ? 1 : 0;
+			   },
+			   1024);
+			auto kept = std::size_t{0};
+			for (auto i = std::size_t{0}; i < live.size(); ++i) {
+				if (keep[i] != 0) {
+					live[kept++] = live[i];
+				}
+			}
+			live.resize(kept);
+		}
+
+		auto forest = std::vector<std::size_t>();
+		for (auto const& part : chosen) {
+			forest.insert(forest.end(), part.begin(), part.end());
+		}
+		std::sort(forest.begin(), forest.end());
+		auto result = std::vector<typename graph<N, E>::value_type>();
+		result.reserve(forest.size());
+		for (auto const r : forest) {
+			auto const e = edges[r];
+			result.push_back({s.node(sources[e]), s.node(targets[e]), weights[e]});
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto minimum_spanning_forest(graph<N, E> const& g, std::size_t threads = 0)
+	   -> std::vector<typename graph<N, E>::value_type> {
+		return minimum_spanning_forest(snapshot<N, E>(g), threads);
+	}
+} // namespace gdwg
+
+#endif // GDWG_SPANNING_FOREST_HPP
@@ -0,0 +1,100 @@
+#ifndef GDWG_TRAVERSAL_HPP
+#define GDWG_TRAVERSAL_HPP
+
+#include "gdwg/detail/parallel.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Whole-graph traversals over a snapshot. Results are indexed by snapshot id; for a reordered
+// snapshot, inverse_permutation() maps them back to the order of graph::nodes().
+namespace gdwg {
+	// Distance of a node that cannot be reached
+	inline constexpr auto unreachable = std::numeric_limits<std::uint32_t>::max();
+
+	// Number of edges on a shortest path from source to every node, ignoring weights
+	template<typename N, typename E>
+	[[nodiscard]] auto bfs_distances(snapshot<N, E> const& s, typename snapshot<N, E>::id_type source)
+	   -> std::vector<std::uint32_t> {
+		// Time complexity
+		//        visit every reachable node and edge once
+		//     = O(n + e) solution
+		if (source >= s.num_nodes()) {
+			throw std::runtime_error("Cannot call gdwg::bfs_distances on a source that doesn't exist "
+			                         "in the snapshot");
+		}
+		auto distance = std::vector<std::uint32_t>(s.num_nodes(), unreachable);
+		auto queue = std::vector<std::uint32_t>();
+		queue.reserve(s.num_nodes());
+		distance[source] = 0;
+		queue.push_back(source);
+		for (auto head = std::size_t{0}; head < queue.size(); ++head) {
+			auto const u = queue[head];
+			for (auto const v : s.neighbours(u)) {
+				if (distance[v] == unreachable) {
+					distance[v] = distance[u] + 1;
+					queue.push_back(v);
+				}
+			}
+		}
+		return distance;
+	}
+
+	// PageRank with the given damping factor, treating each parallel edge as a separate link.
+	// The rank of nodes without outgoing edges is spread evenly over every node. The ranks sum
+	// to 1.
+	template<typename N, typename E>
+	[[nodiscard]] auto pagerank(snapshot<N, E> const& s,
+	                            std::size_t iterations = 20,
+	                            double damping = 0.85,
+	                            std::size_t threads = 0) -> std::vector<double> {
+		// Time complexity
+		//        transpose     - n + e +
+		//        iterations    - k * (n + e)
+		//     = O(k * (n + e)) solution
+		auto const n = s.num_nodes();
+		if (n == 0) {
+			return {};
+		}
+		// Each node pulls from its incoming edges, so no two threads write the same rank
+		auto const incoming = transpose(s, threads);
+		auto const share = 1.0 / static_cast<double>(n);
+		auto rank = std::vector<double>(n, share);
+		auto next = std::vector<double>(n);
+		auto contribution = std::vector<double>(n);
+		for (auto i = std::size_t{0}; i < iterations; ++i) {
+			auto dangling = 0.0;
+			for (auto u = std::size_t{0}; u < n; ++u) {
+				auto const degree = s.out_degree(static_cast<std::uint32_t>(u));
+				if (degree == 0) {
+					dangling += rank[u];
+					contribution[u] = 0.0;
+				}
+				else {
+					contribution[u] = rank[u] / static_cast<double>(degree);
+				}
+			}
+			auto const base = (1.0 - damping) * share + damping * dangling * share;
+			detail::parallel_for(
+			   n,
+			   threads,
+			   [&](std::size_t v, std::size_t) {
+				   auto sum = 0.0;
+				   for (auto const u : incoming.neighbours(static_cast<std::uint32_t>(v))) {
+					   sum += contribution[u];
+				   }
+				   next[v] = base + damping * sum;
+			   },
+			   1024);
+			rank.swap(next);
+		}
+		return rank;
+	}
+} // namespace gdwg
+
+#endif // GDWG_TRAVERSAL_HPP
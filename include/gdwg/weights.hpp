@@ -0,0 +1,223 @@
+#ifndef GDWG_WEIGHTS_HPP
+#define GDWG_WEIGHTS_HPP
+
+#include "gdwg/detail/simd.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// Weight filters and reductions over the columnar layout of a snapshot, where the weights of
+// every node's outgoing edges are one contiguous run. Arithmetic weights use the SIMD kernels in
+// detail/simd.hpp; any other E only needs operator+ (sums) or operator< (min and max).
+namespace gdwg {
+	namespace detail {
+		template<typename E>
+		auto sum_weights(E const* values, std::size_t n, simd::isa level) -> E {
+			if constexpr (std::is_arithmetic_v<E>) {
+				return simd::reduce_sum(values, n, level);
+			}
+			else {
+				auto total = E{};
+				for (auto i = std::size_t{0}; i < n; ++i) {
+					total = total + values[i];
+				}
+				return total;
+			}
+		}
+
+		template<typename E, typename Compare>
+		auto extreme_weight(E const* values, std::size_t n, Compare better, simd::isa level)
+		   -> std::optional<E> {
+			if (n == 0) {
+				return std::nullopt;
+			}
+			if constexpr (std::is_arithmetic_v<E>) {
+				return simd::reduce_extreme(values, n, better, level);
+			}
+			else {
+				auto const* result = values;
+				for (auto i = std::size_t{1}; i < n; ++i) {
+					if (better(values[i], *result)) {
+						result = values + i;
+					}
+				}
+				return *result;
+			}
+		}
+
+		template<typename N, typename E, typename Compare>
+		auto out_extremes(snapshot<N, E> const& s, Compare better) -> std::vector<std::optional<E>> {
+			auto const level = simd::best_isa();
+			auto const weights = s.weights();
+			auto result = std::vector<std::optional<E>>();
+			result.reserve(s.num_nodes());
+			for (auto u = std::size_t{0}; u < s.num_nodes(); ++u) {
+				result.push_back(extreme_weight(weights.data() + s.offsets()[u],
+				                                s.out_degree(static_cast<std::uint32_t>(u)),
+				                                better,
+				                                level));
+			}
+			return result;
+		}
+
+		template<typename N, typename E, typename Compare>
+		auto in_extremes(snapshot<N, E> const& s, Compare better) -> std::vector<std::optional<E>> {
+			// Incoming weights are scattered across sources, so this is a scalar pass
+			auto const targets = s.targets();
+			auto const weights = s.weights();
+			auto result = std::vector<std::optional<E>>(s.num_nodes());
+			for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+				auto& best = result[targets[e]];
+				if (not best or better(weights[e], *best)) {
+					best = weights[e];
+				}
+			}
+			return result;
+		}
+	} // namespace detail
+
+	// Every edge whose weight satisfies pred, in the graph's iteration order
+	template<typename N, typename E, typename Predicate>
+	[[nodiscard]] auto filter_edges(snapshot<N, E> const& s, Predicate pred)
+	   -> std::vector<typename graph<N, E>::value_type> {
+		// Time complexity
+		//        evaluate predicate    - e +
+		//        copy matching edges   - n + k
+		//     = O(n + e) solution
+		auto const weights = s.weights();
+		auto const targets = s.targets();
+
+		// The predicate runs over the contiguous weight column into a byte mask first, which the
+		// compiler can vectorise for simple comparisons, before any node is copied
+		auto keep = std::vector<std::uint8_t>(weights.size());
+		for (auto e = std::size_t{0}; e < weights.size(); ++e) {
+			keep[e] = static_cast<std::uint8_t>(static_cast<bool>(std::invoke(pred, weights[e])));
+		}
+
+		auto result = std::vector<typename graph<N, E>::value_type>();
+		for (auto u = std::size_t{0}; u < s.num_nodes(); ++u) {
+			for (auto e = s.offsets()[u]; e < s.offsets()[u + 1]; ++e) {
+				if (keep[e] != 0) {
+					result.push_back(
+					   {s.node(static_cast<std::uint32_t>(u)), s.node(targets[e]), weights[e]});
+				}
+			}
+		}
+		return result;
+	}
+
+	template<typename N, typename E, typename Predicate>
+	[[nodiscard]] auto filter_edges(graph<N, E> const& g, Predicate pred)
+	   -> std::vector<typename graph<N, E>::value_type> {
+		return filter_edges(snapshot<N, E>(g), pred);
+	}
+
+	// Per-node reductions, indexed by snapshot id (i.e. in the order of graph::nodes()). Nodes
+	// without edges in the given direction have a sum of E{} and no minimum or maximum.
+
+	template<typename N, typename E>
+	[[nodiscard]] auto out_weight_sum(snapshot<N, E> const& s) -> std::vector<E> {
+		auto const level = detail::simd::best_isa();
+		auto const weights = s.weights();
+		auto result = std::vector<E>();
+		result.reserve(s.num_nodes());
+		for (auto u = std::size_t{0}; u < s.num_nodes(); ++u) {
+			result.push_back(detail::sum_weights(weights.data() + s.offsets()[u],
+			                                     s.out_degree(static_cast<std::uint32_t>(u)),
+			                                     level));
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto out_weight_min(snapshot<N, E> const& s) -> std::vector<std::optional<E>> {
+		return detail::out_extremes(s, std::less<E>{});
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto out_weight_max(snapshot<N, E> const& s) -> std::vector<std::optional<E>> {
+		return detail::out_extremes(s, std::greater<E>{});
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto in_weight_sum(snapshot<N, E> const& s) -> std::vector<E> {
+		auto const targets = s.targets();
+		auto const weights = s.weights();
+		auto result = std::vector<E>(s.num_nodes());
+		for (auto e = std::size_t{0}; e < targets.size(); ++e) {
+			result[targets[e]] = result[targets[e]] + weights[e];
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto in_weight_min(snapshot<N, E> const& s) -> std::vector<std::optional<E>> {
+		return detail::in_extremes(s, std::less<E>{});
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto in_weight_max(snapshot<N, E> const& s) -> std::vector<std::optional<E>> {
+		return detail::in_extremes(s, std::greater<E>{});
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto out_weight_sum(graph<N, E> const& g) -> std::vector<E> {
+		return out_weight_sum(snapshot<N, E>(g));
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto out_weight_min(graph<N, E> const& g) -> std::vector<std::optional<E>> {
+		return out_weight_min(snapshot<N, E>(g));
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto out_weight_max(graph<N, E> const& g) -> std::vector<std::optional<E>> {
+		return out_weight_max(snapshot<N, E>(g));
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto in_weight_sum(graph<N, E> const& g) -> std::vector<E> {
+		return in_weight_sum(snapshot<N, E>(g));
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto in_weight_min(graph<N, E> const& g) -> std::vector<std::optional<E>> {
+		return in_weight_min(snapshot<N, E>(g));
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto in_weight_max(graph<N, E> const& g) -> std::vector<std::optional<E>> {
+		return in_weight_max(snapshot<N, E>(g));
+	}
+
+	// Whole-graph reductions over the weight column
+
+	template<typename N, typename E>
+	[[nodiscard]] auto weight_sum(snapshot<N, E> const& s) -> E {
+		return detail::sum_weights(s.weights().data(), s.num_edges(), detail::simd::best_isa());
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto weight_min(snapshot<N, E> const& s) -> std::optional<E> {
+		return detail::extreme_weight(s.weights().data(),
+		                              s.num_edges(),
+		                              std::less<E>{},
+		                              detail::simd::best_isa());
+	}
+
+	template<typename N, typename E>
+	[[nodiscard]] auto weight_max(snapshot<N, E> const& s) -> std::optional<E> {
+		return detail::extreme_weight(s.weights().data(),
+		                              s.num_edges(),
+		                              std::greater<E>{},
+		                              detail::simd::best_isa());
+	}
+} // namespace gdwg
+
+#endif // GDWG_WEIGHTS_HPP
@@ -0,0 +1,24 @@
+#ifndef GDWG_TEST_EDGE_TUPLES_HPP
+#define GDWG_TEST_EDGE_TUPLES_HPP
+
+#include "gdwg/graph.hpp"
+
+#include <tuple>
+#include <vector>
+
+// Shared by the test files that compare lists of edges, which value_type can't be compared as
+
+namespace helper {
+	template<typename Edge>
+	auto as_tuples(std::vector<Edge> const& edges)
+	   -> std::vector<std::tuple<decltype(Edge::from), decltype(Edge::to), decltype(Edge::weight)>> {
+		auto result =
+		   std::vector<std::tuple<decltype(Edge::from), decltype(Edge::to), decltype(Edge::weight)>>();
+		for (auto const& [from, to, weight] : edges) {
+			result.emplace_back(from, to, weight);
+		}
+		return result;
+	}
+} // namespace helper
+
+#endif // GDWG_TEST_EDGE_TUPLES_HPP
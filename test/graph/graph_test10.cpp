@@ -0,0 +1,115 @@
+#include "gdwg/graph.hpp"
+#include "random_graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Merge and Union
+
+namespace helper {
+	// The union built one insertion at a time, to compare merge() against
+	template<typename N, typename E>
+	auto union_by_insertion(gdwg::graph<N, E> const& a, gdwg::graph<N, E> const& b)
+	   -> gdwg::graph<N, E> {
+		auto result = a;
+		for (auto const& node : b.nodes()) {
+			result.insert_node(node);
+		}
+		for (auto const& [from, to, weight] : b) {
+			result.insert_edge(from, to, weight);
+		}
+		return result;
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test merge() adds the nodes and edges of another graph") {
+	auto g = gdwg::graph<std::string, int>{"a", "c", "e"};
+	g.insert_edge("a", "c", 1);
+	g.insert_edge("c", "e", 2);
+	g.insert_edge("e", "a", 3);
+
+	auto other = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	other.insert_edge("a", "c", 1);
+	other.insert_edge("a", "c", 0);
+	other.insert_edge("b", "c", 4);
+	other.insert_edge("c", "a", 5);
+	other.insert_edge("d", "d", 6);
+
+	auto const expected = union_by_insertion(g, other);
+
+	SECTION("Check merging a copy keeps the other graph") {
+		g.merge(other);
+		CHECK(g == expected);
+		CHECK(g.num_nodes() == 5);
+		CHECK(g.num_edges() == 7);
+		CHECK(g.hash() == expected.hash());
+		CHECK(other.num_edges() == 5);
+		CHECK(g.weights("a", "c") == std::vector<int>{0, 1});
+	}
+
+	SECTION("Check merging an rvalue empties the other graph") {
+		g.merge(std::move(other));
+		CHECK(g == expected);
+		CHECK(g.num_edges() == 7);
+		CHECK(g.hash() == expected.hash());
+		CHECK(other.empty());
+		CHECK(other.num_edges() == 0);
+	}
+
+	SECTION("Check the merged graph no longer depends on the other graph") {
+		g.merge(std::move(other));
+		other = gdwg::graph<std::string, int>{"z"};
+		REQUIRE(g.replace_node("c", "x"));
+		CHECK(g.is_connected("b", "x"));
+		CHECK(g.is_connected("x", "a"));
+		CHECK(g.erase_node("a"));
+		CHECK(g.num_edges() == 3);
+	}
+
+	SECTION("Check merging a graph into itself changes nothing") {
+		auto const before = g;
+		g.merge(g);
+		CHECK(g == before);
+		CHECK(g.hash() == before.hash());
+	}
+
+	SECTION("Check merging an empty graph changes nothing") {
+		auto const before = g;
+		g.merge(gdwg::graph<std::string, int>{});
+		CHECK(g == before);
+		auto empty = gdwg::graph<std::string, int>{};
+		empty.merge(g);
+		CHECK(empty == g);
+	}
+}
+
+TEST_CASE("Test graph_union() of lvalues and rvalues") {
+	auto rng = std::mt19937(6771);
+	auto const weight = std::uniform_int_distribution<int>(0, 3);
+	for (auto round = 0; round < 20; ++round) {
+		// b shares only the even nodes of a
+		auto const a = random_graph(rng, 12, 30, weight);
+		auto const b = random_graph(rng, 12, 30, weight, 2);
+		auto const expected = union_by_insertion(a, b);
+
+		auto const copies = gdwg::graph_union(a, b);
+		CHECK(copies == expected);
+		CHECK(copies.hash() == expected.hash());
+
+		auto left = gdwg::graph_union(gdwg::graph<int, int>(a), b);
+		CHECK(left == expected);
+		auto right = gdwg::graph_union(a, gdwg::graph<int, int>(b));
+		CHECK(right == expected);
+		auto both = gdwg::graph_union(gdwg::graph<int, int>(a), gdwg::graph<int, int>(b));
+		CHECK(both == expected);
+		CHECK(both.num_edges() == expected.num_edges());
+		CHECK(both.hash() == expected.hash());
+	}
+}
@@ -0,0 +1,200 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+#include "gdwg/traversal.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Snapshot Reordering and Traversals
+
+namespace helper {
+	// A graph whose N order says nothing about its structure
+	auto scattered_graph(std::mt19937& rng, int nodes, int edges) -> gdwg::graph<int, int> {
+		auto labels = std::vector<int>(static_cast<std::size_t>(nodes));
+		std::iota(labels.begin(), labels.end(), 0);
+		std::shuffle(labels.begin(), labels.end(), rng);
+		auto g = gdwg::graph<int, int>(labels.begin(), labels.end());
+		auto pick = std::uniform_int_distribution<std::size_t>(0, labels.size() - 1);
+		auto weight = std::uniform_int_distribution<int>(0, 3);
+		for (auto i = 0; i < edges; ++i) {
+			// Mostly short edges along the shuffled labels, with some long ones
+			auto const u = pick(rng);
+			auto const v = i % 5 == 0 ? pick(rng) : std::min(u + 1 + pick(rng) % 3, labels.size() - 1);
+			g.insert_edge(labels[u], labels[v], weight(rng));
+		}
+		return g;
+	}
+
+	// Every edge of a snapshot, translated back to node values
+	template<typename N, typename E>
+	auto edges_of(gdwg::snapshot<N, E> const& s) -> std::vector<typename gdwg::graph<N, E>::value_type> {
+		auto result = std::vector<typename gdwg::graph<N, E>::value_type>();
+		for (auto u = std::uint32_t{0}; u < s.num_nodes(); ++u) {
+			auto const targets = s.neighbours(u);
+			auto const weights = s.weights(u);
+			for (auto i = std::size_t{0}; i < targets.size(); ++i) {
+				result.push_back({s.node(u), s.node(targets[i]), weights[i]});
+			}
+		}
+		return result;
+	}
+
+	auto bandwidth(gdwg::snapshot<int, int> const& s) -> std::uint32_t {
+		auto result = std::uint32_t{0};
+		for (auto u = std::uint32_t{0}; u < s.num_nodes(); ++u) {
+			for (auto const v : s.neighbours(u)) {
+				result = std::max(result, u < v ? v - u : u - v);
+			}
+		}
+		return result;
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test snapshot orderings keep the graph and its mapping to N") {
+	auto rng = std::mt19937(6771);
+	auto const g = scattered_graph(rng, 300, 900);
+	auto const natural = gdwg::snapshot(g);
+	CHECK(natural.order() == gdwg::ordering::natural);
+
+	for (auto const order : {gdwg::ordering::degree, gdwg::ordering::rcm, gdwg::ordering::gorder}) {
+		auto const s = gdwg::snapshot(g, order);
+		CHECK(s.order() == order);
+		REQUIRE(s.num_nodes() == g.num_nodes());
+		REQUIRE(s.num_edges() == g.num_edges());
+
+		SECTION("Check the permutations are inverse to each other") {
+			auto const nodes = g.nodes();
+			for (auto i = std::size_t{0}; i < nodes.size(); ++i) {
+				auto const id = s.permutation()[i];
+				CHECK(s.inverse_permutation()[id] == i);
+				CHECK(s.node(id) == nodes[i]);
+				CHECK(s.id(nodes[i]) == id);
+			}
+			CHECK_FALSE(s.id(-1).has_value());
+		}
+
+		SECTION("Check every edge is kept, with sorted neighbour lists") {
+			auto edges = edges_of(s);
+			auto const by_value = [](auto const& a, auto const& b) {
+				return std::tie(a.from, a.to, a.weight) < std::tie(b.from, b.to, b.weight);
+			};
+			std::sort(edges.begin(), edges.end(), by_value);
+			auto const expected = std::vector<gdwg::graph<int, int>::value_type>(g.begin(), g.end());
+			REQUIRE(edges.size() == expected.size());
+			CHECK(std::equal(edges.begin(), edges.end(), expected.begin(), [](auto const& a, auto const& b) {
+				return a.from == b.from and a.to == b.to and a.weight == b.weight;
+			}));
+			for (auto u = std::uint32_t{0}; u < s.num_nodes(); ++u) {
+				CHECK(std::is_sorted(s.neighbours(u).begin(), s.neighbours(u).end()));
+			}
+		}
+
+		SECTION("Check traversals agree with the natural order") {
+			auto const source = *g.nodes().begin();
+			auto const expected = gdwg::bfs_distances(natural, *natural.id(source));
+			auto const distances = gdwg::bfs_distances(s, *s.id(source));
+			auto const expected_rank = gdwg::pagerank(natural);
+			auto const rank = gdwg::pagerank(s, 20, 0.85, 3);
+			for (auto id = std::uint32_t{0}; id < s.num_nodes(); ++id) {
+				auto const i = s.inverse_permutation()[id];
+				CHECK(distances[id] == expected[i]);
+				CHECK(rank[id] == Approx(expected_rank[i]));
+			}
+		}
+	}
+}
+
+TEST_CASE("Test specific snapshot orderings") {
+	auto rng = std::mt19937(6771);
+
+	SECTION("Check degree ordering puts hubs first") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		g.insert_edge("a", "d", 1);
+		g.insert_edge("b", "d", 1);
+		g.insert_edge("c", "d", 1);
+		g.insert_edge("c", "b", 1);
+		auto const s = gdwg::snapshot(g, gdwg::ordering::degree);
+		CHECK(s.node(0) == "d");
+		CHECK(s.node(1) == "b");
+		CHECK(s.node(2) == "c");
+		CHECK(s.node(3) == "a");
+		CHECK(s.neighbours(2).size() == 2);
+		CHECK(s.neighbours(2)[0] == 0);
+		CHECK(s.neighbours(2)[1] == 1);
+	}
+
+	SECTION("Check reverse Cuthill-McKee narrows a shuffled path") {
+		auto labels = std::vector<int>(200);
+		std::iota(labels.begin(), labels.end(), 0);
+		std::shuffle(labels.begin(), labels.end(), rng);
+		auto g = gdwg::graph<int, int>(labels.begin(), labels.end());
+		for (auto i = std::size_t{1}; i < labels.size(); ++i) {
+			g.insert_edge(labels[i - 1], labels[i], 0);
+		}
+		CHECK(bandwidth(gdwg::snapshot(g)) > 10);
+		CHECK(bandwidth(gdwg::snapshot(g, gdwg::ordering::rcm)) == 1);
+	}
+
+	SECTION("Check orderings of empty and edgeless graphs") {
+		for (auto const order : {gdwg::ordering::degree, gdwg::ordering::rcm, gdwg::ordering::gorder}) {
+			CHECK(gdwg::snapshot(gdwg::graph<int, int>{}, order).num_nodes() == 0);
+			auto const s = gdwg::snapshot(gdwg::graph<int, int>{3, 1, 2}, order);
+			CHECK(s.num_nodes() == 3);
+			CHECK(s.id(2).has_value());
+		}
+	}
+
+	SECTION("Check transpose keeps the ordering") {
+		auto const g = scattered_graph(rng, 50, 120);
+		auto const s = gdwg::snapshot(g, gdwg::ordering::gorder);
+		auto const t = gdwg::transpose(s);
+		CHECK(t.order() == gdwg::ordering::gorder);
+		CHECK(std::equal(t.permutation().begin(), t.permutation().end(), s.permutation().begin()));
+		CHECK(t.id(g.nodes().front()) == s.id(g.nodes().front()));
+	}
+}
+
+TEST_CASE("Test bfs_distances() and pagerank()") {
+	auto g = gdwg::graph<char, int>{'A', 'B', 'C', 'D', 'E'};
+	g.insert_edge('A', 'B', 1);
+	g.insert_edge('B', 'C', 1);
+	g.insert_edge('A', 'C', 1);
+	g.insert_edge('C', 'D', 1);
+	auto const s = gdwg::snapshot(g);
+
+	SECTION("Check hop distances") {
+		CHECK(gdwg::bfs_distances(s, 0) == std::vector<std::uint32_t>{0, 1, 1, 2, gdwg::unreachable});
+		CHECK(gdwg::bfs_distances(s, 3)[0] == gdwg::unreachable);
+	}
+
+	SECTION("Check exception is thrown for a source outside the snapshot") {
+		REQUIRE_THROWS_MATCHES(gdwg::bfs_distances(s, 5),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::bfs_distances on a source that "
+		                                      "doesn't exist in the snapshot"));
+	}
+
+	SECTION("Check ranks sum to one and follow the links") {
+		auto const rank = gdwg::pagerank(s, 50);
+		auto total = 0.0;
+		for (auto const r : rank) {
+			total += r;
+		}
+		CHECK(total == Approx(1.0));
+		CHECK(rank[3] > rank[2]);
+		CHECK(rank[2] > rank[1]);
+		CHECK(rank[0] == Approx(rank[4]));
+		CHECK(gdwg::pagerank(gdwg::snapshot(gdwg::graph<int, int>{})).empty());
+	}
+}
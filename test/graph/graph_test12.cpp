@@ -0,0 +1,191 @@
+#include "gdwg/compressed_graph.hpp"
+#include "gdwg/detail/varint.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+#include "random_graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Compressed Graphs
+
+namespace helper {
+	// Node values are spread out, so ids and values differ. Weights are multiples of 7.
+	auto spread_graph(std::mt19937& rng, int nodes, int edges, int weights) -> gdwg::graph<int, int> {
+		auto weight = std::uniform_int_distribution<int>(0, weights - 1);
+		auto const spread = [&](std::mt19937& r) { return weight(r) * 7; };
+		return random_graph(rng, nodes, edges, spread, 1000);
+	}
+
+	// Every edge of a compressed graph must match the snapshot it was built from
+	template<typename N, typename E>
+	auto check_matches(gdwg::compressed_graph<N, E> const& c, gdwg::snapshot<N, E> const& s) -> void {
+		REQUIRE(c.num_nodes() == s.num_nodes());
+		REQUIRE(c.num_edges() == s.num_edges());
+		for (auto u = std::uint32_t{0}; u < s.num_nodes(); ++u) {
+			CHECK(c.node(u) == s.node(u));
+			CHECK(c.out_degree(u) == s.out_degree(u));
+			auto const targets = s.neighbours(u);
+			auto const weights = s.weights(u);
+			CHECK(c.neighbours(u) == std::vector<std::uint32_t>(targets.begin(), targets.end()));
+			CHECK(c.weights(u) == std::vector<E>(weights.begin(), weights.end()));
+		}
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test group varint kernels agree with each other") {
+	namespace simd = gdwg::detail::simd;
+	namespace varint = gdwg::detail::varint;
+	auto rng = std::mt19937(6771);
+	auto gap = std::uniform_int_distribution<std::uint32_t>(0, 3);
+	auto scale = std::uniform_int_distribution<int>(0, 24);
+
+	for (auto n = std::size_t{0}; n < 70; n += 3) {
+		// Gaps of every byte length, including repeated values
+		auto values = std::vector<std::uint32_t>(n);
+		auto value = std::uint32_t{5};
+		for (auto& v : values) {
+			value += gap(rng) << static_cast<unsigned>(scale(rng));
+			v = value;
+		}
+		auto bytes = std::vector<std::uint8_t>();
+		varint::encode(values.data(), n, 5, bytes);
+		auto const length = bytes.size();
+		bytes.resize(length + varint::padding);
+
+		for (auto const level : {simd::isa::scalar, simd::isa::avx2}) {
+			if (not simd::is_supported(level)) {
+				continue;
+			}
+			auto decoded = std::vector<std::uint32_t>(n + 4);
+			auto const* end = varint::decode(bytes.data(), n, 5, decoded.data(), level);
+			CHECK(end == bytes.data() + length);
+			decoded.resize(n);
+			CHECK(decoded == values);
+		}
+	}
+}
+
+TEST_CASE("Test compressed_graph keeps every edge") {
+	auto rng = std::mt19937(6771);
+
+	SECTION("Check a random graph with few distinct weights") {
+		auto const g = spread_graph(rng, 100, 3000, 5);
+		auto const s = gdwg::snapshot(g);
+		auto const c = gdwg::compressed_graph(g);
+		CHECK(c.weights_encoding() == gdwg::weight_encoding::dictionary);
+		check_matches(c, s);
+	}
+
+	SECTION("Check a random graph with many distinct weights") {
+		auto const g = spread_graph(rng, 300, 3000, 1000);
+		auto const c = gdwg::compressed_graph(g);
+		CHECK(c.weights_encoding() == gdwg::weight_encoding::plain);
+		check_matches(c, gdwg::snapshot(g));
+	}
+
+	SECTION("Check a reordered snapshot") {
+		auto const g = spread_graph(rng, 200, 2000, 3);
+		auto const s = gdwg::snapshot(g, gdwg::ordering::rcm);
+		auto const c = gdwg::compressed_graph(s, gdwg::weight_encoding::plain);
+		check_matches(c, s);
+		for (auto const& value : g.nodes()) {
+			CHECK(c.id(value) == s.id(value));
+		}
+		CHECK_FALSE(c.id(1).has_value());
+	}
+
+	SECTION("Check streaming visits edges in order") {
+		auto g = gdwg::graph<std::string, double>{"a", "b", "c"};
+		g.insert_edge("a", "c", 1.5);
+		g.insert_edge("a", "b", 2.5);
+		g.insert_edge("a", "b", 0.5);
+		auto const c = gdwg::compressed_graph(g);
+		auto visited = std::vector<std::pair<std::string, double>>();
+		c.for_each_edge(*c.id("a"), [&](std::uint32_t to, double weight) {
+			visited.emplace_back(c.node(to), weight);
+		});
+		CHECK(visited
+		      == std::vector<std::pair<std::string, double>>{{"b", 0.5}, {"b", 2.5}, {"c", 1.5}});
+		CHECK(c.neighbours(*c.id("c")).empty());
+	}
+
+	SECTION("Check an empty graph") {
+		auto const c = gdwg::compressed_graph(gdwg::graph<int, int>{});
+		CHECK(c.num_nodes() == 0);
+		CHECK(c.num_edges() == 0);
+		CHECK(c.bytes_per_edge() == 0.0);
+	}
+}
+
+TEST_CASE("Test compressed_graph::is_connected() agrees with the graph") {
+	auto rng = std::mt19937(6771);
+	// A dense node has lists of several blocks, so lookups go through the skip table
+	auto const g = spread_graph(rng, 30, 4000, 8);
+	auto const c = gdwg::compressed_graph(g);
+	REQUIRE(c.out_degree(0) > 64);
+	auto const nodes = g.nodes();
+	for (auto const& src : nodes) {
+		for (auto const& dst : nodes) {
+			CHECK(c.is_connected(src, dst) == g.is_connected(src, dst));
+		}
+	}
+
+	SECTION("Check exception is thrown if a node does not exist") {
+		REQUIRE_THROWS_MATCHES(c.is_connected(0, 1),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::compressed_graph<N, E>::is_connected if "
+		                                      "src or dst node don't exist in the graph"));
+	}
+}
+
+TEST_CASE("Test compressed_graph weight encodings and size") {
+	auto rng = std::mt19937(6771);
+	auto const g = spread_graph(rng, 1000, 20000, 4);
+
+	SECTION("Check a forced dictionary and a forced plain encoding") {
+		auto const plain = gdwg::compressed_graph(g, gdwg::weight_encoding::plain);
+		auto const dictionary = gdwg::compressed_graph(g, gdwg::weight_encoding::dictionary);
+		CHECK(plain.weights_encoding() == gdwg::weight_encoding::plain);
+		CHECK(dictionary.weights_encoding() == gdwg::weight_encoding::dictionary);
+		CHECK(dictionary.bytes_used() < plain.bytes_used());
+	}
+
+	SECTION("Check plain storage is chosen when a dictionary wouldn't be smaller") {
+		// 10 codes and 10 dictionary entries take 50 bytes, against 40 bytes plain
+		auto few = gdwg::graph<int, int>();
+		for (auto i = 0; i < 11; ++i) {
+			few.insert_node(i);
+		}
+		for (auto i = 0; i < 10; ++i) {
+			few.insert_edge(i, i + 1, i * 100);
+		}
+		auto const c = gdwg::compressed_graph(few);
+		CHECK(c.weights_encoding() == gdwg::weight_encoding::plain);
+		auto const dictionary = gdwg::compressed_graph(few, gdwg::weight_encoding::dictionary);
+		CHECK(c.bytes_used() < dictionary.bytes_used());
+		check_matches(c, gdwg::snapshot(few));
+	}
+
+	SECTION("Check compression beats a snapshot's target and weight arrays") {
+		auto const c = gdwg::compressed_graph(g);
+		CHECK(c.bytes_per_edge() < 4.0);
+		CHECK(c.bytes_per_edge() > 1.0);
+	}
+
+	SECTION("Check exception is thrown if a dictionary cannot hold every weight") {
+		auto const many = spread_graph(rng, 100, 2000, 1000);
+		REQUIRE_THROWS_MATCHES(gdwg::compressed_graph(many, gdwg::weight_encoding::dictionary),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot build gdwg::compressed_graph<N, E> with a weight "
+		                                      "dictionary for more than 256 distinct weights"));
+	}
+}
@@ -0,0 +1,149 @@
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Bulk Insertion and Generators
+
+TEST_CASE("Test insert_nodes() inserts every new value once") {
+	auto g = gdwg::graph<std::string, int>{"b", "d"};
+
+	SECTION("Check unsorted values with repeats") {
+		CHECK(g.insert_nodes(std::vector<std::string>{"e", "a", "d", "c", "a"}) == 3);
+		CHECK(g.nodes() == std::vector<std::string>{"a", "b", "c", "d", "e"});
+		CHECK(g == gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"});
+		CHECK(g.hash() == gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"}.hash());
+	}
+
+	SECTION("Check existing values and empty ranges insert nothing") {
+		CHECK(g.insert_nodes(std::vector<std::string>{"d", "b"}) == 0);
+		CHECK(g.insert_nodes(std::vector<std::string>{}) == 0);
+		CHECK(g.num_nodes() == 2);
+	}
+}
+
+TEST_CASE("Test insert_edges() matches inserting edges one at a time") {
+	auto rng = std::mt19937(6771);
+	auto pick = std::uniform_int_distribution<int>(0, 29);
+	auto weight = std::uniform_int_distribution<int>(0, 3);
+
+	for (auto const threads : {std::size_t{1}, std::size_t{4}}) {
+		auto g = gdwg::graph<int, int>();
+		auto expected = gdwg::graph<int, int>();
+		for (auto i = 0; i < 30; ++i) {
+			g.insert_node(i);
+			expected.insert_node(i);
+		}
+		// Existing edges must be kept and not counted again
+		for (auto i = 0; i < 50; ++i) {
+			auto const [from, to, w] = std::tuple(pick(rng), pick(rng), weight(rng));
+			g.insert_edge(from, to, w);
+			expected.insert_edge(from, to, w);
+		}
+
+		auto edges = std::vector<gdwg::graph<int, int>::value_type>();
+		auto inserted = std::size_t{0};
+		for (auto i = 0; i < 400; ++i) {
+			auto const [from, to, w] = std::tuple(pick(rng), pick(rng), weight(rng));
+			edges.push_back({from, to, w});
+			if (expected.insert_edge(from, to, w)) {
+				++inserted;
+			}
+		}
+		CHECK(g.insert_edges(edges, threads) == inserted);
+		CHECK(g == expected);
+		CHECK(g.num_edges() == expected.num_edges());
+		CHECK(g.hash() == expected.hash());
+		CHECK(g.insert_edges(std::move(edges), threads) == 0);
+	}
+
+	SECTION("Check exception is thrown, and nothing inserted, if a node does not exist") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		auto const edges = std::vector<gdwg::graph<int, int>::value_type>{{1, 2, 0}, {2, 3, 0}};
+		REQUIRE_THROWS_MATCHES(g.insert_edges(edges),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::graph<N, E>::insert_edges when either "
+		                                      "src or dst node does not exist"));
+		CHECK(g.num_edges() == 0);
+		CHECK_FALSE(g.is_connected(1, 2));
+	}
+}
+
+TEST_CASE("Test generators are deterministic and thread-independent") {
+	SECTION("Check rmat") {
+		auto const g = gdwg::generate::rmat(8, 4, 12, 1);
+		auto const h = gdwg::generate::rmat(8, 4, 12, 4);
+		CHECK(g == h);
+		CHECK(g.hash() == h.hash());
+		CHECK(g.num_nodes() == 256);
+		CHECK(g.num_edges() <= 1024);
+		CHECK(g.num_edges() > 900);
+		CHECK_FALSE(g == gdwg::generate::rmat(8, 4, 13));
+	}
+
+	SECTION("Check erdos_renyi") {
+		auto const g = gdwg::generate::erdos_renyi<int, double>(500, 0.02, 1, 1);
+		CHECK(g == gdwg::generate::erdos_renyi<int, double>(500, 0.02, 1, 3));
+		// 4990 edges are expected, with a standard deviation of about 70
+		CHECK(g.num_edges() > 4500);
+		CHECK(g.num_edges() < 5500);
+		for (auto const& [from, to, weight] : g) {
+			CHECK(from != to);
+			CHECK(weight >= 0.0);
+			CHECK(weight < 1.0);
+		}
+	}
+
+	SECTION("Check barabasi_albert") {
+		auto const g = gdwg::generate::barabasi_albert(2000, 3, 5, 1);
+		CHECK(g == gdwg::generate::barabasi_albert(2000, 3, 5, 0));
+		CHECK(g.num_nodes() == 2000);
+		CHECK(g.num_edges() > 5800);
+		CHECK(g.num_edges() <= 1999 * 3);
+		auto in_degree = std::vector<int>(2000, 0);
+		for (auto const& [from, to, weight] : g) {
+			CHECK(to < from);
+			CHECK(weight >= 1);
+			CHECK(weight <= 100);
+			++in_degree[static_cast<std::size_t>(to)];
+		}
+		// Early nodes become hubs
+		CHECK(in_degree[0] + in_degree[1] + in_degree[2] > 100);
+	}
+}
+
+TEST_CASE("Test generators of exact shapes") {
+	SECTION("Check grid2d") {
+		auto const g = gdwg::generate::grid2d(3, 2);
+		CHECK(g.num_nodes() == 6);
+		CHECK(g.num_edges() == 14);
+		CHECK(g.connections(4) == std::vector<int>{1, 3, 5});
+		CHECK(g.weights(0, 1) == g.weights(1, 0));
+		CHECK(gdwg::generate::grid2d(0, 5).empty());
+	}
+
+	SECTION("Check erdos_renyi at the extremes") {
+		CHECK(gdwg::generate::erdos_renyi(20, 0.0).num_edges() == 0);
+		CHECK(gdwg::generate::erdos_renyi(20, 1.0).num_edges() == 20 * 19);
+		CHECK(gdwg::generate::erdos_renyi(1, 1.0).num_edges() == 0);
+		CHECK(gdwg::generate::erdos_renyi(0, 0.5).empty());
+	}
+
+	SECTION("Check exceptions for invalid arguments") {
+		REQUIRE_THROWS_MATCHES(gdwg::generate::erdos_renyi(10, 1.5),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::generate::erdos_renyi with a "
+		                                      "probability outside [0, 1]"));
+		REQUIRE_THROWS_MATCHES((gdwg::generate::rmat<std::int8_t, int>(8, 1)),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::generate::rmat with more nodes than N "
+		                                      "can represent"));
+	}
+}
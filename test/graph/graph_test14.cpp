@@ -0,0 +1,200 @@
+#include "gdwg/graph.hpp"
+#include "edge_tuples.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Weight-Ordered Queries
+
+namespace helper {
+	using edge = std::tuple<std::string, std::string, int>;
+
+	// Every query on an indexed graph must give what a scan of its edge sets gives
+	template<typename N, typename E>
+	auto check_index_matches_scan(gdwg::graph<N, E> const& indexed) -> void {
+		REQUIRE(indexed.has_weight_index());
+		auto scanned = indexed;
+		scanned.disable_weight_index();
+		for (auto const& node : indexed.nodes()) {
+			for (auto const k : {std::size_t{0}, std::size_t{1}, std::size_t{3}, std::size_t{1000}}) {
+				for (auto const order : {gdwg::weight_order::ascending, gdwg::weight_order::descending}) {
+					CHECK(as_tuples(indexed.top_k_out(node, k, order))
+					      == as_tuples(scanned.top_k_out(node, k, order)));
+				}
+			}
+			for (auto const& [lo, hi] : {std::pair(0, 3), std::pair(1, 2), std::pair(2, 2)}) {
+				CHECK(as_tuples(indexed.out_edges_in_weight_range(node, E(lo), E(hi)))
+				      == as_tuples(scanned.out_edges_in_weight_range(node, E(lo), E(hi))));
+			}
+		}
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test top_k_out() returns the lightest or heaviest outgoing edges") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 5);
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("a", "c", 9);
+	g.insert_edge("a", "d", 5);
+	g.insert_edge("a", "a", 3);
+	g.insert_edge("b", "a", 2);
+
+	for (auto const indexed : {false, true}) {
+		if (indexed) {
+			g.enable_weight_index();
+		}
+		CHECK(g.has_weight_index() == indexed);
+
+		SECTION("Check heaviest edges, with ties in reverse dst order") {
+			CHECK(as_tuples(g.top_k_out("a", 3))
+			      == std::vector<edge>{{"a", "c", 9}, {"a", "d", 5}, {"a", "b", 5}});
+		}
+
+		SECTION("Check lightest edges") {
+			CHECK(as_tuples(g.top_k_out("a", 2, gdwg::weight_order::ascending))
+			      == std::vector<edge>{{"a", "b", 1}, {"a", "a", 3}});
+		}
+
+		SECTION("Check k beyond the out-degree, k of zero, and nodes without edges") {
+			CHECK(g.top_k_out("a", 10).size() == 5);
+			CHECK(g.top_k_out("a", 0).empty());
+			CHECK(g.top_k_out("c", 2).empty());
+		}
+	}
+
+	SECTION("Check exception is thrown if src does not exist") {
+		auto const& cg = g;
+		REQUIRE_THROWS_MATCHES(cg.top_k_out("e", 1),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::graph<N, E>::top_k_out if src doesn't "
+		                                      "exist in the graph"));
+	}
+}
+
+TEST_CASE("Test out_edges_in_weight_range() returns edges with weights in a closed range") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("a", "b", 4);
+	g.insert_edge("a", "c", 2);
+	g.insert_edge("a", "c", 4);
+	g.insert_edge("a", "a", 7);
+
+	for (auto const indexed : {false, true}) {
+		if (indexed) {
+			g.enable_weight_index();
+		}
+
+		SECTION("Check both bounds are included, in (weight, dst) order") {
+			CHECK(as_tuples(g.out_edges_in_weight_range("a", 2, 4))
+			      == std::vector<edge>{{"a", "c", 2}, {"a", "b", 4}, {"a", "c", 4}});
+		}
+
+		SECTION("Check empty ranges") {
+			CHECK(g.out_edges_in_weight_range("a", 5, 6).empty());
+			CHECK(g.out_edges_in_weight_range("a", 4, 2).empty());
+			CHECK(g.out_edges_in_weight_range("b", 0, 10).empty());
+		}
+	}
+
+	SECTION("Check exception is thrown if src does not exist") {
+		auto const& cg = g;
+		REQUIRE_THROWS_MATCHES(cg.out_edges_in_weight_range("d", 0, 1),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::graph<N, E>::out_edges_in_weight_range "
+		                                      "if src doesn't exist in the graph"));
+	}
+}
+
+TEST_CASE("Test the weight index is kept up to date by every modifier") {
+	auto rng = std::mt19937(6771);
+	auto pick = std::uniform_int_distribution<int>(0, 11);
+	auto weight = std::uniform_int_distribution<int>(0, 3);
+	auto g = gdwg::graph<int, int>();
+	g.enable_weight_index();
+	for (auto i = 0; i < 10; ++i) {
+		g.insert_node(i);
+	}
+	auto const random_edges = [&](int count) {
+		auto edges = std::vector<gdwg::graph<int, int>::value_type>();
+		for (auto i = 0; i < count; ++i) {
+			edges.push_back({pick(rng) % 10, pick(rng) % 10, weight(rng)});
+		}
+		return edges;
+	};
+	for (auto const& [from, to, w] : random_edges(60)) {
+		g.insert_edge(from, to, w);
+	}
+	check_index_matches_scan(g);
+
+	SECTION("Check erase_edge()") {
+		auto const [from, to, w] = *g.begin();
+		REQUIRE(g.erase_edge(from, to, w));
+		g.erase_edge(g.begin());
+		check_index_matches_scan(g);
+		g.erase_edge(g.find(5, 5, 0) == g.end() ? g.begin() : g.find(5, 5, 0), g.end());
+		check_index_matches_scan(g);
+	}
+
+	SECTION("Check erase_node(), replace_node() and merge_replace_node()") {
+		g.erase_node(3);
+		g.replace_node(4, 11);
+		g.replace_node(5, 0);
+		g.merge_replace_node(6, 7);
+		check_index_matches_scan(g);
+	}
+
+	SECTION("Check insert_edges() and insert_nodes()") {
+		g.insert_nodes(std::vector<int>{10, 11});
+		g.insert_edges(random_edges(200), 4);
+		check_index_matches_scan(g);
+		g.insert_edge(10, 11, 1);
+		check_index_matches_scan(g);
+	}
+
+	SECTION("Check merge()") {
+		auto other = gdwg::graph<int, int>{0, 1, 20, 21};
+		other.insert_edge(0, 20, 9);
+		other.insert_edge(20, 21, 8);
+		other.insert_edge(21, 1, 7);
+		auto moved = g;
+		g.merge(other);
+		check_index_matches_scan(g);
+		moved.merge(std::move(other));
+		check_index_matches_scan(moved);
+		CHECK(moved == g);
+	}
+
+	SECTION("Check clear()") {
+		g.clear();
+		CHECK(g.has_weight_index());
+		g.insert_node(1);
+		g.insert_edge(1, 1, 1);
+		CHECK(g.top_k_out(1, 5).size() == 1);
+	}
+
+	SECTION("Check the index is kept by copies and whole-graph operations") {
+		auto const copy = g;
+		check_index_matches_scan(copy);
+		check_index_matches_scan(g.filter([](int, int, int w) { return w != 2; }, 2));
+		check_index_matches_scan(g.induced_subgraph(std::vector<int>{0, 2, 4, 6, 8}));
+		check_index_matches_scan(gdwg::transpose(g, 2));
+		CHECK_FALSE(gdwg::transpose(gdwg::graph<int, int>{1}).has_weight_index());
+	}
+
+	SECTION("Check the index can be disabled and enabled again") {
+		g.disable_weight_index();
+		CHECK_FALSE(g.has_weight_index());
+		g.insert_edge(1, 2, 3);
+		g.enable_weight_index(4);
+		check_index_matches_scan(g);
+	}
+}
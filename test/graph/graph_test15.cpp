@@ -0,0 +1,293 @@
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_path.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Point-to-Point Shortest Paths
+
+namespace helper {
+	// Plain single-source Dijkstra, to compare the point-to-point searches against
+	auto all_distances(gdwg::snapshot<int, int> const& s, std::uint32_t src)
+	   -> std::vector<std::optional<int>> {
+		auto distance = std::vector<std::optional<int>>(s.num_nodes());
+		auto queue = std::priority_queue<std::pair<int, std::uint32_t>,
+		                                 std::vector<std::pair<int, std::uint32_t>>,
+		                                 std::greater<>>();
+		distance[src] = 0;
+		queue.emplace(0, src);
+		while (not queue.empty()) {
+			auto const [d, u] = queue.top();
+			queue.pop();
+			if (d > *distance[u]) {
+				continue;
+			}
+			auto const targets = s.neighbours(u);
+			auto const weights = s.weights(u);
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				auto const v = targets[k];
+				if (not distance[v] or d + weights[k] < *distance[v]) {
+					distance[v] = d + weights[k];
+					queue.emplace(d + weights[k], v);
+				}
+			}
+		}
+		return distance;
+	}
+
+	// A path is valid if it starts and ends at the right nodes and its edges add up to its
+	// distance, taking the lightest of any parallel edges
+	auto path_length(gdwg::snapshot<int, int> const& s, std::vector<std::uint32_t> const& nodes)
+	   -> std::optional<int> {
+		auto total = 0;
+		for (auto i = std::size_t{1}; i < nodes.size(); ++i) {
+			auto const targets = s.neighbours(nodes[i - 1]);
+			auto const weights = s.weights(nodes[i - 1]);
+			auto lightest = std::optional<int>();
+			for (auto k = std::size_t{0}; k < targets.size(); ++k) {
+				if (targets[k] == nodes[i] and (not lightest or weights[k] < *lightest)) {
+					lightest = weights[k];
+				}
+			}
+			if (not lightest) {
+				return std::nullopt;
+			}
+			total += *lightest;
+		}
+		return total;
+	}
+
+	constexpr auto width = 30;
+
+	auto manhattan(std::uint32_t dst) {
+		return [dst](std::uint32_t v) {
+			auto const [vx, vy] = std::pair(static_cast<int>(v) % width, static_cast<int>(v) / width);
+			auto const [dx, dy] = std::pair(static_cast<int>(dst) % width, static_cast<int>(dst) / width);
+			return std::abs(vx - dx) + std::abs(vy - dy); // Every weight is at least 1
+		};
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test astar() and bidirectional_dijkstra() find shortest paths") {
+	// Node ids of a natural snapshot are the node values, so y * width + x
+	auto g = gdwg::generate::grid2d(width, 20, 3);
+	g.insert_edge(0, 1, 1); // A parallel edge
+	auto const s = gdwg::snapshot(g);
+	auto const reversed = gdwg::transpose(s);
+	auto context = gdwg::search_context<int>();
+	auto rng = std::mt19937(6771);
+	auto pick = std::uniform_int_distribution<std::uint32_t>(0, 599);
+
+	for (auto query = 0; query < 40; ++query) {
+		auto const src = query == 0 ? 0 : pick(rng);
+		auto const dst = query == 0 ? 1 : pick(rng);
+		auto const expected = all_distances(s, src)[dst];
+		REQUIRE(expected);
+
+		auto const guided = gdwg::astar(s, src, dst, manhattan(dst), context);
+		REQUIRE(guided);
+		CHECK(guided->distance == *expected);
+		CHECK(guided->nodes.front() == src);
+		CHECK(guided->nodes.back() == dst);
+		CHECK(path_length(s, guided->nodes) == expected);
+		auto const guided_settled = context.settled();
+
+		auto const unguided = gdwg::astar(s, src, dst, [](std::uint32_t) { return 0; }, context);
+		REQUIRE(unguided);
+		CHECK(unguided->distance == *expected);
+		CHECK(guided_settled <= context.settled());
+
+		auto const both_ways = gdwg::bidirectional_dijkstra(s, reversed, src, dst, context);
+		REQUIRE(both_ways);
+		CHECK(both_ways->distance == *expected);
+		CHECK(both_ways->nodes.front() == src);
+		CHECK(both_ways->nodes.back() == dst);
+		CHECK(path_length(s, both_ways->nodes) == expected);
+	}
+	CHECK(context.capacity() == s.num_nodes());
+
+	SECTION("Check a src equal to dst") {
+		auto const path = gdwg::bidirectional_dijkstra(s, reversed, 42, 42);
+		REQUIRE(path);
+		CHECK(path->distance == 0);
+		CHECK(path->nodes == std::vector<std::uint32_t>{42});
+		CHECK(gdwg::astar(s, 42, 42, manhattan(42))->nodes == std::vector<std::uint32_t>{42});
+	}
+
+	SECTION("Check the heuristic reduces the nodes settled") {
+		// With unit weights the heuristic is exact along rows, so A* heads straight for dst
+		auto unit = g;
+		for (auto const& [from, to, weight] : g) {
+			unit.insert_edge(from, to, 1);
+		}
+		auto const us = gdwg::snapshot(unit);
+		auto const src = std::uint32_t{10 * width + 5};
+		auto const dst = std::uint32_t{10 * width + 15};
+		REQUIRE(gdwg::astar(us, src, dst, [](std::uint32_t) { return 0; }, context));
+		auto const unguided = context.settled();
+		REQUIRE(gdwg::astar(us, src, dst, manhattan(dst), context));
+		CHECK(context.settled() * 4 < unguided);
+	}
+}
+
+TEST_CASE("Test astar() and bidirectional_dijkstra() on a graph") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e"};
+	g.insert_edge("a", "b", 4);
+	g.insert_edge("a", "c", 1);
+	g.insert_edge("c", "b", 1);
+	g.insert_edge("b", "d", 5);
+	g.insert_edge("c", "d", 8);
+	auto const zero = [](std::string const&) { return 0; };
+
+	SECTION("Check the paths are node values") {
+		auto const expected = std::vector<std::string>{"a", "c", "b", "d"};
+		auto const guided = gdwg::astar(g, std::string("a"), std::string("d"), zero);
+		REQUIRE(guided);
+		CHECK(guided->distance == 7);
+		CHECK(guided->nodes == expected);
+		auto const both_ways = gdwg::bidirectional_dijkstra(g, std::string("a"), std::string("d"));
+		REQUIRE(both_ways);
+		CHECK(both_ways->distance == 7);
+		CHECK(both_ways->nodes == expected);
+	}
+
+	SECTION("Check unreachable nodes") {
+		CHECK_FALSE(gdwg::astar(g, std::string("a"), std::string("e"), zero));
+		CHECK_FALSE(gdwg::bidirectional_dijkstra(g, std::string("d"), std::string("a")));
+	}
+
+	SECTION("Check exception is thrown for nodes that don't exist") {
+		REQUIRE_THROWS_MATCHES(gdwg::astar(g, std::string("a"), std::string("f"), zero),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::astar if src or dst node don't exist "
+		                                      "in the graph"));
+		REQUIRE_THROWS_MATCHES(gdwg::bidirectional_dijkstra(g, std::string("f"), std::string("a")),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::bidirectional_dijkstra if src or dst "
+		                                      "node don't exist in the graph"));
+	}
+}
+
+TEST_CASE("Test shortest_path_query answers repeated queries on node values") {
+	auto g = gdwg::graph<int, int>();
+	for (auto i = 0; i < 100; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i + 1 < 100; ++i) {
+		g.insert_edge(i, i + 1, 1);
+	}
+	auto query = gdwg::shortest_path_query(g);
+	auto const zero = [](int) { return 0; };
+
+	SECTION("Check the searches match the graph overloads") {
+		for (auto i = 0; i < 3; ++i) {
+			CHECK(query.astar(10, 12, zero)->nodes == std::vector<int>{10, 11, 12});
+			CHECK(query.settled() < 10); // Only the part of the chain in between is explored
+			CHECK(query.bidirectional_dijkstra(10, 12)->nodes == std::vector<int>{10, 11, 12});
+			CHECK(query.bidirectional_dijkstra(0, 99)->distance
+			      == gdwg::bidirectional_dijkstra(g, 0, 99)->distance);
+			CHECK_FALSE(query.astar(12, 10, zero));
+		}
+		CHECK(query.snapshot().num_nodes() == 100);
+	}
+
+	SECTION("Check the query keeps the graph it was built from") {
+		g.insert_edge(0, 99, 5);
+		CHECK(query.astar(0, 99, zero)->distance == 99);
+		CHECK(gdwg::astar(g, 0, 99, zero)->distance == 5);
+	}
+
+	SECTION("Check exception is thrown for nodes that don't exist") {
+		REQUIRE_THROWS_MATCHES(query.bidirectional_dijkstra(0, 100),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::bidirectional_dijkstra if src or dst "
+		                                      "node don't exist in the graph"));
+	}
+}
+
+TEST_CASE("Test searches reuse their context") {
+	auto g = gdwg::graph<std::string, double>{"a", "b", "c", "d", "e"};
+	g.insert_edge("a", "b", 1.5);
+	g.insert_edge("b", "c", 1.0);
+	g.insert_edge("a", "c", 3.0);
+	g.insert_edge("d", "e", 0.5);
+	auto const s = gdwg::snapshot(g);
+	auto const reversed = gdwg::transpose(s);
+	auto const zero = [](std::uint32_t) { return 0.0; };
+
+	SECTION("Check unreachable nodes give no path, even after earlier searches reached them") {
+		auto context = gdwg::search_context<double>(s.num_nodes());
+		CHECK(context.capacity() == 5);
+		REQUIRE(gdwg::astar(s, 0, 2, zero, context));
+		CHECK(gdwg::astar(s, 0, 2, zero, context)->nodes == std::vector<std::uint32_t>{0, 1, 2});
+		CHECK_FALSE(gdwg::astar(s, 0, 4, zero, context));
+		CHECK_FALSE(gdwg::bidirectional_dijkstra(s, reversed, 2, 0, context));
+		CHECK(gdwg::bidirectional_dijkstra(s, reversed, 3, 4, context)->distance == 0.5);
+	}
+
+	SECTION("Check results are unaffected when the generation counter wraps") {
+		auto context = gdwg::search_context<double>();
+		for (auto i = 0; i < 3; ++i) {
+			context.forward().generation = std::numeric_limits<std::uint32_t>::max() - 1;
+			context.backward().generation = std::numeric_limits<std::uint32_t>::max() - 1;
+			CHECK(gdwg::bidirectional_dijkstra(s, reversed, 0, 2, context)->distance == 2.5);
+			CHECK(gdwg::bidirectional_dijkstra(s, reversed, 0, 2, context)->distance == 2.5);
+			CHECK_FALSE(gdwg::bidirectional_dijkstra(s, reversed, 0, 3, context));
+			CHECK(gdwg::astar(s, 0, 2, zero, context)->distance == 2.5);
+		}
+	}
+}
+
+TEST_CASE("Test exceptions for invalid searches") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	g.insert_edge(1, 2, -1);
+	g.insert_edge(2, 3, 1);
+	auto const s = gdwg::snapshot(g);
+	auto const reversed = gdwg::transpose(s);
+	auto const zero = [](std::uint32_t) { return 0; };
+
+	SECTION("Check ids that don't exist") {
+		REQUIRE_THROWS_MATCHES(gdwg::astar(s, 0, 3, zero),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::astar on a src or dst that doesn't "
+		                                      "exist in the snapshot"));
+		REQUIRE_THROWS_MATCHES(gdwg::bidirectional_dijkstra(s, reversed, 5, 0),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::bidirectional_dijkstra on a src or dst "
+		                                      "that doesn't exist in the snapshot"));
+	}
+
+	SECTION("Check negative weights") {
+		REQUIRE_THROWS_MATCHES(gdwg::astar(s, 0, 2, zero),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::astar on a snapshot with negative edge "
+		                                      "weights"));
+		REQUIRE_THROWS_MATCHES(gdwg::bidirectional_dijkstra(s, reversed, 0, 2),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::bidirectional_dijkstra on a snapshot "
+		                                      "with negative edge weights"));
+	}
+
+	SECTION("Check a reversed snapshot of another graph") {
+		REQUIRE_THROWS_MATCHES(gdwg::bidirectional_dijkstra(s, gdwg::snapshot<int, int>(), 0, 0),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::bidirectional_dijkstra with a reversed "
+		                                      "snapshot that is not the transpose of the snapshot"));
+	}
+}
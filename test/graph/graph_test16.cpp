@@ -0,0 +1,277 @@
+#include "gdwg/contraction_hierarchy.hpp"
+#include "gdwg/detail/serialize.hpp"
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/shortest_path.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Contraction Hierarchies
+
+namespace helper {
+	// Sum of the lightest edges along nodes, or std::nullopt if some edge is missing
+	template<typename N, typename E>
+	auto path_length(gdwg::graph<N, E> const& g, std::vector<N> const& nodes) -> std::optional<E> {
+		auto total = E{};
+		for (auto i = std::size_t{1}; i < nodes.size(); ++i) {
+			auto const weights = g.weights(nodes[i - 1], nodes[i]);
+			if (weights.empty()) {
+				return std::nullopt;
+			}
+			total += weights.front();
+		}
+		return total;
+	}
+
+	// A road-like graph: a grid with some one-way streets and a few long one-way links
+	auto road_graph(int width, int height) -> gdwg::graph<int, int> {
+		auto g = gdwg::generate::grid2d(static_cast<std::uint64_t>(width),
+		                                 static_cast<std::uint64_t>(height),
+		                                 17);
+		auto rng = std::mt19937(6771);
+		auto pick = std::uniform_int_distribution<int>(0, width * height - 1);
+		auto edges = std::vector<gdwg::graph<int, int>::value_type>(g.begin(), g.end());
+		for (auto i = std::size_t{0}; i < edges.size(); i += 7) {
+			g.erase_edge(edges[i].from, edges[i].to, edges[i].weight);
+		}
+		for (auto i = 0; i < width; ++i) {
+			g.insert_edge(pick(rng), pick(rng), 150);
+		}
+		return g;
+	}
+
+	// Edge lists of one direction of a hand-made hierarchy
+	struct edge_lists {
+		std::vector<std::size_t> offsets;
+		std::vector<std::uint32_t> targets;
+		std::vector<std::uint32_t> middles;
+		std::vector<int> weights;
+	};
+
+	constexpr auto none = std::numeric_limits<std::uint32_t>::max();
+
+	// A saved hierarchy of the nodes 1, 2 and 3, ranked in that order, after the header of a
+	// saved contraction_hierarchy<int, int> (magic, version, byte order mark and layout)
+	auto crafted(std::string const& saved, edge_lists const& up, edge_lists const& down)
+	   -> std::stringstream {
+		auto result = std::stringstream(saved.substr(0, 28));
+		result.seekp(0, std::ios::end);
+		auto out = gdwg::detail::serialize::writer(result);
+		out.write(std::vector<int>{1, 2, 3});
+		out.write(std::vector<std::uint32_t>{0, 1, 2});
+		for (auto const* lists : {&up, &down}) {
+			out.write(lists->offsets);
+			out.write(lists->targets);
+			out.write(lists->middles);
+			out.write(lists->weights);
+		}
+		return result;
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test contraction_hierarchy answers shortest-path queries") {
+	auto const g = road_graph(25, 20);
+	auto const s = gdwg::snapshot(g);
+	auto const ch = gdwg::contraction_hierarchy(g, 1);
+	REQUIRE(ch.num_nodes() == 500);
+	CHECK(ch.num_shortcuts() > 0);
+
+	auto context = gdwg::search_context<int>();
+	auto reference = gdwg::search_context<int>();
+	auto const zero = [](std::uint32_t) { return 0; };
+	auto rng = std::mt19937(1);
+	auto pick = std::uniform_int_distribution<std::uint32_t>(0, 499);
+	auto ch_settled = std::size_t{0};
+	auto dijkstra_settled = std::size_t{0};
+	for (auto query = 0; query < 200; ++query) {
+		auto const src = pick(rng);
+		auto const dst = query == 0 ? src : pick(rng);
+		auto const expected = gdwg::astar(s, src, dst, zero, reference);
+		dijkstra_settled += reference.settled();
+
+		auto const distance = ch.distance(src, dst, context);
+		ch_settled += context.settled();
+		REQUIRE(distance.has_value() == expected.has_value());
+		auto const path = ch.path(src, dst, context);
+		REQUIRE(path.has_value() == expected.has_value());
+		if (expected) {
+			CHECK(*distance == expected->distance);
+			CHECK(path->distance == expected->distance);
+			auto nodes = std::vector<int>();
+			for (auto const id : path->nodes) {
+				nodes.push_back(s.node(id));
+			}
+			CHECK(nodes.front() == s.node(src));
+			CHECK(nodes.back() == s.node(dst));
+			CHECK(path_length(g, nodes) == expected->distance);
+		}
+	}
+	CHECK(ch_settled * 3 < dijkstra_settled);
+
+	SECTION("Check the hierarchy doesn't depend on the number of threads") {
+		auto const parallel = gdwg::contraction_hierarchy(g, 4);
+		CHECK(parallel.num_edges() == ch.num_edges());
+		CHECK(parallel.num_shortcuts() == ch.num_shortcuts());
+		for (auto id = std::uint32_t{0}; id < 500; ++id) {
+			CHECK(parallel.rank(id) == ch.rank(id));
+		}
+	}
+}
+
+TEST_CASE("Test contraction_hierarchy queries by node value") {
+	auto g = gdwg::graph<std::string, double>{"a", "b", "c", "d", "e", "f"};
+	g.insert_edge("a", "b", 1.0);
+	g.insert_edge("a", "b", 0.5);
+	g.insert_edge("b", "c", 1.0);
+	g.insert_edge("a", "c", 2.0);
+	g.insert_edge("c", "d", 0.25);
+	g.insert_edge("d", "d", 0.0);
+	g.insert_edge("d", "a", 4.0);
+	g.insert_edge("e", "f", 1.0);
+	auto const ch = gdwg::contraction_hierarchy(g);
+
+	SECTION("Check distances and paths, with parallel edges and self-loops") {
+		CHECK(ch.distance("a", "d") == 1.75);
+		CHECK(ch.path("a", "d") == std::vector<std::string>{"a", "b", "c", "d"});
+		CHECK(ch.distance("d", "c") == 5.5);
+		CHECK(ch.path("b", "b") == std::vector<std::string>{"b"});
+		CHECK(ch.distance("b", "b") == 0.0);
+	}
+
+	SECTION("Check unreachable nodes") {
+		CHECK_FALSE(ch.distance("a", "e"));
+		CHECK_FALSE(ch.path("f", "e"));
+	}
+
+	SECTION("Check exception is thrown for nodes that don't exist") {
+		REQUIRE_THROWS_MATCHES(ch.distance("a", "z"),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::contraction_hierarchy<N, E>::distance if "
+		                                      "src or dst node don't exist in the graph"));
+		auto context = gdwg::search_context<double>();
+		REQUIRE_THROWS_MATCHES(ch.path(6, 0, context),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::contraction_hierarchy<N, E>::path if src "
+		                                      "or dst node don't exist in the graph"));
+	}
+
+	SECTION("Check exception is thrown for negative weights") {
+		auto negative = gdwg::graph<int, int>{1, 2};
+		negative.insert_edge(1, 2, -3);
+		REQUIRE_THROWS_MATCHES(gdwg::contraction_hierarchy(negative),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot build gdwg::contraction_hierarchy<N, E> from a graph "
+		                                      "with negative edge weights"));
+	}
+
+	SECTION("Check an empty hierarchy") {
+		auto const empty = gdwg::contraction_hierarchy(gdwg::graph<std::string, double>());
+		CHECK(empty.num_nodes() == 0);
+		CHECK(empty.num_edges() == 0);
+	}
+}
+
+TEST_CASE("Test contraction_hierarchy can be saved and loaded") {
+	auto const g = road_graph(12, 10);
+	auto const ch = gdwg::contraction_hierarchy(g);
+	auto const expect_same = [&](gdwg::contraction_hierarchy<int, int> const& loaded) {
+		REQUIRE(loaded.num_nodes() == ch.num_nodes());
+		CHECK(loaded.num_edges() == ch.num_edges());
+		for (auto src = 0; src < 120; src += 7) {
+			for (auto dst = 0; dst < 120; dst += 5) {
+				CHECK(loaded.distance(src, dst) == ch.distance(src, dst));
+				CHECK(loaded.path(src, dst) == ch.path(src, dst));
+			}
+		}
+	};
+
+	SECTION("Check a stream round trip") {
+		auto buffer = std::stringstream();
+		ch.save(buffer);
+		expect_same(gdwg::contraction_hierarchy<int, int>::load(buffer));
+	}
+
+	SECTION("Check a file round trip") {
+		auto const file = std::filesystem::temp_directory_path() / "gdwg_graph_test16.ch";
+		ch.save(file);
+		expect_same(gdwg::contraction_hierarchy<int, int>::load(file));
+		std::filesystem::remove(file);
+	}
+
+	SECTION("Check string nodes") {
+		auto words = gdwg::graph<std::string, int>{"ab", "cd", "ef"};
+		words.insert_edge("ab", "cd", 1);
+		words.insert_edge("cd", "ef", 2);
+		auto buffer = std::stringstream();
+		gdwg::contraction_hierarchy(words).save(buffer);
+		auto const loaded = gdwg::contraction_hierarchy<std::string, int>::load(buffer);
+		CHECK(loaded.path("ab", "ef") == std::vector<std::string>{"ab", "cd", "ef"});
+	}
+
+	SECTION("Check exception is thrown for truncated, corrupt or mismatched input") {
+		auto buffer = std::stringstream();
+		ch.save(buffer);
+		auto const bytes = buffer.str();
+		auto const message = "Cannot call gdwg::contraction_hierarchy<N, E>::load on a stream that "
+		                     "doesn't hold a valid contraction hierarchy";
+
+		auto truncated = std::stringstream(bytes.substr(0, bytes.size() / 2));
+		REQUIRE_THROWS_MATCHES((gdwg::contraction_hierarchy<int, int>::load(truncated)),
+		                       std::runtime_error,
+		                       Catch::Message(message));
+
+		auto corrupt_bytes = bytes;
+		corrupt_bytes[3] = 'x';
+		auto corrupt = std::stringstream(corrupt_bytes);
+		REQUIRE_THROWS_MATCHES((gdwg::contraction_hierarchy<int, int>::load(corrupt)),
+		                       std::runtime_error,
+		                       Catch::Message(message));
+
+		auto mismatched = std::stringstream(bytes);
+		REQUIRE_THROWS_MATCHES((gdwg::contraction_hierarchy<int, double>::load(mismatched)),
+		                       std::runtime_error,
+		                       Catch::Message(message));
+
+		// 2 -> 1 and 1 -> 3, with the shortcut 2 -> 3 through 1
+		auto const up = edge_lists{{0, 1, 2, 2}, {2, 2}, {none, 0}, {1, 2}};
+		auto const down = edge_lists{{0, 1, 1, 1}, {1}, {none}, {1}};
+		auto valid = crafted(bytes, up, down);
+		CHECK(gdwg::contraction_hierarchy<int, int>::load(valid).path(2, 3)
+		      == std::vector<int>{2, 1, 3});
+
+		auto unsorted = crafted(bytes, {{0, 2, 3, 3}, {2, 1, 2}, {none, none, 0}, {1, 1, 2}}, down);
+		REQUIRE_THROWS_MATCHES((gdwg::contraction_hierarchy<int, int>::load(unsorted)),
+		                       std::runtime_error,
+		                       Catch::Message(message));
+
+		auto missing_half = crafted(bytes, up, {{0, 0, 0, 0}, {}, {}, {}});
+		REQUIRE_THROWS_MATCHES((gdwg::contraction_hierarchy<int, int>::load(missing_half)),
+		                       std::runtime_error,
+		                       Catch::Message(message));
+
+		// 2 -> 1 through 3 and 2 -> 3 through 1 would unpack into each other forever
+		auto cyclic = crafted(bytes, up, {{0, 1, 1, 1}, {1}, {2}, {1}});
+		REQUIRE_THROWS_MATCHES((gdwg::contraction_hierarchy<int, int>::load(cyclic)),
+		                       std::runtime_error,
+		                       Catch::Message(message));
+
+		auto missing = std::filesystem::temp_directory_path() / "gdwg_graph_test16_missing.ch";
+		REQUIRE_THROWS_MATCHES((gdwg::contraction_hierarchy<int, int>::load(missing)),
+		                       std::runtime_error,
+		                       Catch::Message(message));
+	}
+}
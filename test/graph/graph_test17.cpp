@@ -0,0 +1,198 @@
+#include "gdwg/dense_graph.hpp"
+#include "gdwg/detail/simd.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+#include "random_graph.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Dense Graphs
+
+namespace helper {
+	// Every pair of nodes of a dense graph must have the edges it has in the graph
+	template<typename N, typename E>
+	auto check_matches(gdwg::dense_graph<N, E> const& d, gdwg::graph<N, E> const& g) -> void {
+		auto const nodes = g.nodes();
+		REQUIRE(d.num_nodes() == nodes.size());
+		auto edges = std::size_t{0};
+		for (auto const& src : nodes) {
+			auto const u = *d.id(src);
+			CHECK(d.node(u) == src);
+			for (auto const& dst : nodes) {
+				auto const v = *d.id(dst);
+				auto const weights = g.weights(src, dst);
+				CHECK(d.has_edge(u, v) == g.is_connected(src, dst));
+				CHECK(d.weights(u, v) == weights);
+				edges += weights.size();
+			}
+		}
+		CHECK(d.num_edges() == edges);
+	}
+
+	auto sorted_ids(gdwg::dense_graph<int, int> const& d, std::vector<int> const& values)
+	   -> std::vector<std::uint32_t> {
+		auto ids = std::vector<std::uint32_t>();
+		for (auto const value : values) {
+			ids.push_back(*d.id(value));
+		}
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test bitset row kernels agree with each other") {
+	namespace simd = gdwg::detail::simd;
+	auto rng = std::mt19937(6771);
+	for (auto const words : {std::size_t{0}, std::size_t{1}, std::size_t{4}, std::size_t{13}}) {
+		auto a = std::vector<std::uint64_t>(words);
+		auto b = std::vector<std::uint64_t>(words);
+		auto both = std::size_t{0};
+		auto either = std::size_t{0};
+		for (auto i = std::size_t{0}; i < words; ++i) {
+			a[i] = (std::uint64_t{rng()} << 32U) | rng();
+			b[i] = (std::uint64_t{rng()} << 32U) | rng();
+			for (auto bit = 0U; bit < 64; ++bit) {
+				auto const in_a = ((a[i] >> bit) & 1U) != 0;
+				auto const in_b = ((b[i] >> bit) & 1U) != 0;
+				both += in_a and in_b ? 1 : 0;
+				either += in_a or in_b ? 1 : 0;
+			}
+		}
+
+		for (auto const level : {simd::isa::scalar, simd::isa::avx2}) {
+			if (not simd::is_supported(level)) {
+				continue;
+			}
+			CHECK(simd::bitset_count(a.data(), b.data(), words, simd::bit_and{}, level) == both);
+			CHECK(simd::bitset_count(a.data(), b.data(), words, simd::bit_or{}, level) == either);
+			auto out = std::vector<std::uint64_t>(words);
+			simd::bitset_apply(out.data(), a.data(), b.data(), words, simd::bit_and{}, level);
+			for (auto i = std::size_t{0}; i < words; ++i) {
+				CHECK(out[i] == (a[i] & b[i]));
+			}
+		}
+	}
+}
+
+TEST_CASE("Test dense_graph keeps every edge") {
+	auto rng = std::mt19937(6771);
+
+	SECTION("Check a dense random graph with parallel edges") {
+		auto const g = random_graph(rng, 90, 6000, std::uniform_int_distribution<int>(0, 3), 10);
+		auto const d = gdwg::dense_graph(g);
+		check_matches(d, g);
+		for (auto const& src : g.nodes()) {
+			auto const u = *d.id(src);
+			auto const connections = g.connections(src);
+			CHECK(d.neighbours(u) == sorted_ids(d, connections));
+			auto degree = std::size_t{0};
+			for (auto const& dst : connections) {
+				degree += g.weights(src, dst).size();
+			}
+			CHECK(d.out_degree(u) == degree);
+		}
+	}
+
+	SECTION("Check a reordered snapshot keeps its ids") {
+		auto const g = random_graph(rng, 70, 1500, std::uniform_int_distribution<int>(0, 2), 10);
+		auto const s = gdwg::snapshot(g, gdwg::ordering::rcm);
+		auto const d = gdwg::dense_graph(s);
+		check_matches(d, g);
+		for (auto const& value : g.nodes()) {
+			CHECK(d.id(value) == s.id(value));
+		}
+		CHECK_FALSE(d.id(1).has_value());
+	}
+
+	SECTION("Check string nodes and double weights") {
+		auto g = gdwg::graph<std::string, double>{"a", "b", "c"};
+		g.insert_edge("a", "b", 2.5);
+		g.insert_edge("a", "b", 0.5);
+		g.insert_edge("c", "c", 1.0);
+		auto const d = gdwg::dense_graph(g);
+		check_matches(d, g);
+		CHECK(d.is_connected("a", "b"));
+		CHECK_FALSE(d.is_connected("b", "a"));
+		CHECK(d.is_connected("c", "c"));
+	}
+
+	SECTION("Check an empty graph") {
+		auto const d = gdwg::dense_graph(gdwg::graph<int, int>{});
+		CHECK(d.num_nodes() == 0);
+		CHECK(d.num_edges() == 0);
+	}
+}
+
+TEST_CASE("Test dense_graph insert_edge() and erase_edge()") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	auto d = gdwg::dense_graph(g);
+	auto const one = *d.id(1);
+	auto const two = *d.id(2);
+
+	SECTION("Check parallel edges in any order") {
+		for (auto const weight : {5, 3, 9, 3, 7, 5}) {
+			CHECK(d.insert_edge(one, two, weight) == g.insert_edge(1, 2, weight));
+		}
+		check_matches(d, g);
+		CHECK(d.out_degree(one) == 4);
+
+		// Erasing the smallest weight promotes the next one out of the overflow
+		for (auto const weight : {3, 4, 9, 3, 5, 7}) {
+			CHECK(d.erase_edge(one, two, weight) == g.erase_edge(1, 2, weight));
+			check_matches(d, g);
+		}
+		CHECK_FALSE(d.has_edge(one, two));
+		CHECK(d.num_edges() == 0);
+	}
+
+	SECTION("Check exception is thrown if a node does not exist") {
+		REQUIRE_THROWS_MATCHES(d.insert_edge(one, 3, 1),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::dense_graph<N, E>::insert_edge if src "
+		                                      "or dst node don't exist in the graph"));
+		REQUIRE_THROWS_MATCHES(d.erase_edge(7, two, 1),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::dense_graph<N, E>::erase_edge if src "
+		                                      "or dst node don't exist in the graph"));
+		REQUIRE_THROWS_MATCHES(d.is_connected(1, 4),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::dense_graph<N, E>::is_connected if src "
+		                                      "or dst node don't exist in the graph"));
+	}
+}
+
+TEST_CASE("Test dense_graph neighbourhood unions and intersections") {
+	auto rng = std::mt19937(6771);
+	// More than 256 nodes, so rows span several blocks
+	auto const g = random_graph(rng, 300, 30000, std::uniform_int_distribution<int>(0, 1), 10);
+	auto const d = gdwg::dense_graph(g);
+	auto const nodes = g.nodes();
+	for (auto i = std::size_t{0}; i < nodes.size(); i += 7) {
+		for (auto j = std::size_t{0}; j < nodes.size(); j += 11) {
+			auto const a = sorted_ids(d, g.connections(nodes[i]));
+			auto const b = sorted_ids(d, g.connections(nodes[j]));
+			auto both = std::vector<std::uint32_t>();
+			auto either = std::vector<std::uint32_t>();
+			std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(both));
+			std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(either));
+
+			auto const u = *d.id(nodes[i]);
+			auto const v = *d.id(nodes[j]);
+			CHECK(d.common_neighbours(u, v) == both);
+			CHECK(d.common_neighbour_count(u, v) == both.size());
+			CHECK(d.neighbourhood_union(u, v) == either);
+			CHECK(d.neighbourhood_union_count(u, v) == either.size());
+		}
+	}
+	CHECK(d.row(0).size() == 8);
+}
@@ -0,0 +1,171 @@
+#include "gdwg/all_pairs.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+#include "random_graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Rationale: test/README.md
+
+// All-Pairs Shortest Paths
+
+namespace helper {
+	// Textbook Floyd-Warshall over the graph's own API
+	auto reference(gdwg::graph<int, int> const& g) -> std::vector<std::vector<std::optional<int>>> {
+		auto const nodes = g.nodes();
+		auto const n = nodes.size();
+		auto d = std::vector<std::vector<std::optional<int>>>(n, std::vector<std::optional<int>>(n));
+		for (auto u = std::size_t{0}; u < n; ++u) {
+			d[u][u] = 0;
+			for (auto v = std::size_t{0}; v < n; ++v) {
+				for (auto const weight : g.weights(nodes[u], nodes[v])) {
+					if (not d[u][v] or weight < *d[u][v]) {
+						d[u][v] = weight;
+					}
+				}
+			}
+		}
+		for (auto k = std::size_t{0}; k < n; ++k) {
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				for (auto j = std::size_t{0}; j < n; ++j) {
+					if (d[i][k] and d[k][j] and (not d[i][j] or *d[i][k] + *d[k][j] < *d[i][j])) {
+						d[i][j] = *d[i][k] + *d[k][j];
+					}
+				}
+			}
+		}
+		return d;
+	}
+
+	auto check_matches(gdwg::distance_matrix<int, int> const& m, gdwg::graph<int, int> const& g)
+	   -> void {
+		auto const expected = reference(g);
+		auto const nodes = g.nodes();
+		REQUIRE(m.num_nodes() == nodes.size());
+		for (auto u = std::size_t{0}; u < nodes.size(); ++u) {
+			for (auto v = std::size_t{0}; v < nodes.size(); ++v) {
+				CHECK(m.distance(nodes[u], nodes[v]) == expected[u][v]);
+			}
+		}
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test all_pairs_shortest_paths() agrees with Floyd-Warshall") {
+	auto rng = std::mt19937(6771);
+	auto const positive = std::uniform_int_distribution<int>(1, 100);
+
+	SECTION("Check a sparse graph over several tiles, with unreachable pairs") {
+		auto const g = random_graph(rng, 150, 300, positive);
+		auto const m = gdwg::all_pairs_shortest_paths(g);
+		check_matches(m, g);
+	}
+
+	SECTION("Check a dense graph with parallel edges and self-loops") {
+		auto g = random_graph(rng, 70, 3000, std::uniform_int_distribution<int>(0, 100));
+		g.insert_edge(5, 5, 3);
+		auto const m = gdwg::all_pairs_shortest_paths(g, 4);
+		check_matches(m, g);
+		CHECK(m(5, 5) == 0);
+	}
+
+	SECTION("Check negative weights without a negative cycle") {
+		auto const g = random_dag(rng, 130, 1500, std::uniform_int_distribution<int>(-50, 100));
+		auto const m = gdwg::all_pairs_shortest_paths(g);
+		check_matches(m, g);
+		// Nothing reaches an earlier node, even through negative weights
+		CHECK(m(100, 3) == m.infinity());
+		CHECK(m.row(100)[3] == m.infinity());
+	}
+
+	SECTION("Check the result is the same for any number of threads") {
+		auto const g = random_graph(rng, 200, 2000, positive);
+		auto const one = gdwg::all_pairs_shortest_paths(g, 1);
+		auto const many = gdwg::all_pairs_shortest_paths(g, 8);
+		for (auto u = std::uint32_t{0}; u < 200; ++u) {
+			auto const a = one.row(u);
+			auto const b = many.row(u);
+			CHECK(std::vector<int>(a.begin(), a.end()) == std::vector<int>(b.begin(), b.end()));
+		}
+	}
+}
+
+TEST_CASE("Test distance_matrix ids and node types") {
+	SECTION("Check a reordered snapshot keeps its ids") {
+		auto rng = std::mt19937(6771);
+		auto const g = random_graph(rng, 80, 400, std::uniform_int_distribution<int>(1, 100));
+		auto const s = gdwg::snapshot(g, gdwg::ordering::rcm);
+		auto const m = gdwg::all_pairs_shortest_paths(s);
+		check_matches(m, g);
+		for (auto const& value : g.nodes()) {
+			CHECK(m.id(value) == s.id(value));
+			CHECK(m.node(*m.id(value)) == value);
+		}
+		CHECK_FALSE(m.id(80).has_value());
+	}
+
+	SECTION("Check string nodes and double weights") {
+		auto g = gdwg::graph<std::string, double>{"a", "b", "c", "d"};
+		g.insert_edge("a", "b", 1.5);
+		g.insert_edge("b", "c", 2.25);
+		g.insert_edge("a", "c", 4.0);
+		g.insert_edge("c", "a", -0.5);
+		auto const m = gdwg::distance_matrix(g);
+		CHECK(m.distance("a", "c") == 3.75);
+		CHECK(m.distance("b", "a") == 1.75);
+		CHECK(m.distance("c", "b") == 1.0);
+		CHECK(m.distance("a", "d") == std::nullopt);
+		CHECK(m(*m.id("d"), *m.id("a")) == m.infinity());
+	}
+
+	SECTION("Check an empty graph") {
+		auto const m = gdwg::all_pairs_shortest_paths(gdwg::graph<int, int>{});
+		CHECK(m.num_nodes() == 0);
+	}
+
+	SECTION("Check exception is thrown for a negative cycle") {
+		auto g = gdwg::graph<int, int>{1, 2, 3};
+		g.insert_edge(1, 2, 4);
+		g.insert_edge(2, 3, -3);
+		g.insert_edge(3, 2, 2);
+		REQUIRE_THROWS_MATCHES(gdwg::all_pairs_shortest_paths(g),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::all_pairs_shortest_paths on a graph "
+		                                      "with a negative cycle"));
+		auto loop = gdwg::graph<int, int>{1};
+		loop.insert_edge(1, 1, -1);
+		REQUIRE_THROWS_MATCHES(gdwg::all_pairs_shortest_paths(loop),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::all_pairs_shortest_paths on a graph "
+		                                      "with a negative cycle"));
+		// Distances double with every node of the tile relaxed through, far past the range of int
+		auto dense = gdwg::graph<int, int>();
+		for (auto u = 0; u < 40; ++u) {
+			dense.insert_node(u);
+		}
+		for (auto u = 0; u < 40; ++u) {
+			for (auto v = 0; v < 40; ++v) {
+				dense.insert_edge(u, v, -100'000'000);
+			}
+		}
+		REQUIRE_THROWS_MATCHES(gdwg::all_pairs_shortest_paths(dense),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::all_pairs_shortest_paths on a graph "
+		                                      "with a negative cycle"));
+	}
+
+	SECTION("Check exception is thrown for nodes that don't exist") {
+		auto const m = gdwg::all_pairs_shortest_paths(gdwg::graph<int, int>{1, 2});
+		REQUIRE_THROWS_MATCHES(m.distance(1, 3),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::distance_matrix<N, E>::distance if src "
+		                                      "or dst node don't exist in the graph"));
+	}
+}
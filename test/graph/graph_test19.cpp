@@ -0,0 +1,215 @@
+#include "gdwg/dag.hpp"
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+#include "random_graph.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Directed Acyclic Graphs
+
+namespace helper {
+	// Every edge must go from an earlier to a later position
+	template<typename N, typename E>
+	auto check_order(gdwg::graph<N, E> const& g, std::vector<N> const& order) -> void {
+		REQUIRE(order.size() == g.nodes().size());
+		auto position = std::map<N, std::size_t>();
+		for (auto i = std::size_t{0}; i < order.size(); ++i) {
+			position[order[i]] = i;
+		}
+		REQUIRE(position.size() == order.size());
+		for (auto const& [from, to, weight] : g) {
+			CHECK(position.at(from) < position.at(to));
+		}
+	}
+
+	// Longest path ending at every node, by memoised recursion over incoming edges
+	auto longest_ending_at(gdwg::graph<int, int> const& g, int v, std::map<int, int>& memo) -> int {
+		if (auto const it = memo.find(v); it != memo.end()) {
+			return it->second;
+		}
+		auto best = 0;
+		for (auto const& [from, to, weight] : g) {
+			if (to == v) {
+				best = std::max(best, longest_ending_at(g, from, memo) + weight);
+			}
+		}
+		memo[v] = best;
+		return best;
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test topological_sort() and topological_levels()") {
+	auto rng = std::mt19937(6771);
+	auto const dag_weight = std::uniform_int_distribution<int>(-5, 20);
+
+	SECTION("Check a random DAG with parallel edges") {
+		auto g = random_dag(rng, 300, 1500, dag_weight);
+		g.insert_edge(3, 7, 100);
+		g.insert_edge(3, 7, 101);
+		check_order(g, gdwg::topological_sort(g));
+
+		auto const levels = gdwg::topological_levels(g, 4);
+		auto flat = std::vector<int>();
+		auto level_of = std::map<int, std::size_t>();
+		for (auto i = std::size_t{0}; i < levels.size(); ++i) {
+			CHECK(std::is_sorted(levels[i].begin(), levels[i].end()));
+			for (auto const node : levels[i]) {
+				flat.push_back(node);
+				level_of[node] = i;
+			}
+		}
+		check_order(g, flat);
+		// Each node is one level after its latest predecessor
+		for (auto const node : g.nodes()) {
+			auto expected = std::size_t{0};
+			for (auto const& [from, to, weight] : g) {
+				if (to == node) {
+					expected = std::max(expected, level_of.at(from) + 1);
+				}
+			}
+			CHECK(level_of.at(node) == expected);
+		}
+	}
+
+	SECTION("Check levels are the same for any number of threads") {
+		auto const s = gdwg::snapshot(random_dag(rng, 2000, 8000, dag_weight));
+		CHECK(gdwg::topological_levels(s, 1) == gdwg::topological_levels(s, 8));
+	}
+
+	SECTION("Check a small schedule") {
+		auto g = gdwg::graph<std::string, int>{"compile", "link", "test", "fetch", "docs"};
+		g.insert_edge("fetch", "compile", 1);
+		g.insert_edge("compile", "link", 1);
+		g.insert_edge("link", "test", 1);
+		g.insert_edge("fetch", "docs", 1);
+		CHECK(gdwg::topological_sort(g)
+		      == std::vector<std::string>{"fetch", "compile", "docs", "link", "test"});
+		CHECK(gdwg::topological_levels(g)
+		      == std::vector<std::vector<std::string>>{{"fetch"},
+		                                               {"compile", "docs"},
+		                                               {"link"},
+		                                               {"test"}});
+	}
+
+	SECTION("Check an empty graph") {
+		CHECK(gdwg::topological_sort(gdwg::graph<int, int>{}).empty());
+		CHECK(gdwg::topological_levels(gdwg::graph<int, int>{}).empty());
+	}
+
+	SECTION("Check exception is thrown for a cycle") {
+		auto g = gdwg::graph<int, int>{1, 2, 3};
+		g.insert_edge(1, 2, 0);
+		g.insert_edge(2, 3, 0);
+		g.insert_edge(3, 2, 0);
+		REQUIRE_THROWS_MATCHES(gdwg::topological_sort(g),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::topological_sort on a graph with a "
+		                                      "cycle"));
+		REQUIRE_THROWS_MATCHES(gdwg::topological_levels(g),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::topological_levels on a graph with a "
+		                                      "cycle"));
+	}
+}
+
+TEST_CASE("Test find_cycle()") {
+	auto rng = std::mt19937(6771);
+	auto const dag_weight = std::uniform_int_distribution<int>(-5, 20);
+
+	SECTION("Check an acyclic graph has no cycle") {
+		CHECK_FALSE(gdwg::find_cycle(random_dag(rng, 200, 1000, dag_weight)).has_value());
+		CHECK_FALSE(gdwg::find_cycle(gdwg::graph<int, int>{}).has_value());
+	}
+
+	SECTION("Check a cycle is returned in edge order") {
+		auto g = random_dag(rng, 200, 1000, dag_weight);
+		g.insert_edge(150, 20, 1); // Closes a cycle with any path from 20 to 150
+		REQUIRE(gdwg::find_cycle(g).has_value());
+		auto const cycle = *gdwg::find_cycle(g);
+		REQUIRE(cycle.size() >= 2);
+		for (auto i = std::size_t{0}; i < cycle.size(); ++i) {
+			CHECK(g.is_connected(cycle[i], cycle[(i + 1) % cycle.size()]));
+		}
+	}
+
+	SECTION("Check a self-loop is a cycle of one node") {
+		auto g = gdwg::graph<char, int>{'a', 'b'};
+		g.insert_edge('a', 'b', 1);
+		g.insert_edge('b', 'b', 1);
+		CHECK(gdwg::find_cycle(g) == std::vector<char>{'b'});
+	}
+
+	SECTION("Check a large generated cycle") {
+		auto const g = gdwg::generate::grid2d(50, 50);
+		auto const cycle = gdwg::find_cycle(g);
+		REQUIRE(cycle.has_value());
+		CHECK(cycle->size() == 2);
+	}
+}
+
+TEST_CASE("Test longest_path_dag()") {
+	auto rng = std::mt19937(6771);
+	auto const dag_weight = std::uniform_int_distribution<int>(-5, 20);
+
+	SECTION("Check a random DAG with negative weights") {
+		auto const g = random_dag(rng, 150, 600, dag_weight);
+		auto const path = gdwg::longest_path_dag(g);
+		auto memo = std::map<int, int>();
+		auto best = 0;
+		for (auto const node : g.nodes()) {
+			best = std::max(best, longest_ending_at(g, node, memo));
+		}
+		CHECK(path.distance == best);
+		// The nodes form a path of that length, using the heaviest of any parallel edges
+		REQUIRE_FALSE(path.nodes.empty());
+		auto total = 0;
+		for (auto i = std::size_t{0}; i + 1 < path.nodes.size(); ++i) {
+			auto const weights = g.weights(path.nodes[i], path.nodes[i + 1]);
+			REQUIRE_FALSE(weights.empty());
+			total += *std::max_element(weights.begin(), weights.end());
+		}
+		CHECK(total == path.distance);
+	}
+
+	SECTION("Check the critical path of a small schedule") {
+		auto g = gdwg::graph<std::string, double>{"a", "b", "c", "d"};
+		g.insert_edge("a", "b", 2.0);
+		g.insert_edge("a", "c", 1.0);
+		g.insert_edge("b", "d", 1.5);
+		g.insert_edge("c", "d", 4.0);
+		auto const path = gdwg::longest_path_dag(g);
+		CHECK(path.distance == 5.0);
+		CHECK(path.nodes == std::vector<std::string>{"a", "c", "d"});
+	}
+
+	SECTION("Check only negative weights give a single node") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.insert_edge(1, 2, -1);
+		auto const path = gdwg::longest_path_dag(g);
+		CHECK(path.distance == 0);
+		CHECK(path.nodes == std::vector<int>{1});
+		CHECK(gdwg::longest_path_dag(gdwg::graph<int, int>{}).nodes.empty());
+	}
+
+	SECTION("Check exception is thrown for a cycle") {
+		auto g = gdwg::graph<int, int>{1};
+		g.insert_edge(1, 1, 1);
+		REQUIRE_THROWS_MATCHES(gdwg::longest_path_dag(g),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::longest_path_dag on a graph with a "
+		                                      "cycle"));
+	}
+}
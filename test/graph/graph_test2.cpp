@@ -153,6 +153,29 @@ TEST_CASE("Test node replacement") {
 		CHECK_FALSE(g.replace_node(3, 4));
 	}
 
+	SECTION("Check every parallel incoming edge is moved") {
+		g.insert_edge(1, 3, "Hi");
+		g.insert_edge(1, 3, "Hey");
+		REQUIRE(g.replace_node(3, 0));
+		check_output_is_expected(g,
+		                         std::string_view(
+		                            R"(0 (
+  0 | you?
+)
+1 (
+  0 | Hey
+  0 | Hi
+  0 | How
+  2 | Hello!
+)
+2 (
+  0 | are
+)
+4 (
+)
+)"));
+	}
+
 	SECTION("Check exception is thrown if node to be replaced does not exist") {
 		REQUIRE_THROWS_MATCHES(g.replace_node(7, 8),
 		                       std::runtime_error,
@@ -265,6 +288,24 @@ TEST_CASE("Test node erasure") {
 )
 643.6 (
 )
+)"));
+	}
+
+	SECTION("Check every parallel incoming edge is erased") {
+		g.insert_edge(1.53, 325, 2);
+		g.insert_edge(1.53, 325, 3);
+		g.insert_edge(1.53, 643.6, 4);
+		CHECK(g.erase_node(325));
+		CHECK(g.num_edges() == 1);
+		check_output_is_expected(g,
+		                         std::string_view(
+		                            R"(1.53 (
+  643.6 | 4
+)
+99.99 (
+)
+643.6 (
+)
 )"));
 	}
 }
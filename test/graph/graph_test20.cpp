@@ -0,0 +1,155 @@
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/spanning_forest.hpp"
+#include "random_graph.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <map>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Minimum Spanning Forests
+
+namespace helper {
+	// Sequential union-find over node values
+	template<typename N>
+	class sets {
+	public:
+		auto find(N const& x) -> N {
+			auto const it = parent_.find(x);
+			if (it == parent_.end() or it->second == x) {
+				return x;
+			}
+			return it->second = find(it->second);
+		}
+
+		auto unite(N const& a, N const& b) -> bool {
+			auto const ra = find(a);
+			auto const rb = find(b);
+			if (ra == rb) {
+				return false;
+			}
+			parent_[ra] = rb;
+			return true;
+		}
+
+	private:
+		std::map<N, N> parent_;
+	};
+
+	// Total weight and edge count of the forest found by Kruskal's algorithm
+	template<typename N, typename E>
+	auto kruskal(gdwg::graph<N, E> const& g) -> std::pair<E, std::size_t> {
+		auto edges = std::vector<typename gdwg::graph<N, E>::value_type>();
+		for (auto const& [from, to, weight] : g) {
+			edges.push_back({from, to, weight});
+		}
+		std::stable_sort(edges.begin(), edges.end(), [](auto const& a, auto const& b) {
+			return a.weight < b.weight;
+		});
+		auto forest = sets<N>();
+		auto total = E{};
+		auto count = std::size_t{0};
+		for (auto const& edge : edges) {
+			if (edge.from != edge.to and forest.unite(edge.from, edge.to)) {
+				total += edge.weight;
+				++count;
+			}
+		}
+		return {total, count};
+	}
+
+	// The edges must be edges of g and form a forest, lightest first
+	template<typename N, typename E>
+	auto check_forest(gdwg::graph<N, E> const& g,
+	                  std::vector<typename gdwg::graph<N, E>::value_type> const& forest) -> E {
+		auto cycle_check = sets<N>();
+		auto total = E{};
+		for (auto i = std::size_t{0}; i < forest.size(); ++i) {
+			auto const& edge = forest[i];
+			CHECK(g.find(edge.from, edge.to, edge.weight) != g.end());
+			CHECK(cycle_check.unite(edge.from, edge.to));
+			if (i > 0) {
+				CHECK_FALSE(edge.weight < forest[i - 1].weight);
+			}
+			total += edge.weight;
+		}
+		return total;
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test minimum_spanning_forest() agrees with Kruskal's algorithm") {
+	auto rng = std::mt19937(6771);
+	auto const tied_weight = std::uniform_int_distribution<int>(1, 20); // Plenty of ties
+
+	SECTION("Check a sparse random graph with several components") {
+		auto const g = random_graph(rng, 500, 400, tied_weight);
+		auto const forest = gdwg::minimum_spanning_forest(g, 4);
+		auto const [total, count] = kruskal(g);
+		CHECK(forest.size() == count);
+		CHECK(check_forest(g, forest) == total);
+	}
+
+	SECTION("Check a dense random graph") {
+		auto const g = random_graph(rng, 200, 5000, tied_weight);
+		auto const forest = gdwg::minimum_spanning_forest(g);
+		auto const [total, count] = kruskal(g);
+		CHECK(forest.size() == 199);
+		CHECK(forest.size() == count);
+		CHECK(check_forest(g, forest) == total);
+	}
+
+	SECTION("Check a generated graph with floating-point weights") {
+		auto const g = gdwg::generate::rmat<int, double>(10, 8);
+		auto const forest = gdwg::minimum_spanning_forest(g);
+		auto const [total, count] = kruskal(g);
+		CHECK(forest.size() == count);
+		CHECK(check_forest(g, forest) == Approx(total));
+	}
+
+	SECTION("Check the forest is the same for any number of threads") {
+		auto const g = random_graph(rng, 3000, 12000, tied_weight);
+		auto const key = [](auto const& forest) {
+			auto result = std::vector<std::tuple<int, int, int>>();
+			for (auto const& [from, to, weight] : forest) {
+				result.emplace_back(from, to, weight);
+			}
+			return result;
+		};
+		CHECK(key(gdwg::minimum_spanning_forest(g, 1)) == key(gdwg::minimum_spanning_forest(g, 8)));
+	}
+}
+
+TEST_CASE("Test minimum_spanning_forest() edge cases") {
+	SECTION("Check parallel edges, reversed edges and self-loops") {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+		g.insert_edge("a", "a", -10);
+		g.insert_edge("a", "b", 7);
+		g.insert_edge("a", "b", 3);
+		g.insert_edge("b", "a", 2);
+		g.insert_edge("c", "b", 4);
+		g.insert_edge("a", "c", 9);
+		auto const forest = gdwg::minimum_spanning_forest(g);
+		REQUIRE(forest.size() == 2);
+		CHECK(forest[0].from == "b");
+		CHECK(forest[0].to == "a");
+		CHECK(forest[0].weight == 2);
+		CHECK(forest[1].from == "c");
+		CHECK(forest[1].to == "b");
+		CHECK(forest[1].weight == 4);
+	}
+
+	SECTION("Check graphs without edges") {
+		CHECK(gdwg::minimum_spanning_forest(gdwg::graph<int, int>{}).empty());
+		CHECK(gdwg::minimum_spanning_forest(gdwg::graph<int, int>{1, 2, 3}).empty());
+	}
+}
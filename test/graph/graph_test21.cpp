@@ -0,0 +1,180 @@
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/max_flow.hpp"
+#include "random_graph.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Maximum Flows
+
+namespace helper {
+	// Edmonds-Karp over a capacity matrix, summing parallel edges
+	auto edmonds_karp(gdwg::graph<int, int> const& g, int source, int sink) -> long long {
+		auto const nodes = g.nodes();
+		auto const n = nodes.size();
+		auto index = std::map<int, std::size_t>();
+		for (auto i = std::size_t{0}; i < n; ++i) {
+			index[nodes[i]] = i;
+		}
+		auto capacity = std::vector<std::vector<long long>>(n, std::vector<long long>(n, 0));
+		for (auto const& [from, to, weight] : g) {
+			if (from != to) {
+				capacity[index[from]][index[to]] += weight;
+			}
+		}
+		auto const s = index[source];
+		auto const t = index[sink];
+		auto total = 0LL;
+		for (;;) {
+			auto parent = std::vector<std::size_t>(n, n);
+			parent[s] = s;
+			auto queue = std::vector<std::size_t>{s};
+			for (auto head = std::size_t{0}; head < queue.size() and parent[t] == n; ++head) {
+				for (auto v = std::size_t{0}; v < n; ++v) {
+					if (parent[v] == n and capacity[queue[head]][v] > 0) {
+						parent[v] = queue[head];
+						queue.push_back(v);
+					}
+				}
+			}
+			if (parent[t] == n) {
+				return total;
+			}
+			auto bottleneck = capacity[parent[t]][t];
+			for (auto v = t; v != s; v = parent[v]) {
+				bottleneck = std::min(bottleneck, capacity[parent[v]][v]);
+			}
+			for (auto v = t; v != s; v = parent[v]) {
+				capacity[parent[v]][v] -= bottleneck;
+				capacity[v][parent[v]] += bottleneck;
+			}
+			total += bottleneck;
+		}
+	}
+
+	// Flows must respect capacities and be conserved, and the cut must match the value
+	template<typename N, typename E>
+	auto check_flow(gdwg::graph<N, E> const& g,
+	                gdwg::flow_result<N, E> const& result,
+	                N const& source,
+	                N const& sink) -> void {
+		auto balance = std::map<N, E>();
+		auto it = g.begin();
+		REQUIRE(result.edge_flows.size() == static_cast<std::size_t>(std::distance(g.begin(), g.end())));
+		for (auto const& edge : result.edge_flows) {
+			auto const [from, to, capacity] = *it++;
+			CHECK(edge.from == from);
+			CHECK(edge.to == to);
+			CHECK_FALSE(edge.weight < E{});
+			CHECK_FALSE(capacity < edge.weight);
+			balance[from] -= edge.weight;
+			balance[to] += edge.weight;
+		}
+		for (auto const& node : g.nodes()) {
+			if (node != source and node != sink) {
+				CHECK(balance[node] == Approx(0.0).margin(1e-9));
+			}
+		}
+		CHECK(balance[sink] == Approx(result.value));
+
+		auto const side = std::set<N>(result.source_side.begin(), result.source_side.end());
+		CHECK(std::is_sorted(result.source_side.begin(), result.source_side.end()));
+		CHECK(side.contains(source));
+		CHECK_FALSE(side.contains(sink));
+		auto cut = E{};
+		for (auto const& [from, to, capacity] : g) {
+			if (side.contains(from) and not side.contains(to)) {
+				cut += capacity;
+			}
+		}
+		CHECK(cut == Approx(result.value));
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test max_flow() agrees with Edmonds-Karp") {
+	auto rng = std::mt19937(6771);
+	auto const capacity = std::uniform_int_distribution<int>(0, 30);
+	for (auto const& [nodes, edges] : {std::pair{10, 30}, std::pair{60, 300}, std::pair{150, 2500}}) {
+		for (auto trial = 0; trial < 5; ++trial) {
+			auto const g = random_graph(rng, nodes, edges, capacity);
+			auto const source = trial;
+			auto const sink = nodes - 1 - trial;
+			auto const result = gdwg::max_flow(g, source, sink);
+			CHECK(result.value == edmonds_karp(g, source, sink));
+			check_flow(g, result, source, sink);
+		}
+	}
+}
+
+TEST_CASE("Test max_flow() on specific graphs") {
+	SECTION("Check parallel and antiparallel edges") {
+		auto g = gdwg::graph<std::string, int>{"s", "a", "t"};
+		g.insert_edge("s", "a", 3);
+		g.insert_edge("s", "a", 4);
+		g.insert_edge("a", "s", 10);
+		g.insert_edge("a", "t", 5);
+		g.insert_edge("a", "t", 1);
+		g.insert_edge("t", "a", 8);
+		g.insert_edge("a", "a", 100);
+		auto const result = gdwg::max_flow(g, std::string("s"), std::string("t"));
+		CHECK(result.value == 6);
+		check_flow(g, result, std::string("s"), std::string("t"));
+		CHECK(result.source_side == std::vector<std::string>{"a", "s"});
+	}
+
+	SECTION("Check floating-point capacities") {
+		auto g = gdwg::graph<int, double>{1, 2, 3, 4};
+		g.insert_edge(1, 2, 1.5);
+		g.insert_edge(1, 3, 2.25);
+		g.insert_edge(2, 4, 2.0);
+		g.insert_edge(3, 4, 0.75);
+		g.insert_edge(3, 2, 1.0);
+		auto const result = gdwg::max_flow(g, 1, 4);
+		CHECK(result.value == Approx(2.75));
+		check_flow(g, result, 1, 4);
+	}
+
+	SECTION("Check an unreachable sink") {
+		auto g = gdwg::graph<int, int>{1, 2, 3};
+		g.insert_edge(1, 2, 5);
+		g.insert_edge(3, 2, 5);
+		auto const result = gdwg::max_flow(g, 1, 3);
+		CHECK(result.value == 0);
+		check_flow(g, result, 1, 3);
+		CHECK(result.source_side == std::vector<int>{1, 2});
+	}
+
+	SECTION("Check a large generated graph") {
+		auto const g = gdwg::generate::rmat(14, 16);
+		auto const result = gdwg::max_flow(g, 0, 1);
+		CHECK(result.value > 0);
+		check_flow(g, result, 0, 1);
+	}
+
+	SECTION("Check exceptions") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		REQUIRE_THROWS_MATCHES(gdwg::max_flow(g, 1, 3),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::max_flow if source or sink node don't "
+		                                      "exist in the graph"));
+		REQUIRE_THROWS_MATCHES(gdwg::max_flow(g, 1, 1),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::max_flow with the same source and sink"));
+		g.insert_edge(2, 1, -1);
+		REQUIRE_THROWS_MATCHES(gdwg::max_flow(g, 1, 2),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::max_flow on a graph with negative "
+		                                      "capacities"));
+	}
+}
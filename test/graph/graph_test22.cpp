@@ -0,0 +1,223 @@
+#include "gdwg/generate.hpp"
+#include "gdwg/generator.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/lazy_traversal.hpp"
+#include "gdwg/snapshot.hpp"
+#include "gdwg/traversal.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Lazy Traversals
+
+#ifdef GDWG_HAS_COROUTINES
+
+namespace helper {
+	auto count_to(int n, int throw_at = -1) -> gdwg::generator<int> {
+		for (auto i = 0; i < n; ++i) {
+			if (i == throw_at) {
+				throw std::runtime_error("count_to");
+			}
+			co_yield i;
+		}
+	}
+
+	template<std::ranges::input_range Range>
+	auto collect(Range&& range) {
+		auto result = std::vector<std::ranges::range_value_t<Range>>();
+		for (auto&& value : range) {
+			result.push_back(value);
+		}
+		return result;
+	}
+
+	template<typename N, typename E>
+	auto recursive_dfs(gdwg::graph<N, E> const& g, N const& node, std::set<N>& seen, std::vector<N>& out)
+	   -> void {
+		seen.insert(node);
+		out.push_back(node);
+		for (auto const& next : g.connections(node)) {
+			if (not seen.contains(next)) {
+				recursive_dfs(g, next, seen, out);
+			}
+		}
+	}
+
+	auto sample_graph() -> gdwg::graph<std::string, int> {
+		auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d", "e", "f"};
+		g.insert_edge("a", "c", 1);
+		g.insert_edge("a", "b", 2);
+		g.insert_edge("a", "b", 3);
+		g.insert_edge("b", "d", 1);
+		g.insert_edge("c", "d", 1);
+		g.insert_edge("c", "a", 1);
+		g.insert_edge("d", "e", 1);
+		g.insert_edge("f", "a", 1);
+		return g;
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test generator basics") {
+	SECTION("Check values are produced on demand") {
+		CHECK(collect(count_to(5)) == std::vector<int>{0, 1, 2, 3, 4});
+		CHECK(collect(count_to(0)).empty());
+		CHECK(collect(gdwg::generator<int>()).empty());
+	}
+
+	SECTION("Check an exception thrown by the coroutine reaches the caller") {
+		auto numbers = count_to(5, 3);
+		auto it = numbers.begin();
+		CHECK(*it == 0);
+		++it;
+		++it;
+		CHECK(*it == 2);
+		CHECK_THROWS_AS(++it, std::runtime_error);
+		CHECK(it == numbers.end());
+	}
+
+	SECTION("Check generators compose with range adaptors") {
+		auto const odd = [](int i) { return i % 2 == 1; };
+		auto const square = [](int i) { return i * i; };
+		auto const values =
+		   collect(count_to(100) | std::views::filter(odd) | std::views::transform(square)
+		           | std::views::take(4));
+		CHECK(values == std::vector<int>{1, 9, 25, 49});
+	}
+
+	SECTION("Check frames are reused") {
+		static_cast<void>(collect(count_to(3)));
+		auto const before = gdwg::detail::frame_pool::fresh_allocations();
+		for (auto i = 0; i < 100; ++i) {
+			auto numbers = count_to(10);
+			CHECK(*numbers.begin() == 0);
+		}
+		CHECK(gdwg::detail::frame_pool::fresh_allocations() == before);
+	}
+}
+
+TEST_CASE("Test bfs_range() and dfs_range() on a graph") {
+	auto const g = sample_graph();
+
+	SECTION("Check breadth-first order") {
+		CHECK(collect(gdwg::bfs_range(g, std::string("a")))
+		      == std::vector<std::string>{"a", "b", "c", "d", "e"});
+		CHECK(collect(gdwg::bfs_range(g, std::string("e"))) == std::vector<std::string>{"e"});
+	}
+
+	SECTION("Check depth-first preorder") {
+		CHECK(collect(gdwg::dfs_range(g, std::string("a")))
+		      == std::vector<std::string>{"a", "b", "d", "e", "c"});
+		CHECK(collect(gdwg::dfs_range(g, std::string("f")))
+		      == std::vector<std::string>{"f", "a", "b", "d", "e", "c"});
+	}
+
+	SECTION("Check yielded nodes refer to the graph's nodes") {
+		auto nodes = gdwg::bfs_range(g, std::string("a"));
+		auto const& first = *nodes.begin();
+		CHECK(first == "a");
+		CHECK(&first == &*gdwg::dfs_range(g, std::string("a")).begin());
+	}
+
+	SECTION("Check stopping early") {
+		auto seen = std::vector<std::string>();
+		for (auto const& node : gdwg::dfs_range(g, std::string("f"))) {
+			if (node == "d") {
+				break;
+			}
+			seen.push_back(node);
+		}
+		CHECK(seen == std::vector<std::string>{"f", "a", "b"});
+	}
+
+	SECTION("Check exceptions") {
+		REQUIRE_THROWS_MATCHES(static_cast<void>(gdwg::bfs_range(g, std::string("z"))),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::bfs_range if source doesn't exist in "
+		                                      "the graph"));
+		REQUIRE_THROWS_MATCHES(static_cast<void>(gdwg::dfs_range(g, std::string("z"))),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::dfs_range if source doesn't exist in "
+		                                      "the graph"));
+	}
+}
+
+TEST_CASE("Test lazy traversals agree with eager ones") {
+	auto const g = gdwg::generate::rmat(10, 4);
+	auto const s = gdwg::snapshot<int, int>(g);
+
+	SECTION("Check bfs_range() visits nodes in order of distance") {
+		auto const distance = gdwg::bfs_distances(s, 0);
+		auto const order = collect(gdwg::bfs_range(s, 0));
+		auto const reached = std::count_if(distance.begin(), distance.end(), [](std::uint32_t d) {
+			return d != gdwg::unreachable;
+		});
+		CHECK(order.size() == static_cast<std::size_t>(reached));
+		for (auto i = std::size_t{1}; i < order.size(); ++i) {
+			CHECK(distance[order[i - 1]] <= distance[order[i]]);
+		}
+
+		// A natural snapshot's ids follow graph::nodes(), so both overloads agree
+		auto const nodes = collect(gdwg::bfs_range(g, 0));
+		REQUIRE(nodes.size() == order.size());
+		for (auto i = std::size_t{0}; i < order.size(); ++i) {
+			CHECK(s.node(order[i]) == nodes[i]);
+		}
+	}
+
+	SECTION("Check dfs_range() matches a recursive search") {
+		auto seen = std::set<int>();
+		auto expected = std::vector<int>();
+		recursive_dfs(g, 0, seen, expected);
+		CHECK(collect(gdwg::dfs_range(g, 0)) == expected);
+		auto const ids = collect(gdwg::dfs_range(s, 0));
+		REQUIRE(ids.size() == expected.size());
+		for (auto i = std::size_t{0}; i < ids.size(); ++i) {
+			CHECK(s.node(ids[i]) == expected[i]);
+		}
+	}
+
+	SECTION("Check edges_range() matches iteration") {
+		auto const edges = collect(gdwg::edges_range(g));
+		REQUIRE(edges.size() == g.num_edges());
+		auto it = g.begin();
+		for (auto const& [from, to, weight] : edges) {
+			auto const [expected_from, expected_to, expected_weight] = *it++;
+			CHECK(from == expected_from);
+			CHECK(to == expected_to);
+			CHECK(weight == expected_weight);
+		}
+	}
+
+	SECTION("Check taking the first nodes matching a predicate") {
+		auto const even = [](int node) { return node % 2 == 0; };
+		auto const first = collect(gdwg::bfs_range(g, 0) | std::views::filter(even) | std::views::take(10));
+		auto all = collect(gdwg::bfs_range(g, 0));
+		std::erase_if(all, [&](int node) { return not even(node); });
+		all.resize(std::min(all.size(), std::size_t{10}));
+		CHECK(first == all);
+	}
+
+	SECTION("Check snapshot exceptions") {
+		REQUIRE_THROWS_MATCHES(static_cast<void>(gdwg::bfs_range(s, 1u << 20)),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::bfs_range on a source that doesn't "
+		                                      "exist in the snapshot"));
+		REQUIRE_THROWS_MATCHES(static_cast<void>(gdwg::dfs_range(s, 1u << 20)),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::dfs_range on a source that doesn't "
+		                                      "exist in the snapshot"));
+	}
+}
+
+#endif // GDWG_HAS_COROUTINES
@@ -0,0 +1,161 @@
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Batched Queries
+
+namespace helper {
+	// Mostly existing nodes, clustered around a few sources, with some repeats
+	auto random_queries(std::mt19937& rng, int nodes, std::size_t count)
+	   -> std::vector<std::pair<int, int>> {
+		auto pick = std::uniform_int_distribution<int>(0, nodes - 1);
+		auto near = std::uniform_int_distribution<int>(-3, 3);
+		auto queries = std::vector<std::pair<int, int>>();
+		auto src = pick(rng);
+		for (auto i = std::size_t{0}; i < count; ++i) {
+			if (i % 16 == 0) {
+				src = pick(rng);
+			}
+			queries.emplace_back(std::clamp(src + near(rng), 0, nodes - 1), pick(rng));
+		}
+		return queries;
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test batched queries agree with single queries") {
+	auto rng = std::mt19937(6771);
+	auto const g = gdwg::generate::rmat(10, 8);
+	auto const n = static_cast<int>(g.num_nodes());
+
+	for (auto const threads : {std::size_t{1}, std::size_t{4}}) {
+		auto const queries = random_queries(rng, n, 5000);
+
+		SECTION("Check batch_is_connected() with " + std::to_string(threads) + " threads") {
+			auto out = std::make_unique<bool[]>(queries.size());
+			g.batch_is_connected(queries, std::span<bool>(out.get(), queries.size()), threads);
+			for (auto i = std::size_t{0}; i < queries.size(); ++i) {
+				CHECK(out[i] == g.is_connected(queries[i].first, queries[i].second));
+			}
+		}
+
+		SECTION("Check batch_weights() with " + std::to_string(threads) + " threads") {
+			auto offsets = std::vector<std::size_t>(queries.size() + 1);
+			auto weights = std::vector<int>();
+			g.batch_weights(queries, offsets, weights, threads);
+			CHECK(offsets.back() == weights.size());
+			for (auto i = std::size_t{0}; i < queries.size(); ++i) {
+				auto const expected = g.weights(queries[i].first, queries[i].second);
+				CHECK(std::vector<int>(weights.begin() + static_cast<std::ptrdiff_t>(offsets[i]),
+				                       weights.begin() + static_cast<std::ptrdiff_t>(offsets[i + 1]))
+				      == expected);
+			}
+		}
+
+		SECTION("Check batch_find() with " + std::to_string(threads) + " threads") {
+			auto edges = std::vector<gdwg::graph<int, int>::value_type>(g.begin(), g.end());
+			std::shuffle(edges.begin(), edges.end(), rng);
+			edges.resize(2000);
+			for (auto const& [src, dst] : queries) {
+				edges.push_back({src, dst, 3}); // Sometimes an edge, usually not
+			}
+			edges.push_back({-1, 0, 0});
+			edges.push_back({0, n, 0});
+			auto out = std::vector<gdwg::graph<int, int>::iterator>(edges.size());
+			g.batch_find(edges, out, threads);
+			for (auto i = std::size_t{0}; i < edges.size(); ++i) {
+				CHECK(out[i] == g.find(edges[i].from, edges[i].to, edges[i].weight));
+			}
+			CHECK(out.back() == g.end());
+		}
+	}
+}
+
+TEST_CASE("Test batched queries on small graphs") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+	g.insert_edge("a", "b", 3);
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "a", 2);
+	g.insert_edge("c", "c", 5);
+	auto const queries = std::vector<std::pair<std::string, std::string>>{
+	   {"c", "c"}, {"a", "b"}, {"b", "c"}, {"a", "b"}, {"b", "a"}};
+
+	SECTION("Check results are in the order of the queries") {
+		bool out[5] = {};
+		g.batch_is_connected(queries, out);
+		CHECK(out[0]);
+		CHECK(out[1]);
+		CHECK_FALSE(out[2]);
+		CHECK(out[3]);
+		CHECK(out[4]);
+
+		auto offsets = std::vector<std::size_t>(6);
+		auto weights = std::vector<int>();
+		g.batch_weights(queries, offsets, weights);
+		CHECK(offsets == std::vector<std::size_t>{0, 1, 3, 3, 5, 6});
+		CHECK(weights == std::vector<int>{5, 1, 3, 1, 3, 2});
+	}
+
+	SECTION("Check a reused weights vector keeps its storage") {
+		auto offsets = std::vector<std::size_t>(6);
+		auto weights = std::vector<int>();
+		g.batch_weights(queries, offsets, weights);
+		auto const* const storage = weights.data();
+		g.batch_weights(std::span(queries).first(2), std::span(offsets).first(3), weights);
+		CHECK(weights == std::vector<int>{5, 1, 3});
+		CHECK(weights.data() == storage);
+	}
+
+	SECTION("Check empty batches") {
+		g.batch_is_connected({}, {});
+		auto offsets = std::vector<std::size_t>(1, 7);
+		auto weights = std::vector<int>{1};
+		g.batch_weights({}, offsets, weights);
+		CHECK(offsets[0] == 0);
+		CHECK(weights.empty());
+	}
+
+	SECTION("Check exceptions") {
+		auto const missing = std::vector<std::pair<std::string, std::string>>{{"a", "b"}, {"a", "z"}};
+		bool out[2] = {};
+		REQUIRE_THROWS_MATCHES(g.batch_is_connected(missing, out),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::graph<N, E>::batch_is_connected if src "
+		                                      "or dst node don't exist in the graph"));
+		CHECK_FALSE(out[0]);
+		REQUIRE_THROWS_MATCHES(g.batch_is_connected(queries, out),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::graph<N, E>::batch_is_connected with an "
+		                                      "output of a different size to the queries"));
+
+		auto offsets = std::vector<std::size_t>(3);
+		auto weights = std::vector<int>();
+		REQUIRE_THROWS_MATCHES(g.batch_weights(missing, offsets, weights),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::graph<N, E>::batch_weights if src or "
+		                                      "dst node don't exist in the graph"));
+		REQUIRE_THROWS_MATCHES(g.batch_weights(queries, offsets, weights),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::graph<N, E>::batch_weights with offsets "
+		                                      "that aren't one longer than the queries"));
+
+		auto found = std::vector<gdwg::graph<std::string, int>::iterator>(1);
+		REQUIRE_THROWS_MATCHES(g.batch_find(std::vector<gdwg::graph<std::string, int>::value_type>{},
+		                                    found),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::graph<N, E>::batch_find with an output "
+		                                      "of a different size to the queries"));
+	}
+}
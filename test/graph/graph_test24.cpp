@@ -0,0 +1,282 @@
+#include "gdwg/graph.hpp"
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <ostream>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Move-Aware Insertion
+
+namespace helper {
+	std::atomic<std::size_t> allocations = 0; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// Number of allocations made while calling f
+	template<typename F>
+	auto count_allocations(F&& f) -> std::size_t {
+		auto const before = allocations.load();
+		std::forward<F>(f)();
+		return allocations.load() - before;
+	}
+
+	// Long enough that copies of it can't use the small string buffer
+	auto long_string(char c) -> std::string {
+		return std::string(64, c);
+	}
+
+	// Counts how often it is copied or moved
+	struct tracked {
+		int value = 0;
+		static inline auto copies = 0;
+		static inline auto moves = 0;
+
+		explicit tracked(int v)
+		: value(v) {}
+		tracked(tracked const& other)
+		: value(other.value) {
+			++copies;
+		}
+		tracked(tracked&& other) noexcept
+		: value(other.value) {
+			++moves;
+		}
+		auto operator=(tracked const&) -> tracked& = default;
+		auto operator=(tracked&&) noexcept -> tracked& = default;
+		~tracked() = default;
+
+		auto operator==(tracked const& other) const -> bool {
+			return value == other.value;
+		}
+		auto operator<(tracked const& other) const -> bool {
+			return value < other.value;
+		}
+		friend auto operator<<(std::ostream& os, tracked const& t) -> std::ostream& {
+			return os << t.value;
+		}
+	};
+} // namespace helper
+
+// Counts every allocation made through the global operator new. The whole family is replaced,
+// so that anything allocated by one form and freed by another (as Catch2 does with the nothrow
+// form) still pairs malloc with free, which keeps the sanitizers in the Debug build happy.
+namespace helper {
+	auto counted_alloc(std::size_t size) noexcept -> void* {
+		++allocations;
+		return std::malloc(size == 0 ? 1 : size);
+	}
+
+	auto counted_aligned_alloc(std::size_t size, std::align_val_t al) noexcept -> void* {
+		++allocations;
+		auto const align = static_cast<std::size_t>(al);
+		// aligned_alloc wants a size that is a non-zero multiple of the alignment
+		return std::aligned_alloc(align, size == 0 ? align : (size + align - 1) / align * align);
+	}
+
+	auto checked(void* p) -> void* {
+		if (p == nullptr) {
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+} // namespace helper
+
+auto operator new(std::size_t size) -> void* {
+	return helper::checked(helper::counted_alloc(size));
+}
+
+auto operator new[](std::size_t size) -> void* {
+	return helper::checked(helper::counted_alloc(size));
+}
+
+auto operator new(std::size_t size, std::nothrow_t const&) noexcept -> void* {
+	return helper::counted_alloc(size);
+}
+
+auto operator new[](std::size_t size, std::nothrow_t const&) noexcept -> void* {
+	return helper::counted_alloc(size);
+}
+
+auto operator new(std::size_t size, std::align_val_t al) -> void* {
+	return helper::checked(helper::counted_aligned_alloc(size, al));
+}
+
+auto operator new[](std::size_t size, std::align_val_t al) -> void* {
+	return helper::checked(helper::counted_aligned_alloc(size, al));
+}
+
+auto operator new(std::size_t size, std::align_val_t al, std::nothrow_t const&) noexcept -> void* {
+	return helper::counted_aligned_alloc(size, al);
+}
+
+auto operator new[](std::size_t size, std::align_val_t al, std::nothrow_t const&) noexcept -> void* {
+	return helper::counted_aligned_alloc(size, al);
+}
+
+auto operator delete(void* p) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::size_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p, std::size_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::nothrow_t const&) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p, std::nothrow_t const&) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::align_val_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p, std::align_val_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::size_t, std::align_val_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p, std::size_t, std::align_val_t) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept -> void {
+	std::free(p);
+}
+
+auto operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept -> void {
+	std::free(p);
+}
+
+using namespace helper;
+
+TEST_CASE("Test inserting existing nodes and edges allocates nothing") {
+	auto g = gdwg::graph<std::string, std::string>{long_string('a'), long_string('b')};
+	g.insert_edge(long_string('a'), long_string('b'), long_string('w'));
+	auto const a = long_string('a');
+	auto const b = long_string('b');
+	auto const w = long_string('w');
+
+	SECTION("Check duplicate nodes") {
+		CHECK(count_allocations([&] { CHECK_FALSE(g.insert_node(a)); }) == 0);
+		auto moved = long_string('a');
+		CHECK(count_allocations([&] { CHECK_FALSE(g.insert_node(std::move(moved))); }) == 0);
+		CHECK(moved == a); // Not moved from, since it wasn't inserted
+		CHECK(g.num_nodes() == 2);
+	}
+
+	SECTION("Check duplicate edges") {
+		CHECK(count_allocations([&] { CHECK_FALSE(g.insert_edge(a, b, w)); }) == 0);
+		auto moved = long_string('w');
+		CHECK(count_allocations([&] { CHECK_FALSE(g.insert_edge(a, b, std::move(moved))); }) == 0);
+		CHECK(moved == w);
+		CHECK(g.num_edges() == 1);
+	}
+
+	SECTION("Check new values are moved in rather than copied") {
+		auto moved = long_string('c');
+		auto const by_move = count_allocations([&] { CHECK(g.insert_node(std::move(moved))); });
+		auto const by_copy = count_allocations([&] { CHECK(g.insert_node(long_string('d'))); });
+		auto const d = long_string('e');
+		auto const copied = count_allocations([&] { CHECK(g.insert_node(d)); });
+		CHECK(by_move + 1 == copied);
+		CHECK(by_copy == copied); // long_string() itself allocates once
+		CHECK(g.is_node(long_string('c')));
+	}
+}
+
+TEST_CASE("Test emplacing an existing node") {
+	auto g = gdwg::graph<std::string, int>{long_string('a')};
+	auto const a = long_string('a');
+
+	SECTION("Check a single comparable argument is looked up before the node is built") {
+		CHECK(count_allocations([&] { CHECK_FALSE(g.emplace_node(a.c_str())); }) == 0);
+		CHECK(count_allocations([&] { CHECK_FALSE(g.emplace_node(a)); }) == 0);
+		CHECK(g.num_nodes() == 1);
+	}
+
+	SECTION("Check other arguments build the node before it is looked up") {
+		CHECK(count_allocations([&] { CHECK_FALSE(g.emplace_node(a.size(), 'a')); }) == 1);
+		CHECK(g.num_nodes() == 1);
+	}
+}
+
+TEST_CASE("Test emplace_node() and emplace_edge()") {
+	SECTION("Check values are built from their arguments") {
+		auto g = gdwg::graph<std::string, std::pair<int, int>>();
+		CHECK(g.emplace_node(std::size_t{3}, 'x'));
+		CHECK(g.emplace_node("yy"));
+		CHECK_FALSE(g.emplace_node(std::string("yy")));
+		CHECK(g.emplace_edge("xxx", "yy", 1, 2));
+		CHECK_FALSE(g.emplace_edge("xxx", "yy", 1, 2));
+		CHECK(g.emplace_edge("yy", "yy"));
+		CHECK(g.weights("xxx", "yy") == std::vector<std::pair<int, int>>{{1, 2}});
+		CHECK(g.weights("yy", "yy") == std::vector<std::pair<int, int>>{{0, 0}});
+		CHECK(g.num_edges() == 2);
+	}
+
+	SECTION("Check an emplaced value is moved into the graph once") {
+		auto g = gdwg::graph<tracked, tracked>();
+		tracked::copies = 0;
+		tracked::moves = 0;
+		CHECK(g.emplace_node(1));
+		CHECK(g.emplace_node(2));
+		CHECK(g.emplace_edge(tracked(1), tracked(2), 7));
+		CHECK(tracked::copies == 0);
+		CHECK(tracked::moves == 3);
+		CHECK_FALSE(g.emplace_edge(tracked(1), tracked(2), 7));
+		CHECK_FALSE(g.emplace_node(1));
+		CHECK(tracked::copies == 0);
+		CHECK(tracked::moves == 3);
+	}
+
+	SECTION("Check exceptions") {
+		auto g = gdwg::graph<int, int>{1};
+		REQUIRE_THROWS_MATCHES(g.emplace_edge(1, 2, 3),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::graph<N, E>::emplace_edge when either "
+		                                      "src or dst node does not exist"));
+		REQUIRE_THROWS_MATCHES(g.insert_edge(2, 1, 3),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::graph<N, E>::insert_edge when either "
+		                                      "src or dst node does not exist"));
+	}
+}
+
+TEST_CASE("Test the range constructor moves from rvalue iterators") {
+	auto values = std::vector<tracked>();
+	values.emplace_back(2);
+	values.emplace_back(1);
+	values.emplace_back(2);
+	tracked::copies = 0;
+	tracked::moves = 0;
+	auto const g = gdwg::graph<tracked, int>(std::make_move_iterator(values.begin()),
+	                                         std::make_move_iterator(values.end()));
+	CHECK(g.num_nodes() == 2);
+	CHECK(tracked::copies == 0);
+	CHECK(tracked::moves == 2);
+	CHECK(values[2].value == 2);
+
+	auto const copied = gdwg::graph<tracked, int>(values.begin(), values.end());
+	CHECK(tracked::copies == 2);
+	CHECK(copied == g);
+}
@@ -0,0 +1,108 @@
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "edge_tuples.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Bulk Erasure
+
+namespace helper {
+	// The weight index must answer exactly as a scan does
+	auto check_weight_index(gdwg::graph<int, int> const& indexed) -> void {
+		auto scanned = indexed;
+		scanned.disable_weight_index();
+		for (auto const& node : indexed.nodes()) {
+			CHECK(as_tuples(indexed.top_k_out(node, 3)) == as_tuples(scanned.top_k_out(node, 3)));
+		}
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test erase_nodes() matches erasing nodes one at a time") {
+	auto rng = std::mt19937(6771);
+	auto g = gdwg::generate::rmat(10, 8);
+	g.enable_weight_index();
+	auto pick = std::uniform_int_distribution<int>(-50, 1100); // Some aren't nodes
+	auto victims = std::vector<int>();
+	for (auto i = 0; i < 300; ++i) {
+		victims.push_back(pick(rng));
+	}
+
+	auto expected = g;
+	auto expected_count = std::size_t{0};
+	for (auto const victim : std::set<int>(victims.begin(), victims.end())) {
+		if (expected.erase_node(victim)) {
+			++expected_count;
+		}
+	}
+	CHECK(g.erase_nodes(victims) == expected_count);
+	CHECK(g == expected);
+	CHECK(g.num_nodes() == expected.num_nodes());
+	CHECK(g.num_edges() == expected.num_edges());
+	CHECK(g.hash() == expected.hash());
+	CHECK(g.hash() == gdwg::graph<int, int>(g).hash());
+	check_weight_index(g);
+
+	SECTION("Check nothing happens without nodes to erase") {
+		auto const before = g;
+		CHECK(g.erase_nodes(std::vector<int>{-1, -2}) == 0);
+		CHECK(g.erase_nodes(std::vector<int>{}) == 0);
+		CHECK(g == before);
+	}
+
+	SECTION("Check erasing every node") {
+		auto const nodes = g.nodes();
+		CHECK(g.erase_nodes(nodes) == nodes.size());
+		CHECK(g.empty());
+		CHECK(g.num_edges() == 0);
+		CHECK(g.hash() == gdwg::graph<int, int>().hash());
+	}
+}
+
+TEST_CASE("Test erase_nodes() on a small graph") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "a", 2);
+	g.insert_edge("b", "c", 3);
+	g.insert_edge("c", "c", 4);
+	g.insert_edge("d", "c", 5);
+	g.insert_edge("d", "a", 6);
+	CHECK(g.erase_nodes(std::vector<std::string>{"c", "a", "c", "z"}) == 2);
+	CHECK(g.nodes() == std::vector<std::string>{"b", "d"});
+	CHECK(g.num_edges() == 0);
+	CHECK(g.begin() == g.end());
+}
+
+TEST_CASE("Test erase_edges_if()") {
+	auto g = gdwg::generate::rmat(10, 8);
+	g.enable_weight_index();
+	auto const heavy_or_loop = [](int from, int to, int weight) {
+		return from == to or weight > 50;
+	};
+	auto const expected = g.filter([&](int from, int to, int weight) {
+		return not heavy_or_loop(from, to, weight);
+	});
+	auto const before = g.num_edges();
+	CHECK(g.erase_edges_if(heavy_or_loop) == before - expected.num_edges());
+	CHECK(g == expected);
+	CHECK(g.num_edges() == expected.num_edges());
+	CHECK(g.hash() == expected.hash());
+	check_weight_index(g);
+	CHECK(g.erase_edges_if(heavy_or_loop) == 0);
+
+	SECTION("Check every edge can be erased, keeping the nodes") {
+		auto const nodes = g.num_nodes();
+		CHECK(g.erase_edges_if([](int, int, int) { return true; }) == expected.num_edges());
+		CHECK(g.num_edges() == 0);
+		CHECK(g.num_nodes() == nodes);
+	}
+}
@@ -0,0 +1,125 @@
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "edge_tuples.hpp"
+
+#include <catch2/catch.hpp>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Relabelling
+
+namespace helper {
+	// The graph with every node and edge mapped through f, merging as the edge sets do
+	template<typename N, typename E, typename F>
+	auto mapped(gdwg::graph<N, E> const& g, F f) -> gdwg::graph<N, E> {
+		auto result = gdwg::graph<N, E>();
+		for (auto const& node : g.nodes()) {
+			result.insert_node(f(node));
+		}
+		for (auto const& [from, to, weight] : g) {
+			result.insert_edge(f(from), f(to), weight);
+		}
+		return result;
+	}
+
+	auto check_bookkeeping(gdwg::graph<int, int> const& g, gdwg::graph<int, int> const& expected)
+	   -> void {
+		CHECK(g == expected);
+		CHECK(g.num_nodes() == expected.num_nodes());
+		CHECK(g.num_edges() == expected.num_edges());
+		CHECK(g.hash() == expected.hash());
+		if (g.has_weight_index()) {
+			auto scanned = g;
+			scanned.disable_weight_index();
+			for (auto const& node : g.nodes()) {
+				CHECK(as_tuples(g.top_k_out(node, 4)) == as_tuples(scanned.top_k_out(node, 4)));
+			}
+		}
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test relabel() with a function") {
+	auto g = gdwg::generate::rmat(9, 8);
+	g.enable_weight_index();
+
+	SECTION("Check a one-to-one relabelling") {
+		auto const shift = [](int x) { return 1000 - x; };
+		auto const expected = mapped(g, shift);
+		g.relabel(shift);
+		check_bookkeeping(g, expected);
+	}
+
+	SECTION("Check nodes with the same label are merged") {
+		auto const collapse = [](int x) { return x / 7; };
+		auto const expected = mapped(g, collapse);
+		g.relabel(collapse);
+		check_bookkeeping(g, expected);
+		CHECK(g.num_nodes() == 74); // 512 nodes in groups of 7
+	}
+
+	SECTION("Check the identity changes nothing") {
+		auto const expected = g;
+		g.relabel([](int x) { return x; });
+		check_bookkeeping(g, expected);
+	}
+
+	SECTION("Check a throwing mapping leaves the graph unchanged") {
+		auto const expected = g;
+		CHECK_THROWS_AS(g.relabel([](int x) {
+			if (x == 300) {
+				throw std::runtime_error("unmapped");
+			}
+			return x + 1;
+		}),
+		                std::runtime_error);
+		check_bookkeeping(g, expected);
+	}
+}
+
+TEST_CASE("Test relabel() with a map") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "a", 2);
+	g.insert_edge("b", "c", 3);
+	g.insert_edge("c", "d", 3);
+	g.insert_edge("d", "d", 4);
+
+	SECTION("Check labels are swapped at once") {
+		g.relabel(std::map<std::string, std::string>{{"a", "b"}, {"b", "a"}, {"z", "y"}});
+		auto expected = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		expected.insert_edge("b", "a", 1);
+		expected.insert_edge("a", "b", 2);
+		expected.insert_edge("a", "c", 3);
+		expected.insert_edge("c", "d", 3);
+		expected.insert_edge("d", "d", 4);
+		CHECK(g == expected);
+		CHECK(g.hash() == expected.hash());
+	}
+
+	SECTION("Check merged nodes keep every edge once") {
+		g.relabel(std::unordered_map<std::string, std::string>{{"c", "b"}, {"d", "e"}});
+		auto expected = gdwg::graph<std::string, int>{"a", "b", "e"};
+		expected.insert_edge("a", "b", 1);
+		expected.insert_edge("b", "a", 2);
+		expected.insert_edge("b", "b", 3);
+		expected.insert_edge("b", "e", 3);
+		expected.insert_edge("e", "e", 4);
+		CHECK(g == expected);
+		CHECK(g.num_edges() == 5);
+		CHECK(g.hash() == expected.hash());
+	}
+
+	SECTION("Check an empty graph") {
+		auto empty = gdwg::graph<std::string, int>();
+		empty.relabel(std::map<std::string, std::string>{{"a", "b"}});
+		CHECK(empty.empty());
+	}
+}
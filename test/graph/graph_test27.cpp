@@ -0,0 +1,353 @@
+#include "gdwg/detail/crc32.hpp"
+#include "gdwg/durable_graph.hpp"
+#include "gdwg/graph.hpp"
+#include "scratch_directory.hpp"
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Durable Graphs
+
+namespace helper {
+	using durable = gdwg::durable_graph<int, int>;
+
+	template<typename N, typename E>
+	auto copy_of(gdwg::durable_graph<N, E> const& g) -> gdwg::graph<N, E> {
+		return g.read([](gdwg::graph<N, E> const& inner) { return inner; });
+	}
+
+	auto files(std::filesystem::path const& directory, std::string const& prefix)
+	   -> std::vector<std::filesystem::path> {
+		auto result = std::vector<std::filesystem::path>();
+		for (auto const& entry : std::filesystem::directory_iterator(directory)) {
+			if (entry.path().filename().string().starts_with(prefix)) {
+				result.push_back(entry.path());
+			}
+		}
+		return result;
+	}
+
+	// Applies the same random mutations to a durable graph and to a plain graph
+	auto mutate_randomly(durable& g, gdwg::graph<int, int>& expected, int count, unsigned seed)
+	   -> void {
+		auto rng = std::mt19937(seed);
+		auto node = std::uniform_int_distribution<int>(0, 40);
+		auto kind = std::uniform_int_distribution<int>(0, 9);
+		for (auto i = 0; i < count; ++i) {
+			auto const a = node(rng);
+			auto const b = node(rng);
+			auto const w = node(rng) % 4;
+			switch (kind(rng)) {
+			case 0:
+			case 1:
+			case 2: CHECK(g.insert_node(a) == expected.insert_node(a)); break;
+			case 3:
+			case 4:
+			case 5:
+				if (expected.is_node(a) and expected.is_node(b)) {
+					CHECK(g.insert_edge(a, b, w) == expected.insert_edge(a, b, w));
+				}
+				break;
+			case 6:
+				if (expected.is_node(a) and expected.is_node(b)) {
+					CHECK(g.erase_edge(a, b, w) == expected.erase_edge(a, b, w));
+				}
+				break;
+			case 7: CHECK(g.erase_node(a) == expected.erase_node(a)); break;
+			case 8:
+				if (expected.is_node(a)) {
+					CHECK(g.replace_node(a, b) == expected.replace_node(a, b));
+				}
+				break;
+			default:
+				if (expected.is_node(a) and expected.is_node(b)) {
+					g.merge_replace_node(a, b);
+					expected.merge_replace_node(a, b);
+				}
+			}
+		}
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test crc32()") {
+	CHECK(gdwg::detail::crc32("") == 0);
+	CHECK(gdwg::detail::crc32("123456789") == 0xcbf43926U);
+	CHECK(gdwg::detail::crc32("56789", gdwg::detail::crc32("1234")) == 0xcbf43926U);
+}
+
+TEST_CASE("Test durable_graph recovers every mutation") {
+	auto const directory = scratch_directory("gdwg-graph-test27", "recover");
+	auto expected = gdwg::graph<int, int>();
+
+	SECTION("Check recovery from the log alone") {
+		{
+			auto g = gdwg::durable_graph<int, int>(directory.path());
+			mutate_randomly(g, expected, 2000, 1);
+			CHECK(copy_of(g) == expected);
+			CHECK(g.stats().mutations > 0);
+		}
+		auto const g = gdwg::durable_graph<int, int>(directory.path());
+		CHECK(copy_of(g) == expected);
+	}
+
+	SECTION("Check recovery across several openings") {
+		for (auto round = 0U; round < 4; ++round) {
+			auto g = gdwg::durable_graph<int, int>(directory.path());
+			CHECK(copy_of(g) == expected);
+			mutate_randomly(g, expected, 300, round);
+		}
+		auto const g = gdwg::durable_graph<int, int>(directory.path());
+		CHECK(copy_of(g) == expected);
+	}
+
+	SECTION("Check clear() and failed mutations") {
+		{
+			auto g = gdwg::durable_graph<int, int>(directory.path());
+			g.insert_node(1);
+			g.insert_node(2);
+			g.insert_edge(1, 2, 3);
+			g.clear();
+			g.insert_node(4);
+			CHECK_THROWS_AS(g.insert_edge(4, 5, 1), std::runtime_error);
+			CHECK_FALSE(g.insert_node(4));
+			CHECK(g.stats().mutations == 5);
+		}
+		auto const g = gdwg::durable_graph<int, int>(directory.path());
+		CHECK(copy_of(g) == gdwg::graph<int, int>{4});
+	}
+
+	SECTION("Check strings as nodes and weights") {
+		{
+			auto g = gdwg::durable_graph<std::string, std::string>(directory.path(), {.sync = false});
+			g.insert_node("are");
+			g.insert_node("you");
+			g.insert_node("");
+			g.insert_edge("are", "you", "there?");
+			g.insert_edge("you", "", std::string(5000, 'x'));
+			g.replace_node("are", "is");
+		}
+		auto const g = gdwg::durable_graph<std::string, std::string>(directory.path());
+		auto copy = gdwg::graph<std::string, std::string>{"is", "you", ""};
+		copy.insert_edge("is", "you", "there?");
+		copy.insert_edge("you", "", std::string(5000, 'x'));
+		CHECK(copy_of(g) == copy);
+	}
+}
+
+TEST_CASE("Test durable_graph ignores a torn log") {
+	auto const directory = scratch_directory("gdwg-graph-test27", "torn");
+	{
+		auto g = gdwg::durable_graph<int, int>(directory.path());
+		g.insert_node(1);
+		g.insert_node(2);
+		g.insert_edge(1, 2, 7);
+		g.insert_edge(2, 1, 8);
+	}
+	auto const segments = files(directory.path(), "wal-");
+	REQUIRE(segments.size() == 1);
+	auto const segment = segments.front();
+	auto const size = std::filesystem::file_size(segment);
+	auto without_last = gdwg::graph<int, int>{1, 2};
+	without_last.insert_edge(1, 2, 7);
+
+	SECTION("Check a record cut short") {
+		std::filesystem::resize_file(segment, size - 3);
+		auto const g = gdwg::durable_graph<int, int>(directory.path());
+		CHECK(copy_of(g) == without_last);
+	}
+
+	SECTION("Check a record that fails its checksum") {
+		{
+			auto file = std::fstream(segment, std::ios::binary | std::ios::in | std::ios::out);
+			file.seekp(static_cast<std::streamoff>(size - 1));
+			file.put('\x7f');
+		}
+		auto const g = gdwg::durable_graph<int, int>(directory.path());
+		CHECK(copy_of(g) == without_last);
+	}
+
+	SECTION("Check garbage after the last record") {
+		{
+			auto file = std::ofstream(segment, std::ios::binary | std::ios::app);
+			file << "garbage";
+		}
+		auto g = gdwg::durable_graph<int, int>(directory.path());
+		auto all = without_last;
+		all.insert_edge(2, 1, 8);
+		CHECK(copy_of(g) == all);
+
+		// Later records go to a new segment, not after the garbage
+		g.insert_node(3);
+		all.insert_node(3);
+		CHECK(files(directory.path(), "wal-").size() == 2);
+		g.flush();
+		auto const reopened = gdwg::durable_graph<int, int>(directory.path());
+		CHECK(copy_of(reopened) == all);
+	}
+}
+
+TEST_CASE("Test durable_graph checkpoints") {
+	auto const directory = scratch_directory("gdwg-graph-test27", "checkpoint");
+	auto expected = gdwg::graph<int, int>();
+
+	SECTION("Check an explicit checkpoint replaces the log") {
+		{
+			auto g = gdwg::durable_graph<int, int>(directory.path());
+			mutate_randomly(g, expected, 1000, 2);
+			g.checkpoint();
+			CHECK(g.stats().checkpoints == 1);
+			CHECK(g.stats().log_bytes == 0);
+			CHECK(files(directory.path(), "checkpoint-").size() == 1);
+			CHECK(files(directory.path(), "wal-").size() == 1);
+			mutate_randomly(g, expected, 1000, 3);
+		}
+		auto const g = gdwg::durable_graph<int, int>(directory.path());
+		CHECK(copy_of(g) == expected);
+	}
+
+	SECTION("Check background checkpoints while writing") {
+		{
+			auto g = gdwg::durable_graph<int, int>(directory.path(),
+			                                       {.sync = false, .checkpoint_bytes = 2000});
+			for (auto seed = 10U; seed < 20; ++seed) {
+				mutate_randomly(g, expected, 500, seed);
+			}
+			g.checkpoint();
+			CHECK(g.stats().checkpoints >= 2);
+			mutate_randomly(g, expected, 500, 20);
+		}
+		CHECK(files(directory.path(), "checkpoint-").size() == 1);
+		auto const g = gdwg::durable_graph<int, int>(directory.path());
+		CHECK(copy_of(g) == expected);
+	}
+
+	SECTION("Check an interrupted checkpoint is discarded") {
+		{
+			auto g = gdwg::durable_graph<int, int>(directory.path());
+			mutate_randomly(g, expected, 500, 4);
+			g.checkpoint();
+			mutate_randomly(g, expected, 500, 5);
+		}
+		{
+			auto file = std::ofstream(directory.path() / "checkpoint-9.tmp", std::ios::binary);
+			file << "partial";
+		}
+		auto const g = gdwg::durable_graph<int, int>(directory.path());
+		CHECK(copy_of(g) == expected);
+		CHECK_FALSE(std::filesystem::exists(directory.path() / "checkpoint-9.tmp"));
+	}
+
+	SECTION("Check exceptions") {
+		{
+			auto g = gdwg::durable_graph<int, int>(directory.path());
+			g.insert_node(1);
+			g.checkpoint();
+		}
+		auto const checkpoint = files(directory.path(), "checkpoint-").front();
+		std::filesystem::resize_file(checkpoint, std::filesystem::file_size(checkpoint) - 1);
+		REQUIRE_THROWS_MATCHES(durable(directory.path()),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::durable_graph<N, E>::durable_graph on "
+		                                      "a directory that doesn't hold a valid checkpoint"));
+
+		auto const file = directory.path() / "file";
+		std::ofstream(file) << "not a directory";
+		REQUIRE_THROWS_MATCHES(durable(file / "graph"),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::durable_graph<N, E>::durable_graph on "
+		                                      "a directory that can't be written"));
+	}
+}
+
+TEST_CASE("Test durable_graph group commit") {
+	auto const directory = scratch_directory("gdwg-graph-test27", "group");
+	auto constexpr threads = 8;
+	auto constexpr per_thread = 200;
+
+	SECTION("Check concurrent writers") {
+		{
+			auto g = gdwg::durable_graph<int, int>(directory.path());
+			auto workers = std::vector<std::thread>();
+			for (auto t = 0; t < threads; ++t) {
+				workers.emplace_back([&g, t] {
+					for (auto i = 0; i < per_thread; ++i) {
+						g.insert_node(t * per_thread + i);
+					}
+				});
+			}
+			for (auto& worker : workers) {
+				worker.join();
+			}
+			auto const stats = g.stats();
+			CHECK(stats.mutations == threads * per_thread);
+			CHECK(stats.syncs < stats.mutations); // Writers waiting on one sync share the next
+			CHECK(g.read([](auto const& inner) { return inner.nodes().size(); })
+			      == std::size_t{threads * per_thread});
+		}
+		auto const g = gdwg::durable_graph<int, int>(directory.path());
+		CHECK(g.read([](auto const& inner) { return inner.nodes().size(); })
+		      == std::size_t{threads * per_thread});
+	}
+
+	SECTION("Check checkpoints finish while writers never pause") {
+		auto expected = gdwg::graph<int, int>();
+		{
+			auto g = gdwg::durable_graph<int, int>(directory.path());
+			auto stop = std::atomic<bool>(false);
+			auto workers = std::vector<std::thread>();
+			for (auto t = 0; t < threads; ++t) {
+				workers.emplace_back([&g, &stop, t] {
+					for (auto i = 0; not stop; ++i) {
+						g.insert_node(t + threads * i);
+					}
+				});
+			}
+			for (auto i = 0; i < 3; ++i) {
+				g.checkpoint();
+			}
+			stop = true;
+			for (auto& worker : workers) {
+				worker.join();
+			}
+			CHECK(g.stats().checkpoints == 3);
+			expected = copy_of(g);
+		}
+		auto const g = gdwg::durable_graph<int, int>(directory.path());
+		CHECK(copy_of(g) == expected);
+	}
+
+	SECTION("Check buffered mutations share one sync") {
+		auto g = gdwg::durable_graph<int, int>(directory.path(), {.sync = false});
+		for (auto i = 0; i < 1000; ++i) {
+			g.insert_node(i);
+		}
+		CHECK(g.stats().syncs == 0);
+		g.flush();
+		CHECK(g.stats().syncs == 1);
+		g.flush();
+		CHECK(g.stats().syncs == 1);
+	}
+
+	SECTION("Check a full buffer is written without a flush") {
+		auto g = gdwg::durable_graph<int, int>(directory.path(),
+		                                       {.sync = false, .max_buffered_bytes = 1000});
+		for (auto i = 0; i < 1000; ++i) {
+			g.insert_node(i);
+		}
+		CHECK(g.stats().syncs > 0);
+		CHECK(g.stats().syncs < 100);
+	}
+}
@@ -0,0 +1,230 @@
+#include "gdwg/external_graph.hpp"
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+#include "gdwg/traversal.hpp"
+#include "scratch_directory.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Rationale: test/README.md
+
+// External Graphs
+
+namespace helper {
+	using external = gdwg::external_graph<int, int>;
+
+	// Every accessor of the external graph must agree with the graph it was written from
+	template<typename N, typename E>
+	auto check_same(gdwg::graph<N, E> const& g, gdwg::external_graph<N, E> const& x) -> void {
+		REQUIRE(x.num_nodes() == g.num_nodes());
+		REQUIRE(x.num_edges() == g.num_edges());
+		CHECK(x.nodes() == g.nodes());
+		auto it = x.begin();
+		for (auto const& [from, to, weight] : g) {
+			REQUIRE(it != x.end());
+			auto const [x_from, x_to, x_weight] = *it++;
+			CHECK(x_from == from);
+			CHECK(x_to == to);
+			CHECK(x_weight == weight);
+		}
+		CHECK(it == x.end());
+		for (auto const& node : g.nodes()) {
+			CHECK(x.is_node(node));
+			CHECK(x.connections(node) == g.connections(node));
+		}
+	}
+
+	auto sample_graph() -> gdwg::graph<std::string, double> {
+		auto g = gdwg::graph<std::string, double>{"a", "b", "c", "d", "e"};
+		g.insert_edge("a", "b", 1.5);
+		g.insert_edge("a", "b", 0.5);
+		g.insert_edge("a", "c", 2.0);
+		g.insert_edge("a", "a", 3.0);
+		g.insert_edge("c", "e", 1.0);
+		g.insert_edge("e", "a", 4.0);
+		return g;
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test external_graph keeps the read API of graph") {
+	auto const directory = scratch_directory("gdwg-graph-test28", "api");
+	auto const g = sample_graph();
+
+	SECTION("Check one segment") {
+		auto const x = gdwg::external_graph<std::string, double>::write(g, directory.path());
+		CHECK(x.num_segments() == 1);
+		check_same(g, x);
+	}
+
+	SECTION("Check one segment per node") {
+		auto const x =
+		   gdwg::external_graph<std::string, double>::write(g, directory.path(), {.segment_bytes = 1});
+		CHECK(x.num_segments() == 3); // "b" and "d" have no edges, so share a segment with the next node
+		check_same(g, x);
+	}
+
+	SECTION("Check queries") {
+		auto const x =
+		   gdwg::external_graph<std::string, double>::write(g, directory.path(), {.segment_bytes = 1});
+		CHECK(x.is_connected("a", "a"));
+		CHECK(x.is_connected("e", "a"));
+		CHECK_FALSE(x.is_connected("b", "a"));
+		CHECK_FALSE(x.is_node("f"));
+		CHECK(x.weights("a", "b") == std::vector<double>{0.5, 1.5});
+		CHECK(x.weights("d", "a").empty());
+		CHECK(x.connections("a") == std::vector<std::string>{"a", "b", "c"});
+		CHECK(x.out_degree(*x.id("a")) == 4);
+		CHECK(x.node(*x.id("c")) == "c");
+		CHECK_FALSE(x.id("f").has_value());
+	}
+
+	SECTION("Check reopening") {
+		static_cast<void>(gdwg::external_graph<std::string, double>::write(g, directory.path()));
+		auto const x = gdwg::external_graph<std::string, double>(directory.path());
+		check_same(g, x);
+	}
+
+	SECTION("Check an empty graph") {
+		auto const x = gdwg::external_graph<int, int>::write(gdwg::graph<int, int>(), directory.path());
+		CHECK(x.empty());
+		CHECK(x.num_edges() == 0);
+		CHECK(x.begin() == x.end());
+		CHECK(gdwg::pagerank(x).empty());
+	}
+
+	SECTION("Check exceptions") {
+		auto const x = gdwg::external_graph<std::string, double>::write(g, directory.path());
+		REQUIRE_THROWS_MATCHES(x.is_connected("a", "f"),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::external_graph<N, E>::is_connected if "
+		                                      "src or dst node don't exist in the graph"));
+		REQUIRE_THROWS_MATCHES(x.weights("f", "a"),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::external_graph<N, E>::weights if src or "
+		                                      "dst node don't exist in the graph"));
+		REQUIRE_THROWS_MATCHES(x.connections("f"),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::external_graph<N, E>::connections if "
+		                                      "src doesn't exist in the graph"));
+		REQUIRE_THROWS_MATCHES(gdwg::bfs_distances(x, 5),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::bfs_distances on a source that doesn't "
+		                                      "exist in the external graph"));
+	}
+}
+
+TEST_CASE("Test external_graph_writer") {
+	auto const directory = scratch_directory("gdwg-graph-test28", "writer");
+	auto writer = gdwg::external_graph_writer<int, int>(directory.path(), {3, 1, 2, 1});
+
+	SECTION("Check edges written one at a time") {
+		CHECK(writer.insert_edge(1, 2, 5));
+		CHECK(writer.insert_edge(1, 3, 1));
+		CHECK_FALSE(writer.insert_edge(1, 3, 1));
+		CHECK(writer.insert_edge(1, 3, 2));
+		CHECK(writer.insert_edge(3, 3, 0));
+		writer.finish();
+		auto const x = gdwg::external_graph<int, int>(directory.path());
+		auto expected = gdwg::graph<int, int>{1, 2, 3};
+		expected.insert_edge(1, 2, 5);
+		expected.insert_edge(1, 3, 1);
+		expected.insert_edge(1, 3, 2);
+		expected.insert_edge(3, 3, 0);
+		check_same(expected, x);
+	}
+
+	SECTION("Check exceptions") {
+		writer.insert_edge(2, 3, 1);
+		REQUIRE_THROWS_MATCHES(writer.insert_edge(1, 3, 1),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::external_graph_writer<N, E>::insert_edge "
+		                                      "with edges out of order"));
+		REQUIRE_THROWS_MATCHES(writer.insert_edge(2, 3, 0),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::external_graph_writer<N, E>::insert_edge "
+		                                      "with edges out of order"));
+		REQUIRE_THROWS_MATCHES(writer.insert_edge(2, 4, 1),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::external_graph_writer<N, E>::insert_edge "
+		                                      "when either src or dst node does not exist"));
+		REQUIRE_THROWS_MATCHES(external(directory.path()),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::external_graph<N, E>::external_graph on "
+		                                      "a directory that doesn't hold a valid external graph"));
+		writer.finish();
+		REQUIRE_THROWS_MATCHES(writer.insert_edge(3, 3, 1),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::external_graph_writer<N, E>::insert_edge "
+		                                      "after finish()"));
+		std::filesystem::remove(directory.path() / "segment-0");
+		REQUIRE_THROWS_MATCHES(external(directory.path()),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::external_graph<N, E>::external_graph on "
+		                                      "a directory that doesn't hold a valid external graph"));
+	}
+}
+
+TEST_CASE("Test streaming algorithms agree with snapshots") {
+	auto const directory = scratch_directory("gdwg-graph-test28", "stream");
+	auto const g = gdwg::generate::rmat(12, 8);
+	auto const s = gdwg::snapshot<int, int>(g);
+	auto const x = gdwg::external_graph<int, int>::write(g, directory.path(), {.segment_bytes = 4096});
+	REQUIRE(x.num_segments() > 10);
+	check_same(g, x);
+
+	SECTION("Check neighbours and weights match the snapshot") {
+		for (auto u = std::uint32_t{0}; u < s.num_nodes(); ++u) {
+			auto const expected = s.neighbours(u);
+			auto const actual = x.neighbours(u);
+			REQUIRE(actual.size() == expected.size());
+			CHECK(std::equal(actual.begin(), actual.end(), expected.begin()));
+			auto const weights = x.weights(u);
+			CHECK(std::equal(weights.begin(), weights.end(), s.weights(u).begin()));
+		}
+	}
+
+	SECTION("Check bfs_distances()") {
+		for (auto const source : {0U, 1U, 100U, 4000U}) {
+			CHECK(gdwg::bfs_distances(x, source) == gdwg::bfs_distances(s, source));
+		}
+	}
+
+	SECTION("Check pagerank()") {
+		auto const expected = gdwg::pagerank(s, 15, 0.85, 1);
+		auto const actual = gdwg::pagerank(x, 15, 0.85);
+		REQUIRE(actual.size() == expected.size());
+		for (auto i = std::size_t{0}; i < actual.size(); ++i) {
+			CHECK(actual[i] == Approx(expected[i]).epsilon(1e-9));
+		}
+	}
+
+	SECTION("Check read-ahead hints leave the neighbours alone") {
+		for (auto k = std::size_t{0}; k < x.num_segments(); ++k) {
+			auto const [first, last] = x.segment_nodes(k);
+			x.prefetch_neighbours(first, last);
+			x.release_neighbours(first, (first + last) / 2);
+			x.release_neighbours(last, last);
+		}
+		for (auto u = std::uint32_t{0}; u < s.num_nodes(); ++u) {
+			auto const actual = x.neighbours(u);
+			REQUIRE(actual.size() == s.neighbours(u).size());
+			CHECK(std::equal(actual.begin(), actual.end(), s.neighbours(u).begin()));
+			CHECK(x.edge_offset(u + 1) - x.edge_offset(u) == x.out_degree(u));
+		}
+		CHECK(x.edge_offset(static_cast<std::uint32_t>(x.num_nodes())) == x.num_edges());
+	}
+
+	SECTION("Check the index is small") {
+		CHECK(x.index_bytes() < 16 * x.num_nodes() + 64 * x.num_segments());
+	}
+}
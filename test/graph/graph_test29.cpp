@@ -0,0 +1,201 @@
+#include "gdwg/generate.hpp"
+#include "gdwg/graph.hpp"
+#include "gdwg/partition.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Graph Partitioning
+
+namespace helper {
+	// Every field of the result must agree with the parts
+	template<typename N, typename E>
+	auto check_result(gdwg::snapshot<N, E> const& s,
+	                  std::size_t k,
+	                  gdwg::partition_result const& p,
+	                  double imbalance) -> void {
+		auto const n = s.num_nodes();
+		REQUIRE(p.parts.size() == n);
+		REQUIRE(p.part_sizes.size() == k);
+		auto sizes = std::vector<std::size_t>(k, 0);
+		for (auto const part : p.parts) {
+			REQUIRE(part < k);
+			++sizes[part];
+		}
+		CHECK(sizes == p.part_sizes);
+		auto cut = std::size_t{0};
+		for (auto u = std::uint32_t{0}; u < n; ++u) {
+			for (auto const v : s.neighbours(u)) {
+				cut += p.parts[u] != p.parts[v] ? 1U : 0U;
+			}
+		}
+		CHECK(cut == p.edge_cut);
+		auto const limit = std::floor((1.0 + imbalance) * static_cast<double>((n + k - 1) / k));
+		auto const largest = *std::max_element(sizes.begin(), sizes.end());
+		CHECK(static_cast<double>(largest) <= limit);
+		CHECK(p.balance == Approx(static_cast<double>(largest * k) / static_cast<double>(n)));
+	}
+
+	// Node i in part i % k
+	template<typename N, typename E>
+	auto round_robin_cut(gdwg::snapshot<N, E> const& s, std::size_t k) -> std::size_t {
+		auto cut = std::size_t{0};
+		for (auto u = std::uint32_t{0}; u < s.num_nodes(); ++u) {
+			for (auto const v : s.neighbours(u)) {
+				cut += u % k != v % k ? 1U : 0U;
+			}
+		}
+		return cut;
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test partition() on generated graphs") {
+	SECTION("Check a grid splits into compact regions") {
+		auto const g = gdwg::generate::grid2d(64, 64);
+		auto const s = gdwg::snapshot(g);
+		for (auto const k : {2UL, 4UL, 16UL}) {
+			auto const p = gdwg::partition(s, k);
+			check_result(s, k, p, 0.03);
+			// Straight cuts between k strips cost 2 (k - 1) 64 edges; anything near that is compact
+			CHECK(p.edge_cut < 4 * (k - 1) * 64);
+		}
+	}
+
+	SECTION("Check a power-law graph beats a round-robin split") {
+		auto const g = gdwg::generate::rmat(12, 8);
+		auto const s = gdwg::snapshot(g);
+		auto const p = gdwg::partition(s, 8);
+		check_result(s, 8, p, 0.03);
+		CHECK(p.edge_cut < round_robin_cut(s, 8));
+	}
+
+	SECTION("Check the imbalance option") {
+		auto const g = gdwg::generate::grid2d(40, 25);
+		auto const s = gdwg::snapshot(g);
+		check_result(s, 3, gdwg::partition(s, 3, {.imbalance = 0.0}), 0.0);
+		check_result(s, 3, gdwg::partition(s, 3, {.imbalance = 0.5}), 0.5);
+	}
+
+	SECTION("Check the result doesn't depend on the number of threads") {
+		auto const g = gdwg::generate::rmat(11, 8);
+		auto const s = gdwg::snapshot(g);
+		auto const single = gdwg::partition(s, 4, {.threads = 1});
+		auto const many = gdwg::partition(s, 4, {.threads = 4});
+		CHECK(single.parts == many.parts);
+		CHECK(single.edge_cut == many.edge_cut);
+		CHECK(gdwg::partition(s, 4, {.seed = 1}).parts == gdwg::partition(s, 4, {.seed = 1}).parts);
+	}
+}
+
+TEST_CASE("Test partition() on small graphs") {
+	SECTION("Check two cliques joined by one edge") {
+		auto g = gdwg::graph<int, int>{1, 2, 3, 4, 5, 6};
+		for (auto const& clique : {std::vector<int>{1, 2, 3}, std::vector<int>{4, 5, 6}}) {
+			for (auto const u : clique) {
+				for (auto const v : clique) {
+					g.insert_edge(u, v, 0); // Self-loops are never cut
+				}
+			}
+		}
+		g.insert_edge(3, 4, 0);
+		auto const p = gdwg::partition(g, 2);
+		check_result(gdwg::snapshot(g), 2, p, 0.03);
+		CHECK(p.edge_cut == 1);
+		CHECK(p.balance == Approx(1.0));
+		CHECK(p.parts[0] == p.parts[2]);
+		CHECK(p.parts[3] == p.parts[5]);
+	}
+
+	SECTION("Check parallel edges are each cut") {
+		auto g = gdwg::graph<int, int>{1, 2};
+		g.insert_edge(1, 2, 1);
+		g.insert_edge(1, 2, 2);
+		g.insert_edge(2, 1, 3);
+		auto const p = gdwg::partition(g, 2);
+		CHECK(p.parts[0] != p.parts[1]);
+		CHECK(p.edge_cut == 3);
+	}
+
+	SECTION("Check more parts than nodes") {
+		auto const g = gdwg::graph<int, int>{1, 2, 3};
+		auto const p = gdwg::partition(g, 5);
+		check_result(gdwg::snapshot(g), 5, p, 0.03);
+		CHECK(p.balance == Approx(5.0 / 3.0));
+	}
+
+	SECTION("Check an empty graph") {
+		auto const p = gdwg::partition(gdwg::graph<int, int>(), 4);
+		CHECK(p.parts.empty());
+		CHECK(p.part_sizes == std::vector<std::size_t>(4, 0));
+		CHECK(p.edge_cut == 0);
+	}
+
+	SECTION("Check exceptions") {
+		auto const g = gdwg::graph<int, int>{1, 2, 3};
+		REQUIRE_THROWS_MATCHES(gdwg::partition(g, 0),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::partition with 0 parts"));
+		auto const p = gdwg::partition(g, 2);
+		REQUIRE_THROWS_MATCHES(gdwg::shards(gdwg::graph<int, int>{1, 2}, p),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::shards with a partition of another "
+		                                      "graph"));
+	}
+}
+
+TEST_CASE("Test shards()") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "c", 2);
+	g.insert_edge("c", "c", 3);
+	g.insert_edge("c", "d", 4);
+	g.insert_edge("d", "a", 5);
+	// "a" and "b" in part 0, "c" and "d" in part 1
+	auto const p = gdwg::partition_result{{0, 0, 1, 1}, {2, 2}, 2, 1.0};
+	auto const result = gdwg::shards(g, p);
+	REQUIRE(result.size() == 2);
+
+	SECTION("Check the ghosts") {
+		CHECK(result[0].ghosts == std::vector<std::string>{"c", "d"});
+		CHECK(result[1].ghosts == std::vector<std::string>{"a", "b"});
+	}
+
+	SECTION("Check the subgraphs") {
+		auto expected = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		expected.insert_edge("a", "b", 1);
+		expected.insert_edge("b", "c", 2);
+		expected.insert_edge("d", "a", 5);
+		CHECK(result[0].subgraph == expected);
+		expected = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		expected.insert_edge("b", "c", 2);
+		expected.insert_edge("c", "c", 3);
+		expected.insert_edge("c", "d", 4);
+		expected.insert_edge("d", "a", 5);
+		CHECK(result[1].subgraph == expected);
+	}
+
+	SECTION("Check every edge is in the shard of each of its ends") {
+		auto const big = gdwg::generate::rmat(10, 4);
+		auto const q = gdwg::partition(big, 4);
+		auto const pieces = gdwg::shards(big, q);
+		auto total = std::size_t{0};
+		for (auto const& piece : pieces) {
+			total += piece.subgraph.num_edges();
+			for (auto const& ghost : piece.ghosts) {
+				CHECK(piece.subgraph.is_node(ghost));
+			}
+		}
+		CHECK(total == big.num_edges() + q.edge_cut);
+	}
+}
@@ -21,6 +21,97 @@ TEST_CASE("Test empty() identifies empty graphs") {
 	CHECK(empty.empty());
 }
 
+TEST_CASE("Test num_nodes() and num_edges() count the graph's contents") {
+	auto g = gdwg::graph<char, int>{'A', 'B', 'C'};
+	g.insert_edge('A', 'B', 1);
+	g.insert_edge('A', 'B', 2);
+	g.insert_edge('B', 'B', 3);
+	g.insert_edge('C', 'A', 4);
+
+	SECTION("Check counts after insertion") {
+		auto const g2 = g;
+		CHECK(g2.num_nodes() == 3);
+		CHECK(g2.num_edges() == 4);
+	}
+
+	SECTION("Check counts are kept up to date by every modifier") {
+		CHECK_FALSE(g.insert_edge('A', 'B', 1));
+		CHECK(g.num_edges() == 4);
+		REQUIRE(g.erase_edge('A', 'B', 2));
+		CHECK(g.num_edges() == 3);
+		REQUIRE(g.replace_node('B', 'D'));
+		CHECK(g.num_nodes() == 3);
+		CHECK(g.num_edges() == 3);
+		g.insert_edge('A', 'A', 1);
+		g.merge_replace_node('D', 'A'); // A -> D | 1 becomes a duplicate of A -> A | 1
+		CHECK(g.num_nodes() == 2);
+		CHECK(g.num_edges() == 3);
+		g.erase_edge(g.begin());
+		CHECK(g.num_edges() == 2);
+		REQUIRE(g.erase_node('A'));
+		CHECK(g.num_nodes() == 1);
+		CHECK(g.num_edges() == 0);
+		g.clear();
+		CHECK(g.num_nodes() == 0);
+	}
+
+	SECTION("Check an empty graph has no nodes or edges") {
+		auto const empty = gdwg::graph<char, int>{};
+		CHECK(empty.num_nodes() == 0);
+		CHECK(empty.num_edges() == 0);
+	}
+}
+
+TEST_CASE("Test hash() does not depend on how a graph was built") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("b", "c", 2);
+	g.insert_edge("c", "c", 3);
+
+	SECTION("Check insertion order does not change the hash") {
+		auto g2 = gdwg::graph<std::string, int>{"c", "b", "a"};
+		g2.insert_edge("c", "c", 3);
+		g2.insert_edge("b", "c", 2);
+		g2.insert_edge("a", "b", 1);
+		CHECK(g.hash() == g2.hash());
+	}
+
+	SECTION("Check different graphs have different hashes") {
+		auto reversed = gdwg::graph<std::string, int>{"a", "b", "c"};
+		reversed.insert_edge("b", "a", 1);
+		reversed.insert_edge("b", "c", 2);
+		reversed.insert_edge("c", "c", 3);
+		CHECK_FALSE(g.hash() == reversed.hash());
+		CHECK_FALSE(g.hash() == gdwg::graph<std::string, int>{}.hash());
+	}
+
+	SECTION("Check undone modifications restore the hash") {
+		auto const before = g.hash();
+		REQUIRE(g.insert_edge("a", "c", 9));
+		CHECK_FALSE(g.hash() == before);
+		REQUIRE(g.erase_edge("a", "c", 9));
+		CHECK(g.hash() == before);
+		REQUIRE(g.replace_node("c", "z"));
+		CHECK_FALSE(g.hash() == before);
+		REQUIRE(g.replace_node("z", "c"));
+		CHECK(g.hash() == before);
+	}
+
+	SECTION("Check merged and erased graphs hash like graphs built directly") {
+		g.merge_replace_node("b", "a");
+		auto expected = gdwg::graph<std::string, int>{"a", "c"};
+		expected.insert_edge("a", "a", 1);
+		expected.insert_edge("a", "c", 2);
+		expected.insert_edge("c", "c", 3);
+		CHECK(g.hash() == expected.hash());
+
+		REQUIRE(g.erase_node("c"));
+		auto expected2 = gdwg::graph<std::string, int>{"a"};
+		expected2.insert_edge("a", "a", 1);
+		CHECK(g.hash() == expected2.hash());
+	}
+}
+
 TEST_CASE("Test is_connected() identifies connected nodes in graph") {
 	auto g = gdwg::graph<char, int>{'A', 'B', 'C', 'D'};
 	g.insert_edge('A', 'B', 3);
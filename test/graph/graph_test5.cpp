@@ -48,6 +48,17 @@ TEST_CASE("Test operator== and operator!= comparisons work for graphs") {
 		CHECK(g == g2);
 		CHECK_FALSE(g != g2);
 	}
+
+	SECTION("Check for graphs of different sizes") {
+		auto g = gdwg::graph<int, std::string>{1, 2, 3};
+		auto g2 = gdwg::graph<int, std::string>{1, 2};
+		CHECK_FALSE(g == g2);
+		CHECK_FALSE(g2 == g);
+		g2.insert_node(3);
+		g.insert_edge(1, 2, "extra");
+		CHECK_FALSE(g == g2);
+		CHECK_FALSE(g2 == g);
+	}
 }
 
 TEST_CASE("Test extractor prints correct output") {
@@ -0,0 +1,157 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+#include "gdwg/triangles.hpp"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Snapshots and Triangle Counting
+
+TEST_CASE("Test snapshot stores nodes and edges contiguously") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "c", 2);
+	g.insert_edge("a", "b", 5);
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("c", "a", 7);
+
+	SECTION("Check ids follow the order of the nodes") {
+		auto const s = gdwg::snapshot(g);
+		REQUIRE(s.num_nodes() == 4);
+		CHECK(s.node(0) == "a");
+		CHECK(s.node(3) == "d");
+		CHECK(s.id("c") == 2u);
+		CHECK_FALSE(s.id("e").has_value());
+	}
+
+	SECTION("Check neighbour lists keep the (destination, weight) order") {
+		auto const s = gdwg::snapshot(g);
+		CHECK(s.num_edges() == 4);
+		auto const targets = s.neighbours(0);
+		auto const weights = s.weights(0);
+		CHECK(std::vector<std::uint32_t>(targets.begin(), targets.end()) == std::vector<std::uint32_t>{1, 1, 2});
+		CHECK(std::vector<int>(weights.begin(), weights.end()) == std::vector<int>{1, 5, 2});
+		CHECK(s.out_degree(1) == 0);
+		CHECK(s.out_degree(2) == 1);
+	}
+
+	SECTION("Check an empty graph gives an empty snapshot") {
+		auto const s = gdwg::snapshot(gdwg::graph<int, int>{});
+		CHECK(s.num_nodes() == 0);
+		CHECK(s.num_edges() == 0);
+		CHECK(s.offsets().size() == 1);
+	}
+}
+
+TEST_CASE("Test sorted intersection kernels agree with the scalar kernel") {
+	namespace simd = gdwg::detail::simd;
+	auto rng = std::mt19937(6771);
+	auto random_set = [&](std::size_t size, std::uint32_t range) {
+		auto dist = std::uniform_int_distribution<std::uint32_t>(0, range);
+		auto values = std::set<std::uint32_t>();
+		while (values.size() < size) {
+			values.insert(dist(rng));
+		}
+		return std::vector<std::uint32_t>(values.begin(), values.end());
+	};
+
+	for (auto const level : {simd::isa::sse2, simd::isa::avx2}) {
+		if (not simd::is_supported(level)) {
+			continue;
+		}
+		for (auto trial = 0; trial < 200; ++trial) {
+			auto const a = random_set(static_cast<std::size_t>(trial % 37), 64);
+			auto const b = random_set(static_cast<std::size_t>(trial % 53), 64);
+			CHECK(simd::intersect_count(a.data(), a.size(), b.data(), b.size(), level)
+			      == simd::intersect_count_scalar(a.data(), a.size(), b.data(), b.size()));
+		}
+	}
+}
+
+TEST_CASE("Test triangle_count() counts each undirected triangle once") {
+	SECTION("Check graphs without triangles count zero") {
+		auto g = gdwg::graph<int, int>{1, 2, 3};
+		CHECK(gdwg::triangle_count(g) == 0);
+		g.insert_edge(1, 2, 1);
+		g.insert_edge(2, 3, 1);
+		CHECK(gdwg::triangle_count(g) == 0);
+	}
+
+	SECTION("Check direction, parallel edges and reflexive edges are ignored") {
+		auto g = gdwg::graph<int, int>{1, 2, 3};
+		g.insert_edge(1, 2, 1);
+		g.insert_edge(2, 3, 1);
+		g.insert_edge(1, 3, 1);
+		CHECK(gdwg::triangle_count(g) == 1);
+		g.insert_edge(2, 1, 1);
+		g.insert_edge(1, 2, 2);
+		g.insert_edge(3, 3, 1);
+		CHECK(gdwg::triangle_count(g) == 1);
+	}
+
+	SECTION("Check a complete graph of five nodes has ten triangles") {
+		auto g = gdwg::graph<int, int>{1, 2, 3, 4, 5};
+		for (auto from = 1; from <= 5; ++from) {
+			for (auto to = from + 1; to <= 5; ++to) {
+				g.insert_edge(from, to, from * to);
+			}
+		}
+		CHECK(gdwg::triangle_count(g, 1) == 10);
+		CHECK(gdwg::triangle_count(g, 4) == 10);
+	}
+
+	SECTION("Check counts match a brute force count on a random graph") {
+		auto constexpr n = 120;
+		auto g = gdwg::graph<int, int>();
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		auto rng = std::mt19937(42);
+		auto dist = std::uniform_int_distribution<int>(0, n - 1);
+		for (auto i = 0; i < 1500; ++i) {
+			g.insert_edge(dist(rng), dist(rng), 1);
+		}
+
+		auto linked = [&](int u, int v) { return g.is_connected(u, v) or g.is_connected(v, u); };
+		auto expected = std::uint64_t{0};
+		for (auto u = 0; u < n; ++u) {
+			for (auto v = u + 1; v < n; ++v) {
+				if (not linked(u, v)) {
+					continue;
+				}
+				for (auto w = v + 1; w < n; ++w) {
+					if (linked(u, w) and linked(v, w)) {
+						++expected;
+					}
+				}
+			}
+		}
+		CHECK(gdwg::triangle_count(g, 3) == expected);
+	}
+}
+
+TEST_CASE("Test local_clustering() computes the coefficient of every node") {
+	auto g = gdwg::graph<char, int>{'A', 'B', 'C', 'D', 'E'};
+	g.insert_edge('A', 'B', 1);
+	g.insert_edge('B', 'C', 1);
+	g.insert_edge('C', 'A', 1);
+	g.insert_edge('A', 'D', 1);
+
+	SECTION("Check coefficients are indexed in node order") {
+		auto const c = gdwg::local_clustering(g);
+		REQUIRE(c.size() == 5);
+		CHECK(c[0] == Approx(1.0 / 3.0));
+		CHECK(c[1] == Approx(1.0));
+		CHECK(c[2] == Approx(1.0));
+		CHECK(c[3] == 0.0);
+		CHECK(c[4] == 0.0);
+	}
+
+	SECTION("Check an empty graph has no coefficients") {
+		CHECK(gdwg::local_clustering(gdwg::graph<char, int>{}).empty());
+	}
+}
@@ -0,0 +1,109 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+#include "gdwg/weights.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Weight Filters and Reductions
+
+TEST_CASE("Test SIMD reduction kernels agree with sequential reductions") {
+	namespace simd = gdwg::detail::simd;
+	auto rng = std::mt19937(6771);
+	auto dist = std::uniform_int_distribution<int>(-1000, 1000);
+
+	for (auto const level : {simd::isa::scalar, simd::isa::avx2}) {
+		if (not simd::is_supported(level)) {
+			continue;
+		}
+		for (auto n = std::size_t{1}; n < 80; n += 7) {
+			auto ints = std::vector<std::int32_t>(n);
+			auto doubles = std::vector<double>(n);
+			for (auto i = std::size_t{0}; i < n; ++i) {
+				ints[i] = dist(rng);
+				doubles[i] = static_cast<double>(ints[i]) / 4.0; // Exactly representable sums
+			}
+
+			CHECK(simd::reduce_sum(ints.data(), n, level) == std::accumulate(ints.begin(), ints.end(), 0));
+			CHECK(simd::reduce_sum(doubles.data(), n, level)
+			      == std::accumulate(doubles.begin(), doubles.end(), 0.0));
+			CHECK(simd::reduce_extreme(ints.data(), n, std::less<>{}, level)
+			      == *std::min_element(ints.begin(), ints.end()));
+			CHECK(simd::reduce_extreme(doubles.data(), n, std::greater<>{}, level)
+			      == *std::max_element(doubles.begin(), doubles.end()));
+		}
+	}
+}
+
+TEST_CASE("Test filter_edges() selects edges by weight") {
+	auto g = gdwg::graph<std::string, double>{"a", "b", "c"};
+	g.insert_edge("a", "b", 0.5);
+	g.insert_edge("a", "b", 2.5);
+	g.insert_edge("b", "c", 3.0);
+	g.insert_edge("c", "a", -1.0);
+
+	SECTION("Check matching edges are returned in iteration order") {
+		auto const heavy = gdwg::filter_edges(g, [](double w) { return w > 1.0; });
+		REQUIRE(heavy.size() == 2);
+		CHECK(heavy[0].from == "a");
+		CHECK(heavy[0].to == "b");
+		CHECK(heavy[0].weight == 2.5);
+		CHECK(heavy[1].from == "b");
+		CHECK(heavy[1].to == "c");
+	}
+
+	SECTION("Check no edges are returned when nothing matches") {
+		CHECK(gdwg::filter_edges(g, [](double w) { return w > 10.0; }).empty());
+		CHECK(gdwg::filter_edges(gdwg::graph<int, int>{1, 2}, [](int) { return true; }).empty());
+	}
+}
+
+TEST_CASE("Test per-node weight reductions") {
+	auto g = gdwg::graph<char, int>{'A', 'B', 'C', 'D'};
+	g.insert_edge('A', 'B', 4);
+	g.insert_edge('A', 'B', 9);
+	g.insert_edge('A', 'C', -2);
+	g.insert_edge('B', 'C', 7);
+	g.insert_edge('C', 'C', 1);
+
+	SECTION("Check outgoing sums") {
+		CHECK(gdwg::out_weight_sum(g) == std::vector<int>{11, 7, 1, 0});
+	}
+
+	SECTION("Check outgoing minimum and maximum") {
+		auto const s = gdwg::snapshot(g);
+		CHECK(gdwg::out_weight_min(s) == std::vector<std::optional<int>>{-2, 7, 1, std::nullopt});
+		CHECK(gdwg::out_weight_max(s) == std::vector<std::optional<int>>{9, 7, 1, std::nullopt});
+	}
+
+	SECTION("Check incoming reductions") {
+		auto const s = gdwg::snapshot(g);
+		CHECK(gdwg::in_weight_sum(s) == std::vector<int>{0, 13, 6, 0});
+		CHECK(gdwg::in_weight_min(s) == std::vector<std::optional<int>>{std::nullopt, 4, -2, std::nullopt});
+		CHECK(gdwg::in_weight_max(g) == std::vector<std::optional<int>>{std::nullopt, 9, 7, std::nullopt});
+	}
+
+	SECTION("Check whole-graph reductions") {
+		auto const s = gdwg::snapshot(g);
+		CHECK(gdwg::weight_sum(s) == 19);
+		CHECK(gdwg::weight_min(s) == -2);
+		CHECK(gdwg::weight_max(s) == 9);
+		CHECK_FALSE(gdwg::weight_min(gdwg::snapshot(gdwg::graph<char, int>{'A'})).has_value());
+	}
+
+	SECTION("Check reductions of non-arithmetic weights") {
+		auto words = gdwg::graph<int, std::string>{1, 2};
+		words.insert_edge(1, 2, "b");
+		words.insert_edge(1, 2, "a");
+		CHECK(gdwg::out_weight_sum(words) == std::vector<std::string>{"ab", ""});
+		CHECK(gdwg::out_weight_max(words)[0] == "b");
+	}
+}
@@ -0,0 +1,115 @@
+#include "gdwg/graph.hpp"
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Subgraph Extraction
+
+namespace helper {
+	template<typename N, typename E>
+	auto check_output_is_expected(gdwg::graph<N, E> const& g, std::string_view const& expected_output)
+	   -> void {
+		auto out = std::ostringstream{};
+		out << g;
+		CHECK(out.str() == expected_output);
+	}
+} // namespace helper
+
+using namespace helper;
+
+TEST_CASE("Test induced_subgraph() keeps the selected nodes and the edges between them") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("a", "b", 2);
+	g.insert_edge("a", "c", 3);
+	g.insert_edge("b", "a", 4);
+	g.insert_edge("c", "c", 5);
+	g.insert_edge("d", "a", 6);
+
+	SECTION("Check edges leaving the selection are dropped") {
+		auto const sub = g.induced_subgraph(std::vector<std::string>{"b", "a", "a"});
+		CHECK(sub.num_nodes() == 2);
+		CHECK(sub.num_edges() == 3);
+		check_output_is_expected(sub,
+		                         std::string_view(
+		                            R"(a (
+  b | 1
+  b | 2
+)
+b (
+  a | 4
+)
+)"));
+	}
+
+	SECTION("Check the result equals a graph built by insertion") {
+		auto const sub = g.induced_subgraph(std::vector<std::string>{"c", "d", "a"}, 4);
+		auto expected = gdwg::graph<std::string, int>{"a", "c", "d"};
+		expected.insert_edge("a", "c", 3);
+		expected.insert_edge("c", "c", 5);
+		expected.insert_edge("d", "a", 6);
+		CHECK(sub == expected);
+		CHECK(sub.hash() == expected.hash());
+	}
+
+	SECTION("Check the result is independent of the original graph") {
+		auto sub = g.induced_subgraph(std::vector<std::string>{"a", "b"});
+		REQUIRE(g.erase_node("b"));
+		REQUIRE(sub.replace_node("a", "z"));
+		CHECK(sub.is_connected("z", "b"));
+		CHECK(g.is_node("a"));
+	}
+
+	SECTION("Check an empty selection gives an empty graph") {
+		CHECK(g.induced_subgraph(std::vector<std::string>{}).empty());
+	}
+
+	SECTION("Check exception is thrown if a node does not exist") {
+		REQUIRE_THROWS_MATCHES(g.induced_subgraph(std::vector<std::string>{"a", "e"}),
+		                       std::runtime_error,
+		                       Catch::Message("Cannot call gdwg::graph<N, E>::induced_subgraph on "
+		                                      "nodes that don't exist in the graph"));
+	}
+}
+
+TEST_CASE("Test filter() keeps every node and the matching edges") {
+	auto g = gdwg::graph<int, int>{1, 2, 3};
+	g.insert_edge(1, 2, 10);
+	g.insert_edge(1, 3, -5);
+	g.insert_edge(2, 2, 7);
+	g.insert_edge(3, 1, 20);
+
+	SECTION("Check edges are filtered by weight") {
+		auto const heavy = g.filter([](int, int, int weight) { return weight > 8; });
+		CHECK(heavy.num_nodes() == 3);
+		check_output_is_expected(heavy,
+		                         std::string_view(
+		                            R"(1 (
+  2 | 10
+)
+2 (
+)
+3 (
+  1 | 20
+)
+)"));
+	}
+
+	SECTION("Check the predicate sees the source and destination") {
+		auto const reflexive = g.filter([](int from, int to, int) { return from == to; }, 2);
+		auto expected = gdwg::graph<int, int>{1, 2, 3};
+		expected.insert_edge(2, 2, 7);
+		CHECK(reflexive == expected);
+		CHECK(reflexive.hash() == expected.hash());
+	}
+
+	SECTION("Check keeping every edge gives an equal graph") {
+		auto const all = g.filter([](int, int, int) { return true; }, 0);
+		CHECK(all == g);
+		CHECK(all.num_edges() == 4);
+	}
+}
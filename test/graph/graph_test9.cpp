@@ -0,0 +1,74 @@
+#include "gdwg/graph.hpp"
+#include "gdwg/snapshot.hpp"
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+// Rationale: test/README.md
+
+// Transpose
+
+TEST_CASE("Test transpose() reverses every edge of a graph") {
+	auto g = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+	g.insert_edge("a", "b", 2);
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("c", "b", 3);
+	g.insert_edge("b", "a", 4);
+	g.insert_edge("d", "d", 5);
+
+	SECTION("Check the result equals a graph built by reversed insertion") {
+		auto expected = gdwg::graph<std::string, int>{"a", "b", "c", "d"};
+		for (auto const& [from, to, weight] : g) {
+			expected.insert_edge(to, from, weight);
+		}
+		auto const t = gdwg::transpose(g);
+		CHECK(t == expected);
+		CHECK(t.num_edges() == 5);
+		CHECK(t.hash() == expected.hash());
+		CHECK(t.weights("b", "a") == std::vector<int>{1, 2});
+	}
+
+	SECTION("Check transposing twice gives the original graph") {
+		CHECK(gdwg::transpose(gdwg::transpose(g, 1), 3) == g);
+	}
+
+	SECTION("Check graphs without edges keep their nodes") {
+		auto const nodes_only = gdwg::graph<int, int>{3, 1, 2};
+		CHECK(gdwg::transpose(nodes_only) == nodes_only);
+		CHECK(gdwg::transpose(gdwg::graph<int, int>{}).empty());
+	}
+}
+
+TEST_CASE("Test transpose() of a snapshot lists incoming edges") {
+	auto g = gdwg::graph<int, int>{};
+	for (auto i = 0; i < 50; ++i) {
+		g.insert_node(i);
+	}
+	auto rng = std::mt19937(30);
+	auto dist = std::uniform_int_distribution<int>(0, 49);
+	for (auto i = 0; i < 400; ++i) {
+		g.insert_edge(dist(rng), dist(rng), dist(rng));
+	}
+
+	SECTION("Check the result matches a snapshot of the transposed graph") {
+		auto const expected = gdwg::snapshot(gdwg::transpose(g));
+		for (auto const threads : {std::size_t{1}, std::size_t{4}}) {
+			auto const t = gdwg::transpose(gdwg::snapshot(g), threads);
+			REQUIRE(t.num_nodes() == expected.num_nodes());
+			CHECK(std::vector(t.offsets().begin(), t.offsets().end())
+			      == std::vector(expected.offsets().begin(), expected.offsets().end()));
+			CHECK(std::vector(t.targets().begin(), t.targets().end())
+			      == std::vector(expected.targets().begin(), expected.targets().end()));
+			CHECK(std::vector(t.weights().begin(), t.weights().end())
+			      == std::vector(expected.weights().begin(), expected.weights().end()));
+		}
+	}
+
+	SECTION("Check an empty snapshot transposes to an empty snapshot") {
+		auto const t = gdwg::transpose(gdwg::snapshot(gdwg::graph<int, int>{}));
+		CHECK(t.num_nodes() == 0);
+		CHECK(t.offsets().size() == 1);
+	}
+}
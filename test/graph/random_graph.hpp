@@ -0,0 +1,50 @@
+#ifndef GDWG_TEST_RANDOM_GRAPH_HPP
+#define GDWG_TEST_RANDOM_GRAPH_HPP
+
+#include "gdwg/graph.hpp"
+
+#include <algorithm>
+#include <random>
+
+// Shared by the test files that compare an algorithm against a reference on random graphs
+
+namespace helper {
+	// Graph on the nodes 0, stride, 2 * stride, ... with edges between uniformly picked nodes.
+	// Self-loops and parallel edges are kept, and each weight is drawn by calling weight(rng).
+	template<typename Weight>
+	auto random_graph(std::mt19937& rng, int nodes, int edges, Weight weight, int stride = 1)
+	   -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>();
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i * stride);
+		}
+		auto pick = std::uniform_int_distribution<int>(0, nodes - 1);
+		for (auto i = 0; i < edges; ++i) {
+			auto const src = pick(rng) * stride;
+			auto const dst = pick(rng) * stride;
+			g.insert_edge(src, dst, weight(rng));
+		}
+		return g;
+	}
+
+	// As random_graph(), on the nodes 0, 1, 2, ... with edges only from lower to higher nodes, so
+	// the graph is acyclic even with negative weights. Self-loops are dropped.
+	template<typename Weight>
+	auto random_dag(std::mt19937& rng, int nodes, int edges, Weight weight) -> gdwg::graph<int, int> {
+		auto g = gdwg::graph<int, int>();
+		for (auto i = 0; i < nodes; ++i) {
+			g.insert_node(i);
+		}
+		auto pick = std::uniform_int_distribution<int>(0, nodes - 1);
+		for (auto i = 0; i < edges; ++i) {
+			auto const a = pick(rng);
+			auto const b = pick(rng);
+			if (a != b) {
+				g.insert_edge(std::min(a, b), std::max(a, b), weight(rng));
+			}
+		}
+		return g;
+	}
+} // namespace helper
+
+#endif // GDWG_TEST_RANDOM_GRAPH_HPP
@@ -0,0 +1,37 @@
+#ifndef GDWG_TEST_SCRATCH_DIRECTORY_HPP
+#define GDWG_TEST_SCRATCH_DIRECTORY_HPP
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+// Shared by the test files that write graphs to disk
+
+namespace helper {
+	// A fresh directory named prefix-name in the temporary directory, deleted again at the end of
+	// the test. Each test file uses its own prefix, so tests running in parallel don't collide.
+	class scratch_directory {
+	public:
+		scratch_directory(std::string const& prefix, std::string const& name)
+		: path_(std::filesystem::temp_directory_path() / (prefix + "-" + name)) {
+			std::filesystem::remove_all(path_);
+		}
+
+		scratch_directory(scratch_directory const&) = delete;
+		auto operator=(scratch_directory const&) -> scratch_directory& = delete;
+
+		~scratch_directory() {
+			auto error = std::error_code();
+			std::filesystem::remove_all(path_, error);
+		}
+
+		[[nodiscard]] auto path() const -> std::filesystem::path const& {
+			return path_;
+		}
+
+	private:
+		std::filesystem::path path_;
+	};
+} // namespace helper
+
+#endif // GDWG_TEST_SCRATCH_DIRECTORY_HPP